@@ -1,19 +1,78 @@
 #include <cli/Parser.hpp>
 
+#include <diophantus/FixedWidthStatistics.hpp>
+#include <diophantus/ModularSolver.hpp>
 #include <diophantus/Solver.hpp>
+#include <diophantus/SolvingEngine.hpp>
 #include <diophantus/Validator.hpp>
 #include <diophantus/model/Solution.hpp>
 #include <diophantus/model/numeric/GmpBigInt.hpp>
 #include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/RowPolicy.hpp>
+#include <diophantus/model/ThreadPool.hpp>
+#include <diophantus/model/VariableOrdering.hpp>
 
 #include <logging.hpp>
 
 #include <argparse/argparse.hpp>
 
+#include <memory>
 #include <optional>
 #include <iostream>
 #include <exception>
+#include <stdexcept>
 #include <string>
+#include <utility>
+
+diophantus::model::RowLayout parseRowLayout(const std::string& name)
+{
+    using diophantus::model::RowLayout;
+    if (name == "sparse")
+    {
+        return RowLayout::Sparse;
+    }
+    if (name == "dense")
+    {
+        return RowLayout::Dense;
+    }
+    if (name == "adaptive")
+    {
+        return RowLayout::Adaptive;
+    }
+    throw std::invalid_argument("Invalid row layout: " + name);
+}
+
+std::optional<diophantus::model::VariableOrdering> parseVariableOrdering(const std::string& name)
+{
+    using diophantus::model::VariableOrdering;
+    if (name == "none")
+    {
+        return std::nullopt;
+    }
+    if (name == "compact")
+    {
+        return VariableOrdering::Compact;
+    }
+    if (name == "rcm")
+    {
+        return VariableOrdering::ReverseCuthillMcKee;
+    }
+    throw std::invalid_argument("Invalid variable ordering: " + name);
+}
+
+diophantus::SolvingEngine parseSolvingEngine(const std::string& name)
+{
+    using diophantus::SolvingEngine;
+    if (name == "elimination")
+    {
+        return SolvingEngine::Elimination;
+    }
+    if (name == "hnf")
+    {
+        return SolvingEngine::HermiteNormalForm;
+    }
+    throw std::invalid_argument("Invalid solving engine: " + name);
+}
 
 argparse::ArgumentParser parseArguments(int argc, char *argv[])
 {
@@ -37,10 +96,50 @@ argparse::ArgumentParser parseArguments(int argc, char *argv[])
         .help("show progress of the algorithm while solving")
         .default_value(false)
         .implicit_value(true);
+
+    program.add_argument("--arena")
+        .help("serve GMP allocations from an arena while solving")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--row-arena")
+        .help("keep the rows of the equation system packed in an arena while solving")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--rows")
+        .help("layout of the rows of the equation system: sparse, dense or adaptive")
+        .default_value(std::string("sparse"));
+
+    program.add_argument("--renumber")
+        .help("renumber the live variables densely while solving: none, compact or rcm")
+        .default_value(std::string("none"));
+
+    program.add_argument("--engine")
+        .help("algorithm to solve with: elimination or hnf (Hermite normal form)")
+        .default_value(std::string("elimination"));
+
+    program.add_argument("--modular")
+        .help("solve modulo word-sized primes first, fall back to elimination if the result cannot be lifted")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--fixed-width")
+        .help("solve with 64 bit arithmetic first, fall back to arbitrary precision on overflow")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--threads")
+        .help("number of threads for the row arithmetic of large equation systems (0 for all cores)")
+        .scan<'i', unsigned int>()
+        .default_value(1u);
     
     try
     {
         program.parse_args(argc, argv);
+        parseRowLayout(program.get<std::string>("--rows"));
+        parseVariableOrdering(program.get<std::string>("--renumber"));
+        parseSolvingEngine(program.get<std::string>("--engine"));
         setLoggingLevel(program.get<unsigned int>("--verbosity"));
     }
     catch (const std::exception& err)
@@ -59,6 +158,7 @@ int main(int argc, char *argv[])
     using NumT = diophantus::model::numeric::GmpBigInt;
     using EquationSystem = diophantus::model::EquationSystem<NumT>;
     using Solver = diophantus::Solver<NumT>;
+    using ModularSolver = diophantus::ModularSolver<NumT>;
     using Solution = diophantus::model::Solution<NumT>;
     using Validator = diophantus::Validator<NumT>;
 
@@ -75,12 +175,47 @@ int main(int argc, char *argv[])
     }
     
     // Solve equation system and output the result
-    Solver solver(equationSystem.value(), Solver::Parameters{
-        .doShowProgress = args.get<bool>("--progress")
-    });
+    Solver::Parameters solverParameters {
+        .doShowProgress = args.get<bool>("--progress"),
+        .doUseFixedWidthArithmetic = args.get<bool>("--fixed-width"),
+        .doUseGmpArena = args.get<bool>("--arena"),
+        .doUseRowArena = args.get<bool>("--row-arena"),
+        .rowPolicy = {.layout = parseRowLayout(args.get<std::string>("--rows"))},
+        .variableRenumbering = parseVariableOrdering(args.get<std::string>("--renumber")),
+        .engine = parseSolvingEngine(args.get<std::string>("--engine"))
+    };
+    unsigned int nThreads = args.get<unsigned int>("--threads");
+    if (nThreads != 1)
+    {
+        solverParameters.threadPool = std::make_shared<diophantus::model::ThreadPool>(nThreads);
+    }
+
+    // The solver takes over the parsed equation system, unless it is still needed to validate
+    // the solution
+    bool doValidation = args.get<bool>("--validate");
+    std::optional<Validator> validator;
+    if (doValidation)
+    {
+        validator.emplace(equationSystem.value());
+    }
 
     LOG_INFO << "Solving equation system.";
-    std::optional<Solution> solution = solver.solve();
+    std::optional<Solution> solution;
+    if (args.get<bool>("--modular"))
+    {
+        ModularSolver solver(std::move(equationSystem.value()), {.fallbackParameters = solverParameters});
+        solution = solver.solve();
+    }
+    else
+    {
+        Solver solver(std::move(equationSystem.value()), solverParameters);
+        solution = solver.solve();
+    }
+    equationSystem.reset();
+    if (args.get<bool>("--fixed-width"))
+    {
+        LOG_INFO << "Statistics: " << diophantus::FixedWidthStatistics::get();
+    }
     if (solution.has_value())
     {
         LOG_INFO << "Solution found:";
@@ -89,12 +224,10 @@ int main(int argc, char *argv[])
             LOG_INFO << x;
         }
 
-        bool doValidation = args.get<bool>("--validate");
         if (doValidation)
         {
             LOG_INFO << "Checking solution:";
-            Validator validator(equationSystem.value());
-            if (validator.isValidSolution(solution.value()))
+            if (validator->isValidSolution(solution.value()))
             {
                 LOG_INFO << "Solution validated.";
             }
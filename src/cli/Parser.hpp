@@ -78,6 +78,7 @@ namespace cli
                 size_t nVariables = header[1];
 
                 variables = diophantus::model::make_variables(nVariables);
+                equations.reserve(nEquations);
 
                 size_t nAddedEquations = 0;
                 for (std::string line; std::getline(file, line); )
@@ -126,8 +127,7 @@ namespace cli
                     }
 
                     diophantus::model::Sum<NumT> sum{terms};
-                    diophantus::model::Equation<NumT> equation{sum, rightSide};
-                    equations.push_back(equation);
+                    equations.emplace_back(std::move(sum), std::move(rightSide));
                 }
 
                 if (nAddedEquations != nEquations)
@@ -146,7 +146,7 @@ namespace cli
                 return std::nullopt;
             }
 
-            return diophantus::model::EquationSystem<NumT>(variables, equations);
+            return diophantus::model::EquationSystem<NumT>(std::move(variables), std::move(equations));
         }
     };
 }
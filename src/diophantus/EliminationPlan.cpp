@@ -0,0 +1,401 @@
+#include "EliminationPlan.hpp"
+
+#include "diophantus/model/numeric/GmpBigInt.hpp"
+#include "diophantus/model/numeric/HybridBigInt.hpp"
+#include "diophantus/model/numeric/CheckedInt64.hpp"
+#include "diophantus/model/numeric/FixedInt.hpp"
+#include "model/conversion.hpp"
+#include "model/Assignment.hpp"
+#include "model/ConstantTrace.hpp"
+#include "model/Solution.hpp"
+
+#include <common/logging.hpp>
+
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace diophantus
+{
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    EliminationPlan<NumT, VarT>::EliminationPlan(const model::ConstantTrace<NumT>& trace,
+                                                 const std::vector<std::pair<VarT, size_t>>& solutionRegisters)
+    {
+        using Opcode = typename model::ConstantTrace<NumT>::Opcode;
+
+        std::vector<OperationRecord> operations;
+        operations.reserve(trace.getOperations().size());
+        std::vector<uint64_t> limbs;
+        mpz_class factor;
+        for (const auto& operation : trace.getOperations())
+        {
+            OperationRecord& record = operations.emplace_back(OperationRecord {
+                .opcode = static_cast<uint32_t>(operation.opcode),
+                .factorSize = 0,
+                .target = operation.target,
+                .source = operation.source,
+                .factor = 0
+            });
+
+            factor = model::convertNumber<model::numeric::GmpBigInt>(operation.factor).get();
+            if (mpz_fits_slong_p(factor.get_mpz_t()))
+            {
+                record.factor = mpz_get_si(factor.get_mpz_t());
+                continue;
+            }
+
+            // Store the absolute value in 64 bit limbs, least significant first
+            const size_t offset = limbs.size();
+            limbs.resize(offset + (mpz_sizeinbase(factor.get_mpz_t(), 2) + 63) / 64);
+            size_t nLimbs = 0;
+            mpz_export(limbs.data() + offset, &nLimbs, -1, sizeof(uint64_t), 0, 0, factor.get_mpz_t());
+            limbs.resize(offset + nLimbs);
+
+            record.factorSize = sgn(factor) * static_cast<int32_t>(nLimbs);
+            record.factor = static_cast<int64_t>(offset);
+        }
+        static_assert(static_cast<uint32_t>(Opcode::RequireOpposite) == 8);
+
+        std::vector<SolutionRecord> solution;
+        solution.reserve(solutionRegisters.size());
+        for (const auto& [variable, constantRegister] : solutionRegisters)
+        {
+            solution.push_back(SolutionRecord{variable, constantRegister});
+        }
+
+        Header planHeader {
+            .magic = {},
+            .version = version,
+            .byteOrderMark = byteOrderMark,
+            .variableIdSize = sizeof(VarT),
+            .reserved = 0,
+            .nRightSides = trace.getRightSideCount(),
+            .nRegisters = trace.getRegisterCount(),
+            .nOperations = operations.size(),
+            .nSolutionEntries = solution.size(),
+            .nFactorLimbs = limbs.size()
+        };
+        std::memcpy(planHeader.magic, magic, sizeof(magic));
+
+        auto append = [this](const void* data, size_t size) {
+            const std::byte* bytes = static_cast<const std::byte*>(data);
+            ownedImage.insert(ownedImage.end(), bytes, bytes + size);
+        };
+        ownedImage.reserve(sizeof(Header) + operations.size() * sizeof(OperationRecord)
+                           + solution.size() * sizeof(SolutionRecord) + limbs.size() * sizeof(uint64_t));
+        append(&planHeader, sizeof(Header));
+        append(operations.data(), operations.size() * sizeof(OperationRecord));
+        append(solution.data(), solution.size() * sizeof(SolutionRecord));
+        append(limbs.data(), limbs.size() * sizeof(uint64_t));
+
+        image = ownedImage;
+        header = planHeader;
+        decodeFactors();
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    EliminationPlan<NumT, VarT>::EliminationPlan(MappedFile file) :
+        mappedFile(std::move(file)),
+        image(mappedFile->getData()),
+        header(readRecord<Header>(image, 0))
+    {
+        decodeFactors();
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<EliminationPlan<NumT, VarT>> EliminationPlan<NumT, VarT>::load(const std::filesystem::path& path)
+    {
+        try
+        {
+            MappedFile file(path);
+            if (!isValidImage(file.getData()))
+            {
+                LOG_ERROR << "Invalid elimination plan: " << path;
+                return std::nullopt;
+            }
+            return EliminationPlan(std::move(file));
+        }
+        catch (const std::system_error& e)
+        {
+            LOG_ERROR << "Error reading file: " << path;
+            LOG_ERROR << e.what();
+            return std::nullopt;
+        }
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool EliminationPlan<NumT, VarT>::save(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        file.close();
+        if (!file)
+        {
+            LOG_ERROR << "Error writing file: " << path;
+            return false;
+        }
+        return true;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<model::Solution<NumT, VarT>> EliminationPlan<NumT, VarT>::solve(
+        const std::vector<NumT>& rightSide) const
+    {
+        using Opcode = typename model::ConstantTrace<NumT>::Opcode;
+
+        if (rightSide.size() != header.nRightSides)
+        {
+            throw std::invalid_argument("expected " + std::to_string(header.nRightSides) + " right sides, got "
+                                        + std::to_string(rightSide.size()));
+        }
+
+        std::vector<NumT> registers;
+        registers.reserve(header.nRegisters);
+        registers.insert(registers.end(), rightSide.begin(), rightSide.end());
+        registers.resize(header.nRegisters, NumT(0));
+
+        for (size_t index = 0; index < header.nOperations; ++index)
+        {
+            const OperationRecord operation = getOperation(index);
+            const NumT& factor = factors[index];
+            NumT& target = registers[operation.target];
+            const NumT& source = registers[operation.source];
+
+            switch (static_cast<Opcode>(operation.opcode))
+            {
+                case Opcode::Negate:
+                    target.negate();
+                    break;
+
+                case Opcode::Copy:
+                    target = source;
+                    break;
+
+                case Opcode::CopyNegatedSymMod:
+                    target = -NumT::symMod(source, factor);
+                    break;
+
+                case Opcode::AddMultiple:
+                    target.addMul(factor, source);
+                    break;
+
+                case Opcode::SubtractMultiple:
+                    target.subMul(factor, source);
+                    break;
+
+                case Opcode::DivideExactly:
+                    if (!target.isDivisibleBy(factor))
+                    {
+                        return std::nullopt;
+                    }
+                    target.divExact(factor);
+                    break;
+
+                case Opcode::RequireZero:
+                    if (target != 0)
+                    {
+                        return std::nullopt;
+                    }
+                    break;
+
+                case Opcode::RequireEqual:
+                    if (target != source)
+                    {
+                        return std::nullopt;
+                    }
+                    break;
+
+                case Opcode::RequireOpposite:
+                    if (target != -source)
+                    {
+                        return std::nullopt;
+                    }
+                    break;
+            }
+        }
+
+        model::Solution<NumT, VarT> solution;
+        solution.assignments.reserve(header.nSolutionEntries);
+        for (size_t index = 0; index < header.nSolutionEntries; ++index)
+        {
+            const SolutionRecord entry = getSolutionEntry(index);
+            solution.assignments.push_back(model::Assignment<NumT, VarT> {
+                .variable = static_cast<VarT>(entry.variable),
+                .value = registers[entry.constantRegister]
+            });
+        }
+        return solution;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    size_t EliminationPlan<NumT, VarT>::getRightSideCount() const
+    {
+        return header.nRightSides;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    size_t EliminationPlan<NumT, VarT>::getOperationCount() const
+    {
+        return header.nOperations;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool EliminationPlan<NumT, VarT>::isValidImage(std::span<const std::byte> image)
+    {
+        using Opcode = typename model::ConstantTrace<NumT>::Opcode;
+
+        if (image.size() < sizeof(Header))
+        {
+            LOG_ERROR << "File is too short for a plan header";
+            return false;
+        }
+
+        const Header header = readRecord<Header>(image, 0);
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version)
+        {
+            LOG_ERROR << "File is no elimination plan of version " << version;
+            return false;
+        }
+        if (header.byteOrderMark != byteOrderMark)
+        {
+            LOG_ERROR << "Plan was written with a different byte order";
+            return false;
+        }
+        if (header.variableIdSize != sizeof(VarT))
+        {
+            LOG_ERROR << "Plan was written for " << header.variableIdSize * 8 << " bit variable ids, expected "
+                      << sizeof(VarT) * 8;
+            return false;
+        }
+
+        // Compare counts with the remaining size by division, so that corrupt counts can't
+        // overflow. Each product is only formed once its count is known to fit.
+        auto doesSizeMatch = [&header](size_t remaining) {
+            if (header.nOperations > remaining / sizeof(OperationRecord))
+            {
+                return false;
+            }
+            remaining -= header.nOperations * sizeof(OperationRecord);
+            if (header.nSolutionEntries > remaining / sizeof(SolutionRecord))
+            {
+                return false;
+            }
+            remaining -= header.nSolutionEntries * sizeof(SolutionRecord);
+            return remaining % sizeof(uint64_t) == 0 && header.nFactorLimbs == remaining / sizeof(uint64_t);
+        };
+        if (!doesSizeMatch(image.size() - sizeof(Header)))
+        {
+            LOG_ERROR << "Plan size does not match its header";
+            return false;
+        }
+        if (header.nRightSides >= header.nRegisters)
+        {
+            LOG_ERROR << "Plan has no zero register";
+            return false;
+        }
+
+        const size_t operationsOffset = sizeof(Header);
+        for (size_t index = 0; index < header.nOperations; ++index)
+        {
+            const auto operation = readRecord<OperationRecord>(image, operationsOffset + index * sizeof(OperationRecord));
+            const uint64_t nLimbs = operation.factorSize < 0 ? -int64_t(operation.factorSize) : operation.factorSize;
+            if (operation.opcode > static_cast<uint32_t>(Opcode::RequireOpposite)
+                || operation.target >= header.nRegisters || operation.source >= header.nRegisters
+                || (nLimbs != 0 && (operation.factor < 0 || uint64_t(operation.factor) > header.nFactorLimbs
+                                    || nLimbs > header.nFactorLimbs - uint64_t(operation.factor))))
+            {
+                LOG_ERROR << "Invalid operation " << index << " in plan";
+                return false;
+            }
+        }
+
+        const size_t solutionOffset = operationsOffset + header.nOperations * sizeof(OperationRecord);
+        for (size_t index = 0; index < header.nSolutionEntries; ++index)
+        {
+            const auto entry = readRecord<SolutionRecord>(image, solutionOffset + index * sizeof(SolutionRecord));
+            if (entry.constantRegister >= header.nRegisters || entry.variable > std::numeric_limits<VarT>::max())
+            {
+                LOG_ERROR << "Invalid solution entry " << index << " in plan";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void EliminationPlan<NumT, VarT>::decodeFactors()
+    {
+        const size_t limbsOffset = sizeof(Header) + header.nOperations * sizeof(OperationRecord)
+                                 + header.nSolutionEntries * sizeof(SolutionRecord);
+
+        factors.clear();
+        factors.reserve(header.nOperations);
+        mpz_class factor;
+        for (size_t index = 0; index < header.nOperations; ++index)
+        {
+            const OperationRecord operation = getOperation(index);
+            if (operation.factorSize == 0)
+            {
+                factors.emplace_back(static_cast<long>(operation.factor));
+                continue;
+            }
+
+            const size_t nLimbs = operation.factorSize < 0 ? -operation.factorSize : operation.factorSize;
+            mpz_import(factor.get_mpz_t(), nLimbs, -1, sizeof(uint64_t), 0, 0,
+                       image.data() + limbsOffset + operation.factor * sizeof(uint64_t));
+            if (operation.factorSize < 0)
+            {
+                factor = -factor;
+            }
+            factors.push_back(model::convertNumber<NumT>(model::numeric::GmpBigInt(factor)));
+        }
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    template <typename RecordT>
+    RecordT EliminationPlan<NumT, VarT>::readRecord(std::span<const std::byte> image, size_t offset)
+    {
+        // Copying avoids alignment and aliasing issues, the compiler turns it into plain loads
+        RecordT record;
+        std::memcpy(&record, image.data() + offset, sizeof(RecordT));
+        return record;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    typename EliminationPlan<NumT, VarT>::OperationRecord EliminationPlan<NumT, VarT>::getOperation(size_t index) const
+    {
+        return readRecord<OperationRecord>(image, sizeof(Header) + index * sizeof(OperationRecord));
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    typename EliminationPlan<NumT, VarT>::SolutionRecord EliminationPlan<NumT, VarT>::getSolutionEntry(size_t index) const
+    {
+        return readRecord<SolutionRecord>(image, sizeof(Header) + header.nOperations * sizeof(OperationRecord)
+                                                 + index * sizeof(SolutionRecord));
+    }
+
+    template class EliminationPlan<model::numeric::GmpBigInt, std::uint16_t>;
+    template class EliminationPlan<model::numeric::GmpBigInt, std::uint32_t>;
+    template class EliminationPlan<model::numeric::GmpBigInt, std::uint64_t>;
+    template class EliminationPlan<model::numeric::HybridBigInt, std::uint16_t>;
+    template class EliminationPlan<model::numeric::HybridBigInt, std::uint32_t>;
+    template class EliminationPlan<model::numeric::HybridBigInt, std::uint64_t>;
+    template class EliminationPlan<model::numeric::CheckedInt64, std::uint16_t>;
+    template class EliminationPlan<model::numeric::CheckedInt64, std::uint32_t>;
+    template class EliminationPlan<model::numeric::CheckedInt64, std::uint64_t>;
+    template class EliminationPlan<model::numeric::FixedInt<128>, std::uint16_t>;
+    template class EliminationPlan<model::numeric::FixedInt<128>, std::uint32_t>;
+    template class EliminationPlan<model::numeric::FixedInt<128>, std::uint64_t>;
+    template class EliminationPlan<model::numeric::FixedInt<256>, std::uint16_t>;
+    template class EliminationPlan<model::numeric::FixedInt<256>, std::uint32_t>;
+    template class EliminationPlan<model::numeric::FixedInt<256>, std::uint64_t>;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include "model/ConstantTrace.hpp"
+#include "model/Solution.hpp"
+#include "model/Variable.hpp"
+
+#include "model/numeric/BigInt.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace diophantus
+{
+    /**
+     * Compiled form of the elimination of an equation system: the arithmetic that solving applies
+     * to the constants, see model::ConstantTrace, and the registers that hold the values of a
+     * solution. It answers right sides for the same left sides without eliminating again.
+     *
+     * The plan is kept in a compact binary image, which can be saved to a file and memory mapped
+     * by other processes. Only the factors of the operations are decoded when a plan is loaded.
+     *
+     * File layout, in native byte order: a header, one record per operation, one record per
+     * assignment of a solution, and the 64 bit limbs of the factors that don't fit into an
+     * int64_t, least significant limb first.
+     */
+    template <model::numeric::BigInt NumT, model::VariableId VarT = model::Variable>
+    class EliminationPlan
+    {
+        public:
+            /**
+             * Compiles a plan from a recorded trace.
+             * @param trace
+             * @param solutionRegisters
+             *      Variable and register of each assignment of a solution, in order
+             */
+            EliminationPlan(const model::ConstantTrace<NumT>& trace,
+                            const std::vector<std::pair<VarT, size_t>>& solutionRegisters);
+
+            /**
+             * Memory maps a plan file. Factors that don't fit into NumT throw
+             * numeric::OverflowError.
+             * @param path
+             * @return the plan, or nullopt if the file can not be read or is no valid plan for
+             *         the variable id type.
+             */
+            static std::optional<EliminationPlan> load(const std::filesystem::path& path);
+
+            /**
+             * Writes the plan to a file.
+             * @param path
+             * @return false if the file could not be written.
+             */
+            bool save(const std::filesystem::path& path) const;
+
+            /**
+             * Solves the equation system for a right side. Throws std::invalid_argument if the
+             * right side does not have one constant per equation.
+             * @param rightSide
+             *      The right side of each equation the plan was compiled for
+             * @return A solution if the equation system is solvable with the right side, nullopt
+             *         otherwise.
+             */
+            std::optional<model::Solution<NumT, VarT>> solve(const std::vector<NumT>& rightSide) const;
+
+            // number of equations the plan was compiled for
+            size_t getRightSideCount() const;
+
+            // number of operations that are replayed for each right side
+            size_t getOperationCount() const;
+
+        private:
+            struct Header
+            {
+                char magic[8];
+                uint32_t version;
+                uint32_t byteOrderMark;
+                uint32_t variableIdSize;
+                uint32_t reserved;
+                uint64_t nRightSides;
+                uint64_t nRegisters;
+                uint64_t nOperations;
+                uint64_t nSolutionEntries;
+                uint64_t nFactorLimbs;
+            };
+
+            struct OperationRecord
+            {
+                uint32_t opcode;
+
+                // 0 if the factor is stored inline, otherwise the number of its limbs, negated
+                // for negative factors
+                int32_t factorSize;
+
+                uint64_t target;
+                uint64_t source;
+
+                // the factor, or the index of its first limb
+                int64_t factor;
+            };
+
+            struct SolutionRecord
+            {
+                uint64_t variable;
+                uint64_t constantRegister;
+            };
+
+            static constexpr char magic[8] = {'D', 'I', 'O', 'P', 'L', 'A', 'N', '\0'};
+            static constexpr uint32_t version = 1;
+            static constexpr uint32_t byteOrderMark = 0x01020304;
+
+            explicit EliminationPlan(MappedFile file);
+
+            /**
+             * Checks the structure of an image, so that replaying it stays within its registers.
+             * @return false if the image is no valid plan, the reason is logged.
+             */
+            static bool isValidImage(std::span<const std::byte> image);
+
+            /**
+             * Decodes the factors of all operations from the image.
+             */
+            void decodeFactors();
+
+            template <typename RecordT>
+            static RecordT readRecord(std::span<const std::byte> image, size_t offset);
+
+            OperationRecord getOperation(size_t index) const;
+            SolutionRecord getSolutionEntry(size_t index) const;
+
+        private:
+            // owns the image of a compiled plan, empty for loaded plans
+            std::vector<std::byte> ownedImage;
+
+            // maps the image of a loaded plan
+            std::optional<MappedFile> mappedFile;
+
+            std::span<const std::byte> image;
+            Header header;
+
+            // factor of each operation
+            std::vector<NumT> factors;
+    };
+}
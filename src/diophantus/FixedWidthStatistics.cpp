@@ -0,0 +1,27 @@
+#include "FixedWidthStatistics.hpp"
+
+namespace diophantus
+{
+    FixedWidthStatistics& FixedWidthStatistics::get()
+    {
+        static FixedWidthStatistics statistics;
+        return statistics;
+    }
+
+    void FixedWidthStatistics::reset()
+    {
+        nAttempts = 0;
+        nFallbacks = 0;
+        completedMicroseconds = 0;
+        discardedMicroseconds = 0;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const FixedWidthStatistics& statistics)
+    {
+        os << "fixed-width attempts: " << statistics.nAttempts
+           << ", fallbacks: " << statistics.nFallbacks
+           << ", completed: " << statistics.completedMicroseconds << " us"
+           << ", discarded: " << statistics.discardedMicroseconds << " us";
+        return os;
+    }
+}
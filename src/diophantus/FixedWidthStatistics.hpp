@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace diophantus
+{
+    /**
+     * Process-wide counters for solves that use fixed-width arithmetic
+     * (see Solver::Parameters::doUseFixedWidthArithmetic).
+     */
+    struct FixedWidthStatistics
+    {
+        // number of solves that were attempted with fixed-width arithmetic
+        std::atomic<size_t> nAttempts = 0;
+
+        // number of attempts that overflowed and were restarted with arbitrary precision
+        std::atomic<size_t> nFallbacks = 0;
+
+        // time spent in fixed-width solves that ran to completion
+        std::atomic<uint64_t> completedMicroseconds = 0;
+
+        // time spent in fixed-width solves that were thrown away because of an overflow
+        std::atomic<uint64_t> discardedMicroseconds = 0;
+
+        /**
+         * @return the global statistics instance
+         */
+        static FixedWidthStatistics& get();
+
+        /**
+         * Resets all counters to zero.
+         */
+        void reset();
+
+        friend std::ostream& operator<<(std::ostream& os, const FixedWidthStatistics& statistics);
+    };
+}
@@ -0,0 +1,255 @@
+#include "HermiteSolver.hpp"
+
+#include "diophantus/model/numeric/GmpBigInt.hpp"
+#include "diophantus/model/numeric/HybridBigInt.hpp"
+#include "diophantus/model/numeric/CheckedInt64.hpp"
+#include "diophantus/model/numeric/FixedInt.hpp"
+#include "model/conversion.hpp"
+#include "model/Assignment.hpp"
+#include "model/Equation.hpp"
+#include "model/EquationSystem.hpp"
+#include "model/Solution.hpp"
+
+#include <common/logging.hpp>
+
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace diophantus
+{
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    HermiteSolver<NumT, VarT>::HermiteSolver(model::EquationSystem<NumT, VarT> equationSystem) :
+        equationSystem(std::move(equationSystem)),
+        nRows(this->equationSystem.getEquationCount()),
+        nColumns(this->equationSystem.getVariableCount())
+    {
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<model::Solution<NumT, VarT>> HermiteSolver<NumT, VarT>::solve()
+    {
+        kernelBasis.clear();
+        computeHermiteNormalForm();
+        const size_t rank = pivotRows.size();
+        LOG_DEBUG << "Hermite normal form has rank " << rank << ".";
+
+        // Forward substitution in H * y = b. Row i of H only has entries in the pivot columns
+        // whose pivot lies in a row up to i.
+        std::vector<mpz_class> y(rank);
+        mpz_class residual;
+        size_t nPivots = 0;
+        for (size_t row = 0; row < nRows; ++row)
+        {
+            residual = rightSide[row];
+            for (size_t k = 0; k < nPivots; ++k)
+            {
+                mpz_submul(residual.get_mpz_t(), columns[k][row].get_mpz_t(), y[k].get_mpz_t());
+            }
+
+            if (nPivots < rank && pivotRows[nPivots] == row)
+            {
+                const mpz_class& pivot = columns[nPivots][row];
+                if (!mpz_divisible_p(residual.get_mpz_t(), pivot.get_mpz_t()))
+                {
+                    return std::nullopt;
+                }
+                mpz_divexact(y[nPivots].get_mpz_t(), residual.get_mpz_t(), pivot.get_mpz_t());
+                ++nPivots;
+            }
+            else if (residual != 0)
+            {
+                return std::nullopt;
+            }
+        }
+
+        // x = U * y, with the entries of y for the kernel columns set to zero
+        model::Solution<NumT, VarT> solution;
+        solution.assignments.reserve(nColumns);
+        mpz_class value;
+        for (size_t variable = 0; variable < nColumns; ++variable)
+        {
+            value = 0;
+            for (size_t k = 0; k < rank; ++k)
+            {
+                mpz_addmul(value.get_mpz_t(), columns[k][nRows + variable].get_mpz_t(), y[k].get_mpz_t());
+            }
+            solution.assignments.push_back(model::Assignment<NumT, VarT> {
+                .variable = static_cast<VarT>(variable),
+                .value = model::convertNumber<NumT>(model::numeric::GmpBigInt(value))
+            });
+        }
+
+        kernelBasis.reserve(nColumns - rank);
+        for (size_t k = rank; k < nColumns; ++k)
+        {
+            auto& basisVector = kernelBasis.emplace_back();
+            basisVector.reserve(nColumns);
+            for (size_t variable = 0; variable < nColumns; ++variable)
+            {
+                basisVector.push_back(model::convertNumber<NumT>(
+                    model::numeric::GmpBigInt(columns[k][nRows + variable])));
+            }
+        }
+
+        return solution;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    const std::vector<std::vector<NumT>>& HermiteSolver<NumT, VarT>::getKernelBasis() const
+    {
+        return kernelBasis;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    size_t HermiteSolver<NumT, VarT>::getRank() const
+    {
+        return pivotRows.size();
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void HermiteSolver<NumT, VarT>::computeHermiteNormalForm()
+    {
+        // Build A on top of the identity matrix U
+        columns.assign(nColumns, std::vector<mpz_class>(nRows + nColumns));
+        rightSide.assign(nRows, 0);
+        for (size_t row = 0; row < nRows; ++row)
+        {
+            const auto& equation = equationSystem.getEquations()[row];
+            for (const auto& term : equation.getLeftSide().getTerms())
+            {
+                if (term.getCoefficient() == 0)
+                {
+                    continue;
+                }
+                columns[term.getVariable()][row] +=
+                    model::convertNumber<model::numeric::GmpBigInt>(term.getCoefficient()).get();
+            }
+            rightSide[row] = model::convertNumber<model::numeric::GmpBigInt>(equation.getRightSide()).get();
+        }
+        for (size_t column = 0; column < nColumns; ++column)
+        {
+            columns[column][nRows + column] = 1;
+        }
+
+        pivotRows.clear();
+        for (size_t row = 0; row < nRows && pivotRows.size() < nColumns; ++row)
+        {
+            if (!reduceRow(row))
+            {
+                continue;
+            }
+
+            const size_t rank = pivotRows.size();
+            std::vector<mpz_class>& pivotColumn = columns[rank];
+            if (pivotColumn[row] < 0)
+            {
+                for (size_t i = row; i < pivotColumn.size(); ++i)
+                {
+                    mpz_neg(pivotColumn[i].get_mpz_t(), pivotColumn[i].get_mpz_t());
+                }
+            }
+
+            // Reduce the entries left of the pivot to [0, pivot)
+            for (size_t column = 0; column < rank; ++column)
+            {
+                mpz_fdiv_q(quotient.get_mpz_t(), columns[column][row].get_mpz_t(), pivotColumn[row].get_mpz_t());
+                if (quotient != 0)
+                {
+                    subtractColumnMultiple(column, rank, quotient, row);
+                }
+            }
+
+            pivotRows.push_back(row);
+        }
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool HermiteSolver<NumT, VarT>::reduceRow(const size_t row)
+    {
+        const size_t rank = pivotRows.size();
+        mpz_class remainder;
+
+        while (true)
+        {
+            // Move the entry with the lowest absolute value to the pivot column
+            size_t lowest = nColumns;
+            for (size_t column = rank; column < nColumns; ++column)
+            {
+                const mpz_class& entry = columns[column][row];
+                if (entry != 0 && (lowest == nColumns ||
+                                   mpz_cmpabs(entry.get_mpz_t(), columns[lowest][row].get_mpz_t()) < 0))
+                {
+                    lowest = column;
+                }
+            }
+            if (lowest == nColumns)
+            {
+                return false;
+            }
+            std::swap(columns[rank], columns[lowest]);
+
+            // Replace all other entries by their symmetric remainder modulo the pivot
+            const mpz_class& pivot = columns[rank][row];
+            bool isReduced = true;
+            for (size_t column = rank + 1; column < nColumns; ++column)
+            {
+                const mpz_class& entry = columns[column][row];
+                if (entry == 0)
+                {
+                    continue;
+                }
+
+                mpz_tdiv_qr(quotient.get_mpz_t(), remainder.get_mpz_t(), entry.get_mpz_t(), pivot.get_mpz_t());
+                if (2 * abs(remainder) > abs(pivot))
+                {
+                    quotient += sgn(remainder) * sgn(pivot);
+                }
+                subtractColumnMultiple(column, rank, quotient, row);
+                isReduced = isReduced && columns[column][row] == 0;
+            }
+
+            if (isReduced)
+            {
+                return true;
+            }
+        }
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void HermiteSolver<NumT, VarT>::subtractColumnMultiple(const size_t target, const size_t source,
+                                                           const mpz_class& factor, const size_t firstRow)
+    {
+        // Rows above firstRow are zero in the columns right of the pivot, and the transform rows
+        // follow the matrix rows, so the range is contiguous
+        std::vector<mpz_class>& targetColumn = columns[target];
+        const std::vector<mpz_class>& sourceColumn = columns[source];
+        for (size_t i = firstRow; i < targetColumn.size(); ++i)
+        {
+            if (sgn(sourceColumn[i]) != 0)
+            {
+                mpz_submul(targetColumn[i].get_mpz_t(), sourceColumn[i].get_mpz_t(), factor.get_mpz_t());
+            }
+        }
+    }
+
+    template class HermiteSolver<model::numeric::GmpBigInt, std::uint16_t>;
+    template class HermiteSolver<model::numeric::GmpBigInt, std::uint32_t>;
+    template class HermiteSolver<model::numeric::GmpBigInt, std::uint64_t>;
+    template class HermiteSolver<model::numeric::HybridBigInt, std::uint16_t>;
+    template class HermiteSolver<model::numeric::HybridBigInt, std::uint32_t>;
+    template class HermiteSolver<model::numeric::HybridBigInt, std::uint64_t>;
+    template class HermiteSolver<model::numeric::CheckedInt64, std::uint16_t>;
+    template class HermiteSolver<model::numeric::CheckedInt64, std::uint32_t>;
+    template class HermiteSolver<model::numeric::CheckedInt64, std::uint64_t>;
+    template class HermiteSolver<model::numeric::FixedInt<128>, std::uint16_t>;
+    template class HermiteSolver<model::numeric::FixedInt<128>, std::uint32_t>;
+    template class HermiteSolver<model::numeric::FixedInt<128>, std::uint64_t>;
+    template class HermiteSolver<model::numeric::FixedInt<256>, std::uint16_t>;
+    template class HermiteSolver<model::numeric::FixedInt<256>, std::uint32_t>;
+    template class HermiteSolver<model::numeric::FixedInt<256>, std::uint64_t>;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "model/EquationSystem.hpp"
+#include "model/Solution.hpp"
+#include "model/Variable.hpp"
+
+#include "model/numeric/BigInt.hpp"
+
+#include <gmpxx.h>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace diophantus
+{
+    /**
+     * Solving engine that transforms the coefficient matrix A into its column-style Hermite
+     * normal form H = A * U by unimodular column operations, which are tracked in U. The system
+     * A * x = b is then solvable iff the lower triangular system H * y = b is solvable over the
+     * integers, and x = U * y. Setting the free entries of y to zero gives the particular
+     * solution, and the columns of U that belong to them span the kernel lattice of A.
+     *
+     * The whole matrix is transformed at once with exact arithmetic, so the engine works on a
+     * dense copy of the equation system. It expects the variables to be numbered densely, as
+     * they are in a freshly built equation system.
+     */
+    template <model::numeric::BigInt NumT, model::VariableId VarT = model::Variable>
+    class HermiteSolver
+    {
+        public:
+            explicit HermiteSolver(model::EquationSystem<NumT, VarT> equationSystem);
+
+            /**
+             * Solves the given equation system.
+             * @return A solution if the equation system is solvable, nullopt otherwise.
+             */
+            std::optional<model::Solution<NumT, VarT>> solve();
+
+            /**
+             * Basis of the lattice of integer solutions of the homogeneous system A * x = 0,
+             * computed by the last successful solve. Every solution of the equation system is the
+             * returned solution plus an integer combination of these vectors.
+             * @return the basis vectors, each with one value per variable
+             */
+            const std::vector<std::vector<NumT>>& getKernelBasis() const;
+
+            // rank of the coefficient matrix, computed by the last solve
+            size_t getRank() const;
+
+        private:
+            /**
+             * Transforms the matrix into Hermite normal form and records the pivot rows.
+             */
+            void computeHermiteNormalForm();
+
+            /**
+             * Reduces the entries of a row right of the current rank to a single entry by the
+             * Euclidean algorithm on columns, and moves it to the column of the current rank.
+             * @return false if all of these entries are zero
+             */
+            bool reduceRow(size_t row);
+
+            /**
+             * Subtracts a multiple of the source column from the target column, starting at the
+             * given row of the matrix. The transform rows are always updated.
+             */
+            void subtractColumnMultiple(size_t target, size_t source, const mpz_class& factor, size_t firstRow);
+
+        private:
+            const model::EquationSystem<NumT, VarT> equationSystem;
+
+            size_t nRows;
+            size_t nColumns;
+
+            // columns of A stacked on the columns of U, each of length nRows + nColumns
+            std::vector<std::vector<mpz_class>> columns;
+
+            // right side of the equation system
+            std::vector<mpz_class> rightSide;
+
+            // for each pivot column, the row of its pivot
+            std::vector<size_t> pivotRows;
+
+            std::vector<std::vector<NumT>> kernelBasis;
+
+            // scratch value for quotients
+            mpz_class quotient;
+    };
+}
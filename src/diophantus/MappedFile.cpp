@@ -0,0 +1,84 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+namespace diophantus
+{
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "could not open " + path.string());
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) != 0)
+        {
+            const int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "could not stat " + path.string());
+        }
+
+        // Empty files can not be mapped, they are represented by an empty span
+        size = static_cast<size_t>(status.st_size);
+        if (size != 0)
+        {
+            void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED)
+            {
+                const int error = errno;
+                close(fd);
+                throw std::system_error(error, std::generic_category(), "could not map " + path.string());
+            }
+            data = static_cast<const std::byte*>(address);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        data(std::exchange(other.data, nullptr)),
+        size(std::exchange(other.size, 0))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        unmap();
+    }
+
+    std::span<const std::byte> MappedFile::getData() const
+    {
+        return {data, size};
+    }
+
+    void MappedFile::unmap()
+    {
+        if (data != nullptr)
+        {
+            munmap(const_cast<std::byte*>(data), size);
+            data = nullptr;
+            size = 0;
+        }
+    }
+}
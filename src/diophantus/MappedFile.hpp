@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace diophantus
+{
+    /**
+     * Read-only memory mapping of a whole file. The mapping is shared with other processes that
+     * map the same file, and pages are only read from disk when they are accessed.
+     */
+    class MappedFile
+    {
+        public:
+            /**
+             * Maps the file. Throws std::system_error if it can not be opened or mapped.
+             * @param path
+             */
+            explicit MappedFile(const std::filesystem::path& path);
+
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            ~MappedFile();
+
+            // contents of the file, valid as long as the mapping exists
+            std::span<const std::byte> getData() const;
+
+        private:
+            void unmap();
+
+        private:
+            const std::byte* data = nullptr;
+            size_t size = 0;
+    };
+}
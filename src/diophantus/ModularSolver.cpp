@@ -0,0 +1,461 @@
+#include "ModularSolver.hpp"
+
+#include "Solver.hpp"
+#include "Validator.hpp"
+
+#include "diophantus/model/numeric/GmpBigInt.hpp"
+#include "diophantus/model/numeric/HybridBigInt.hpp"
+#include "diophantus/model/numeric/CheckedInt64.hpp"
+#include "diophantus/model/numeric/FixedInt.hpp"
+#include "model/conversion.hpp"
+#include "model/Assignment.hpp"
+#include "model/Equation.hpp"
+#include "model/EquationSystem.hpp"
+#include "model/Solution.hpp"
+#include "model/Term.hpp"
+
+#include <common/logging.hpp>
+
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace diophantus
+{
+    namespace
+    {
+        // All primes are below 2^62, so that the sum of two residues does not overflow
+        constexpr uint64_t primeLimit = uint64_t(1) << 62;
+
+        __extension__ using uint128_t = unsigned __int128;
+
+        uint64_t mulMod(const uint64_t a, const uint64_t b, const uint64_t prime)
+        {
+            return static_cast<uint64_t>(static_cast<uint128_t>(a) * b % prime);
+        }
+
+        uint64_t subMod(const uint64_t a, const uint64_t b, const uint64_t prime)
+        {
+            return a >= b ? a - b : a + prime - b;
+        }
+
+        uint64_t powMod(uint64_t base, uint64_t exponent, const uint64_t prime)
+        {
+            uint64_t result = 1;
+            for (; exponent != 0; exponent >>= 1)
+            {
+                if (exponent & 1)
+                {
+                    result = mulMod(result, base, prime);
+                }
+                base = mulMod(base, base, prime);
+            }
+            return result;
+        }
+
+        uint64_t invMod(const uint64_t a, const uint64_t prime)
+        {
+            return powMod(a, prime - 2, prime);
+        }
+
+        /**
+         * Deterministic Miller-Rabin test, the bases are sufficient for all 64 bit numbers.
+         */
+        bool isPrime(const uint64_t n)
+        {
+            constexpr std::array<uint64_t, 12> bases = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+            uint64_t d = n - 1;
+            unsigned int s = 0;
+            for (; (d & 1) == 0; d >>= 1)
+            {
+                ++s;
+            }
+
+            for (uint64_t a : bases)
+            {
+                uint64_t x = powMod(a, d, n);
+                if (x == 1 || x == n - 1)
+                {
+                    continue;
+                }
+
+                bool isWitness = true;
+                for (unsigned int i = 1; i < s && isWitness; ++i)
+                {
+                    x = mulMod(x, x, n);
+                    isWitness = x != n - 1;
+                }
+                if (isWitness)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @return the largest prime below the given odd number
+         */
+        uint64_t previousPrime(uint64_t n)
+        {
+            do
+            {
+                n -= 2;
+            } while (!isPrime(n));
+            return n;
+        }
+
+        /**
+         * Pivot structures are ordered by quality: a higher rank is better, and for the same rank
+         * the lexicographically smaller pivot columns are. Unlucky primes only ever produce worse
+         * structures than the one over the rationals.
+         */
+        bool isBetterPivotStructure(const std::vector<size_t>& a, const std::vector<size_t>& b)
+        {
+            if (a.size() != b.size())
+            {
+                return a.size() > b.size();
+            }
+            return a < b;
+        }
+
+        /**
+         * Rational reconstruction by the extended Euclidean algorithm (Wang's algorithm).
+         * @return numerator and positive denominator with absolute values below the bound, that
+         *         are congruent to the residue, or nullopt if there are none.
+         */
+        std::optional<std::pair<mpz_class, mpz_class>> reconstructRational(
+            const mpz_class& residue, const mpz_class& modulus, const mpz_class& bound)
+        {
+            // Fast path for integers
+            if (residue <= bound)
+            {
+                return std::make_pair(residue, mpz_class(1));
+            }
+            else if (modulus - residue <= bound)
+            {
+                return std::make_pair(mpz_class(residue - modulus), mpz_class(1));
+            }
+
+            mpz_class r0 = modulus;
+            mpz_class r1 = residue;
+            mpz_class t0 = 0;
+            mpz_class t1 = 1;
+            mpz_class q;
+            while (r1 > bound)
+            {
+                mpz_fdiv_q(q.get_mpz_t(), r0.get_mpz_t(), r1.get_mpz_t());
+                r0 -= q * r1;
+                std::swap(r0, r1);
+                t0 -= q * t1;
+                std::swap(t0, t1);
+            }
+
+            if (abs(t1) > bound || gcd(r1, t1) != 1)
+            {
+                return std::nullopt;
+            }
+            if (t1 < 0)
+            {
+                return std::make_pair(mpz_class(-r1), mpz_class(-t1));
+            }
+            return std::make_pair(r1, t1);
+        }
+    }
+
+    template <model::numeric::BigInt NumT>
+    ModularSolver<NumT>::ModularSolver(model::EquationSystem<NumT> equationSystem,
+                                       const Parameters& parameters) :
+        parameters(parameters),
+        equationSystem(std::move(equationSystem)),
+        nRows(this->equationSystem.getEquationCount()),
+        nColumns(this->equationSystem.getVariableCount())
+    {
+        rows.reserve(nRows);
+        for (const auto& equation : this->equationSystem.getEquations())
+        {
+            auto& row = rows.emplace_back();
+            for (const auto& term : equation.getLeftSide().getTerms())
+            {
+                if (term.getCoefficient() == 0)
+                {
+                    continue;
+                }
+                row.emplace_back(term.getVariable(),
+                                 model::convertNumber<model::numeric::GmpBigInt>(term.getCoefficient()).get());
+            }
+            row.emplace_back(nColumns,
+                             model::convertNumber<model::numeric::GmpBigInt>(equation.getRightSide()).get());
+        }
+    }
+
+    template <model::numeric::BigInt NumT>
+    std::optional<model::Solution<NumT>> ModularSolver<NumT>::solve()
+    {
+        std::optional<model::Solution<NumT>> solution = trySolveModular();
+        usedFallback = !solution.has_value();
+        if (!usedFallback)
+        {
+            LOG_DEBUG << "Lifted modular solution from " << nPrimes << " primes.";
+            return solution;
+        }
+
+        LOG_DEBUG << "Modular solution could not be lifted after " << nPrimes << " primes, "
+                  << "solving again.";
+        Solver<NumT> solver(equationSystem, parameters.fallbackParameters);
+        return solver.solve();
+    }
+
+    template <model::numeric::BigInt NumT>
+    size_t ModularSolver<NumT>::getPrimeCount() const
+    {
+        return nPrimes;
+    }
+
+    template <model::numeric::BigInt NumT>
+    bool ModularSolver<NumT>::hasUsedFallback() const
+    {
+        return usedFallback;
+    }
+
+    template <model::numeric::BigInt NumT>
+    std::optional<model::Solution<NumT>> ModularSolver<NumT>::trySolveModular()
+    {
+        const size_t primeBound = parameters.maxPrimes != 0 ? parameters.maxPrimes : getPrimeBound();
+
+        matrix.resize(nRows * (nColumns + 1));
+        residues.assign(nColumns, 0);
+        modulus = 1;
+        nPrimes = 0;
+
+        PivotColumns bestPivotColumns;
+        std::optional<std::vector<std::pair<mpz_class, mpz_class>>> previousCandidate;
+        size_t nextAttempt = 1;
+
+        // Primes that yield a worse pivot structure are skipped, but only a limited number of them
+        size_t nSkippedPrimes = 0;
+
+        for (uint64_t prime = previousPrime(primeLimit + 1);
+             nPrimes < primeBound && nSkippedPrimes <= primeBound;
+             prime = previousPrime(prime))
+        {
+            PivotColumns pivotColumns = eliminateModulo(prime);
+
+            if (nPrimes == 0 || isBetterPivotStructure(pivotColumns, bestPivotColumns))
+            {
+                // All previous primes were unlucky, start over
+                bestPivotColumns = std::move(pivotColumns);
+                std::ranges::fill(residues, 0);
+                modulus = 1;
+                nPrimes = 0;
+                previousCandidate.reset();
+                nextAttempt = 1;
+            }
+            else if (pivotColumns != bestPivotColumns)
+            {
+                ++nSkippedPrimes;
+                continue;
+            }
+
+            // Combine the residues with the Chinese Remainder Theorem:
+            // x = x' + m * ((v - x') / m mod p), where x' = x mod m and v = x mod p
+            const uint64_t inverseModulus = invMod(mpz_fdiv_ui(modulus.get_mpz_t(), prime), prime);
+            for (size_t column = 0; column < nColumns; ++column)
+            {
+                uint64_t value = 0;
+                auto pivot = std::ranges::lower_bound(bestPivotColumns, column);
+                if (pivot != bestPivotColumns.end() && *pivot == column)
+                {
+                    size_t row = pivot - bestPivotColumns.begin();
+                    value = matrix[row * (nColumns + 1) + nColumns];
+                }
+
+                uint64_t current = mpz_fdiv_ui(residues[column].get_mpz_t(), prime);
+                uint64_t factor = mulMod(subMod(value, current, prime), inverseModulus, prime);
+                mpz_addmul_ui(residues[column].get_mpz_t(), modulus.get_mpz_t(), factor);
+            }
+            modulus *= prime;
+            ++nPrimes;
+
+            if (nPrimes != nextAttempt && nPrimes != primeBound)
+            {
+                continue;
+            }
+            nextAttempt *= 2;
+
+            if (!bestPivotColumns.empty() && bestPivotColumns.back() == nColumns)
+            {
+                // Inconsistent modulo all good primes, let the Solver decide
+                if (nPrimes >= 2)
+                {
+                    return std::nullopt;
+                }
+                continue;
+            }
+
+            auto candidate = reconstruct();
+            if (!candidate.has_value())
+            {
+                previousCandidate.reset();
+                continue;
+            }
+
+            bool isIntegral = std::ranges::all_of(candidate.value(), [](const auto& value) {
+                return value.second == 1;
+            });
+
+            if (isIntegral)
+            {
+                model::Solution<NumT> solution;
+                solution.assignments.reserve(nColumns);
+                for (size_t column = 0; column < nColumns; ++column)
+                {
+                    solution.assignments.push_back(model::Assignment<NumT> {
+                        .variable = static_cast<model::Variable>(column),
+                        .value = model::convertNumber<NumT>(
+                            model::numeric::GmpBigInt(candidate.value()[column].first))
+                    });
+                }
+
+                if (Validator<NumT>::isValidSolution(equationSystem, solution))
+                {
+                    return solution;
+                }
+            }
+            else if (candidate == previousCandidate)
+            {
+                // The particular solution is stable, but not integral
+                return std::nullopt;
+            }
+
+            previousCandidate = std::move(candidate);
+        }
+
+        return std::nullopt;
+    }
+
+    template <model::numeric::BigInt NumT>
+    typename ModularSolver<NumT>::PivotColumns ModularSolver<NumT>::eliminateModulo(const uint64_t prime)
+    {
+        const size_t width = nColumns + 1;
+
+        std::ranges::fill(matrix, 0);
+        for (size_t row = 0; row < nRows; ++row)
+        {
+            for (const auto& [column, value] : rows[row])
+            {
+                uint64_t& entry = matrix[row * width + column];
+                entry = (entry + mpz_fdiv_ui(value.get_mpz_t(), prime)) % prime;
+            }
+        }
+
+        PivotColumns pivotColumns;
+        for (size_t column = 0; column < width && pivotColumns.size() < nRows; ++column)
+        {
+            const size_t rank = pivotColumns.size();
+
+            size_t pivotRow = rank;
+            while (pivotRow < nRows && matrix[pivotRow * width + column] == 0)
+            {
+                ++pivotRow;
+            }
+            if (pivotRow == nRows)
+            {
+                continue;
+            }
+
+            uint64_t* pivot = &matrix[rank * width];
+            if (pivotRow != rank)
+            {
+                std::swap_ranges(pivot + column, pivot + width, &matrix[pivotRow * width + column]);
+            }
+
+            // Normalize the pivot row and remember where it has nonzero entries
+            const uint64_t inverse = invMod(pivot[column], prime);
+            pivotRowSupport.clear();
+            for (size_t k = column; k < width; ++k)
+            {
+                if (pivot[k] != 0)
+                {
+                    pivot[k] = mulMod(pivot[k], inverse, prime);
+                    pivotRowSupport.push_back(k);
+                }
+            }
+
+            // Eliminate the pivot column from all other rows
+            for (size_t row = 0; row < nRows; ++row)
+            {
+                uint64_t* current = &matrix[row * width];
+                const uint64_t factor = current[column];
+                if (row == rank || factor == 0)
+                {
+                    continue;
+                }
+
+                for (size_t k : pivotRowSupport)
+                {
+                    current[k] = subMod(current[k], mulMod(factor, pivot[k], prime), prime);
+                }
+            }
+
+            pivotColumns.push_back(column);
+        }
+
+        return pivotColumns;
+    }
+
+    template <model::numeric::BigInt NumT>
+    std::optional<std::vector<std::pair<mpz_class, mpz_class>>> ModularSolver<NumT>::reconstruct() const
+    {
+        // Numerators and denominators are unique if both are at most sqrt(m / 2)
+        mpz_class bound = modulus / 2;
+        mpz_sqrt(bound.get_mpz_t(), bound.get_mpz_t());
+
+        std::vector<std::pair<mpz_class, mpz_class>> values;
+        values.reserve(nColumns);
+        for (const auto& residue : residues)
+        {
+            auto value = reconstructRational(residue, modulus, bound);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            values.push_back(std::move(value.value()));
+        }
+        return values;
+    }
+
+    template <model::numeric::BigInt NumT>
+    size_t ModularSolver<NumT>::getPrimeBound() const
+    {
+        // By Cramer's rule, numerators and denominators are minors of (A | b), which are bounded
+        // by the product of the row norms
+        size_t boundBits = 0;
+        mpz_class squareNorm;
+        for (const auto& row : rows)
+        {
+            squareNorm = 0;
+            for (const auto& [column, value] : row)
+            {
+                squareNorm += value * value;
+            }
+            boundBits += (mpz_sizeinbase(squareNorm.get_mpz_t(), 2) + 1) / 2;
+        }
+
+        // Reconstruction needs a modulus above 2 * bound^2, every prime contributes 61 bits
+        return (2 * boundBits + 1) / 61 + 1;
+    }
+
+    template class ModularSolver<model::numeric::GmpBigInt>;
+    template class ModularSolver<model::numeric::HybridBigInt>;
+    template class ModularSolver<model::numeric::CheckedInt64>;
+    template class ModularSolver<model::numeric::FixedInt<128>>;
+    template class ModularSolver<model::numeric::FixedInt<256>>;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Solver.hpp"
+
+#include "model/EquationSystem.hpp"
+#include "model/Solution.hpp"
+
+#include "model/numeric/BigInt.hpp"
+
+#include <gmpxx.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace diophantus
+{
+    /**
+     * Solving engine that avoids coefficient growth by running Gauss-Jordan elimination modulo
+     * several word-sized primes. The residues of a particular solution (all free variables set to
+     * zero) are combined with the Chinese Remainder Theorem and lifted to rationals by rational
+     * reconstruction.
+     *
+     * The lifted result is only returned if it is integral and the Validator confirms it.
+     * Otherwise, e.g. if the particular solution is not integral, the system is inconsistent, or
+     * all primes were unlucky, the equation system is solved by the Omega-style Solver instead.
+     */
+    template <model::numeric::BigInt NumT>
+    class ModularSolver
+    {
+        public:
+            struct Parameters
+            {
+                // maximum number of primes to use, 0 means that it is derived from the Hadamard
+                // bound of the equation system
+                size_t maxPrimes = 0;
+
+                // parameters of the Solver that is used if the modular result cannot be lifted
+                typename Solver<NumT>::Parameters fallbackParameters = {};
+            };
+
+        public:
+            explicit ModularSolver(model::EquationSystem<NumT> equationSystem,
+                                   const Parameters& parameters = Parameters());
+
+            /**
+             * Solves the given equation system.
+             * @return A solution if the equation system is solvable, nullopt otherwise.
+             */
+            std::optional<model::Solution<NumT>> solve();
+
+            // number of primes the equation system was solved modulo in the last solve
+            size_t getPrimeCount() const;
+
+            // whether the last solve had to fall back to the Omega-style Solver
+            bool hasUsedFallback() const;
+
+        private:
+            /**
+             * Pivot structure of a reduced row echelon form. Column n (the right side) is a pivot
+             * column iff the system is inconsistent modulo the prime.
+             */
+            using PivotColumns = std::vector<size_t>;
+
+            /**
+             * Solves the equation system modulo primes and lifts the result to the integers.
+             * @return A validated solution, or nullopt if the modular result could not be lifted.
+             */
+            std::optional<model::Solution<NumT>> trySolveModular();
+
+            /**
+             * Reduces the equation system modulo the prime and transforms it into reduced row
+             * echelon form in the member matrix.
+             * @return the pivot columns of the reduced matrix
+             */
+            PivotColumns eliminateModulo(uint64_t prime);
+
+            /**
+             * Lifts the combined residues to rationals by rational reconstruction.
+             * @return numerator and denominator for each variable, or nullopt if a residue could
+             *         not be reconstructed with the current modulus.
+             */
+            std::optional<std::vector<std::pair<mpz_class, mpz_class>>> reconstruct() const;
+
+            /**
+             * Computes an upper bound on the number of primes that are needed to reconstruct the
+             * numerators and denominators of the particular solution, using the Hadamard bound.
+             */
+            size_t getPrimeBound() const;
+
+        private:
+            const Parameters parameters;
+            const model::EquationSystem<NumT> equationSystem;
+
+            size_t nRows;
+            size_t nColumns;
+
+            // sparse rows of the augmented matrix (A | b) with exact coefficients
+            std::vector<std::vector<std::pair<size_t, mpz_class>>> rows;
+
+            // dense augmented matrix modulo the current prime, reused for all primes
+            std::vector<uint64_t> matrix;
+
+            // columns with nonzero entries in the current pivot row
+            std::vector<size_t> pivotRowSupport;
+
+            // residues of the particular solution modulo the product of all good primes
+            std::vector<mpz_class> residues;
+            mpz_class modulus;
+
+            size_t nPrimes = 0;
+            bool usedFallback = false;
+    };
+}
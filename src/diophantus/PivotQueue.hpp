@@ -0,0 +1,240 @@
+#pragma once
+
+#include "model/Equation.hpp"
+
+#include "model/numeric/BigInt.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace diophantus
+{
+    /**
+     * Indexed min-heap of the equations of an equation system, ordered by how well they are suited
+     * as the next pivot equation. Equations with a single term come first, then equations with a
+     * coefficient of absolute value 1, then all others by their lowest absolute coefficient. Ties
+     * are broken by the index of the equation.
+     *
+     * The priority of an equation is only recomputed when it is updated, so picking the next
+     * equation takes O(1) and updating an equation O(log n).
+     */
+    template <model::numeric::BigInt NumT, model::VariableId VarT = model::Variable>
+    class PivotQueue
+    {
+        public:
+            struct Entry
+            {
+                // index of the equation in the equation system
+                size_t equationIndex;
+
+                // position of the term with the lowest absolute coefficient in the left side
+                size_t termIndex;
+            };
+
+        public:
+            bool isEmpty() const
+            {
+                return heap.empty();
+            }
+
+            /**
+             * @return The equation that is best suited as the next pivot equation.
+             */
+            Entry top() const
+            {
+                const size_t equationIndex = heap.front();
+                return Entry{equationIndex, keys[equationIndex]->termIndex};
+            }
+
+            /**
+             * Inserts an equation or recomputes its priority.
+             * @param equationIndex
+             * @param equation
+             */
+            void update(size_t equationIndex, const model::Equation<NumT, VarT>& equation)
+            {
+                if (equationIndex >= keys.size())
+                {
+                    keys.resize(equationIndex + 1);
+                    positions.resize(equationIndex + 1, notQueued);
+                }
+
+                const model::Sum<NumT, VarT>& leftSide = equation.getLeftSide();
+                const size_t termIndex = leftSide.getLowestCoefficientIndex();
+                const NumT& coefficient = leftSide.getCoefficients()[termIndex];
+
+                Rank rank = Rank::Other;
+                if (leftSide.getTermCount() == 1)
+                {
+                    rank = Rank::SingleTerm;
+                }
+                else if (coefficient == 1 || coefficient == -1)
+                {
+                    rank = Rank::UnitCoefficient;
+                }
+                keys[equationIndex] = Key{rank, NumT::abs(coefficient), termIndex};
+
+                if (positions[equationIndex] == notQueued)
+                {
+                    positions[equationIndex] = heap.size();
+                    heap.push_back(equationIndex);
+                }
+                restore(positions[equationIndex]);
+            }
+
+            /**
+             * Removes an equation from the queue, if it is queued.
+             * @param equationIndex
+             */
+            void remove(size_t equationIndex)
+            {
+                if (equationIndex >= positions.size() || positions[equationIndex] == notQueued)
+                {
+                    return;
+                }
+
+                const size_t position = positions[equationIndex];
+                positions[equationIndex] = notQueued;
+                keys[equationIndex].reset();
+
+                const size_t last = heap.back();
+                heap.pop_back();
+                if (position < heap.size())
+                {
+                    place(last, position);
+                    restore(position);
+                }
+            }
+
+            /**
+             * Renames a queued equation after it was moved to another index in the equation
+             * system. The target index must not be queued.
+             * @param fromIndex
+             * @param toIndex
+             */
+            void move(size_t fromIndex, size_t toIndex)
+            {
+                if (fromIndex >= positions.size() || positions[fromIndex] == notQueued)
+                {
+                    return;
+                }
+                if (toIndex >= keys.size())
+                {
+                    keys.resize(toIndex + 1);
+                    positions.resize(toIndex + 1, notQueued);
+                }
+
+                keys[toIndex] = std::move(keys[fromIndex]);
+                keys[fromIndex].reset();
+                const size_t position = positions[fromIndex];
+                positions[fromIndex] = notQueued;
+
+                // The index breaks ties, so the equation may have to move within the heap
+                place(toIndex, position);
+                restore(position);
+            }
+
+            void clear()
+            {
+                heap.clear();
+                keys.clear();
+                positions.clear();
+            }
+
+        private:
+            enum class Rank
+            {
+                SingleTerm,
+                UnitCoefficient,
+                Other
+            };
+
+            struct Key
+            {
+                Rank rank;
+                NumT magnitude;
+                size_t termIndex;
+            };
+
+            static constexpr size_t notQueued = std::numeric_limits<size_t>::max();
+
+            bool isBefore(size_t a, size_t b) const
+            {
+                const Key& keyA = *keys[a];
+                const Key& keyB = *keys[b];
+                if (keyA.rank != keyB.rank)
+                {
+                    return keyA.rank < keyB.rank;
+                }
+                if (keyA.rank == Rank::Other)
+                {
+                    const std::strong_ordering order = keyA.magnitude.absCmp(keyB.magnitude);
+                    if (order != std::strong_ordering::equal)
+                    {
+                        return order == std::strong_ordering::less;
+                    }
+                }
+                return a < b;
+            }
+
+            void place(size_t equationIndex, size_t position)
+            {
+                heap[position] = equationIndex;
+                positions[equationIndex] = position;
+            }
+
+            /**
+             * Moves the entry at a heap position up or down until the heap property holds.
+             */
+            void restore(size_t position)
+            {
+                const size_t equationIndex = heap[position];
+
+                while (position > 0)
+                {
+                    const size_t parent = (position - 1) / 2;
+                    if (!isBefore(equationIndex, heap[parent]))
+                    {
+                        break;
+                    }
+                    place(heap[parent], position);
+                    position = parent;
+                }
+
+                while (true)
+                {
+                    size_t child = 2 * position + 1;
+                    if (child >= heap.size())
+                    {
+                        break;
+                    }
+                    if (child + 1 < heap.size() && isBefore(heap[child + 1], heap[child]))
+                    {
+                        ++child;
+                    }
+                    if (!isBefore(heap[child], equationIndex))
+                    {
+                        break;
+                    }
+                    place(heap[child], position);
+                    position = child;
+                }
+
+                place(equationIndex, position);
+            }
+
+        private:
+            // equation indices in heap order
+            std::vector<size_t> heap;
+
+            // priority of each queued equation, indexed by equation index
+            std::vector<std::optional<Key>> keys;
+
+            // position of each equation in the heap, indexed by equation index
+            std::vector<size_t> positions;
+    };
+}
@@ -1,6 +1,15 @@
 #include "Solver.hpp"
 
+#include "FixedWidthStatistics.hpp"
+#include "HermiteSolver.hpp"
+
 #include "diophantus/model/numeric/GmpBigInt.hpp"
+#include "diophantus/model/numeric/HybridBigInt.hpp"
+#include "diophantus/model/numeric/CheckedInt64.hpp"
+#include "diophantus/model/numeric/FixedInt.hpp"
+#include "diophantus/model/numeric/GmpArena.hpp"
+#include "diophantus/model/numeric/OverflowError.hpp"
+#include "model/conversion.hpp"
 #include "model/Assignment.hpp"
 #include "model/Equation.hpp"
 #include "model/EquationSystem.hpp"
@@ -13,31 +22,391 @@
 
 #include <algorithm>
 #include <bits/ranges_algo.h>
+#include <chrono>
 #include <compare>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <queue>
 #include <random>
 #include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace diophantus
 {
-    template <model::numeric::BigInt NumT>
-    Solver<NumT>::Solver(const model::EquationSystem<NumT>& equationSystem, const Parameters& parameters) :
-        parameters(std::move(parameters)),
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    Solver<NumT, VarT>::Solver(model::EquationSystem<NumT, VarT> equationSystem, const Parameters& parameters) :
+        parameters(parameters),
         equationSystem(std::move(equationSystem)),
-        nOriginalVariables(equationSystem.getVariableCount()),
-        nOriginalEquations(equationSystem.getEquationCount()),
-        lastIterationNumberOfEquations(equationSystem.getEquationCount())
+        nOriginalVariables(this->equationSystem.getVariableCount()),
+        nOriginalEquations(this->equationSystem.getEquationCount()),
+        lastIterationNumberOfEquations(this->equationSystem.getEquationCount())
+    {
+        this->equationSystem.setThreadPool(parameters.threadPool.get(), parameters.minParallelRows);
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<model::Solution<NumT, VarT>> Solver<NumT, VarT>::solve()
+    {
+        hasSolved = true;
+        if (parameters.engine == SolvingEngine::HermiteNormalForm)
+        {
+            // The Hermite solver takes over the equation system, so there is nothing left to
+            // extend afterwards
+            std::optional<model::Solution<NumT, VarT>> solution =
+                HermiteSolver<NumT, VarT>(std::move(equationSystem)).solve();
+            equationSystem.clear();
+            hasEliminationState = false;
+            return solution;
+        }
+
+        if constexpr (!std::is_same_v<NumT, model::numeric::CheckedInt64>)
+        {
+            std::optional<model::Solution<NumT, VarT>> solution;
+            if (parameters.doUseFixedWidthArithmetic && trySolveFixedWidth(solution))
+            {
+                return solution;
+            }
+        }
+
+        if (parameters.doUseGmpArena)
+        {
+            return solveInArena();
+        }
+        return solveDirectly();
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<model::Solution<NumT, VarT>> Solver<NumT, VarT>::solveInArena()
+    {
+        model::numeric::GmpArena arena;
+        std::optional<model::Solution<NumT, VarT>> solution;
+
+        // GMP's memory functions are global, so the arena can't serve other threads
+        equationSystem.setThreadPool(nullptr, 0);
+
+        {
+            model::numeric::GmpArenaScope arenaScope(arena);
+            std::optional<model::Solution<NumT, VarT>> arenaSolution = solveDirectly();
+
+            if (arenaSolution.has_value())
+            {
+                // The solution outlives the arena, so copy it with the regular allocator
+                model::numeric::GmpArenaScope::Suspension suspension(arenaScope);
+                solution.emplace(arenaSolution.value());
+            }
+
+            // Release the working state while its memory is still managed by the arena
+            equationSystem.clear();
+            pivotQueue.clear();
+            deducedEquations.clear();
+            assignments.clear();
+            hasEliminationState = false;
+        }
+
+        LOG_DEBUG << "GMP arena served " << arena.getAllocationCount() << " allocations, "
+                  << "reserved " << arena.getReservedBytes() << " bytes";
+        return solution;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::vector<std::optional<model::Solution<NumT, VarT>>> Solver<NumT, VarT>::solveBatch(
+        const std::vector<std::vector<NumT>>& rightSides) const
+    {
+        const size_t nEquations = equationSystem.getEquationCount();
+        for (const auto& rightSide : rightSides)
+        {
+            if (rightSide.size() != nEquations)
+            {
+                throw std::invalid_argument("expected " + std::to_string(nEquations) + " right sides, got "
+                                            + std::to_string(rightSide.size()));
+            }
+        }
+
+        const EliminationPlan<NumT, VarT> plan = compilePlan();
+
+        std::vector<std::optional<model::Solution<NumT, VarT>>> solutions;
+        solutions.reserve(rightSides.size());
+        for (const auto& rightSide : rightSides)
+        {
+            solutions.push_back(plan.solve(rightSide));
+        }
+        return solutions;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    EliminationPlan<NumT, VarT> Solver<NumT, VarT>::compilePlan() const
+    {
+        if (hasSolved)
+        {
+            throw std::logic_error("a plan can only be compiled before the equation system is solved");
+        }
+
+        // Which operations are applied to the constants does not depend on their values, as
+        // long as no conflict occurs. The homogeneous equation system never conflicts.
+        model::EquationSystem<NumT, VarT> homogeneousSystem = equationSystem;
+        for (auto& equation : homogeneousSystem.getEquations())
+        {
+            equation = model::Equation<NumT, VarT>(equation.getLeftSide(), NumT(0));
+        }
+
+        // The elimination runs with its own state, so that this solver can still solve
+        Solver<NumT, VarT> compiler(std::move(homogeneousSystem), parameters);
+        return compiler.compileHomogeneousPlan();
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    EliminationPlan<NumT, VarT> Solver<NumT, VarT>::compileHomogeneousPlan()
+    {
+        const size_t nEquations = equationSystem.getEquationCount();
+
+        model::ConstantTrace<NumT> trace(nEquations);
+        constantTrace = &trace;
+        equationSystem.setConstantTrace(&trace);
+        eliminate();
+        std::vector<model::Assignment<NumT, VarT>> allAssignments = backPropagateDeducedEquations();
+        equationSystem.setConstantTrace(nullptr);
+        constantTrace = nullptr;
+
+        // The elimination belongs to the homogeneous equation system, so it can't be extended
+        hasEliminationState = false;
+
+        LOG_DEBUG << "Recorded " << trace.getOperationCount() << " operations on "
+                  << trace.getRegisterCount() << " constants.";
+
+        // Registers of the assignments that make up a solution, see getSolutionFromAssignments
+        std::vector<std::pair<VarT, size_t>> solutionRegisters;
+        for (size_t assignmentIndex = 0; assignmentIndex < allAssignments.size(); ++assignmentIndex)
+        {
+            if (allAssignments[assignmentIndex].variable < nOriginalVariables)
+            {
+                solutionRegisters.emplace_back(allAssignments[assignmentIndex].variable,
+                                               assignmentRegisters[assignmentIndex]);
+            }
+        }
+
+        return EliminationPlan<NumT, VarT>(trace, solutionRegisters);
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool Solver<NumT, VarT>::trySolveFixedWidth(std::optional<model::Solution<NumT, VarT>>& solution)
     {
+        using FixedT = model::numeric::CheckedInt64;
+
+        auto& statistics = FixedWidthStatistics::get();
+        ++statistics.nAttempts;
+
+        auto startTime = std::chrono::steady_clock::now();
+        auto elapsedMicroseconds = [startTime]() {
+            auto duration = std::chrono::steady_clock::now() - startTime;
+            return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        };
+
+        try
+        {
+            Solver<FixedT, VarT> fixedWidthSolver(model::convertEquationSystem<FixedT>(equationSystem),
+                                                  typename Solver<FixedT, VarT>::Parameters {
+                                                      .doShowProgress = parameters.doShowProgress,
+                                                      .doUseRowArena = parameters.doUseRowArena,
+                                                      .rowPolicy = parameters.rowPolicy,
+                                                      .variableRenumbering = parameters.variableRenumbering,
+                                                      .threadPool = parameters.threadPool,
+                                                      .minParallelRows = parameters.minParallelRows
+                                                  });
+            std::optional<model::Solution<FixedT, VarT>> fixedWidthSolution = fixedWidthSolver.solve();
+
+            if (fixedWidthSolution.has_value())
+            {
+                solution = model::convertSolution<NumT>(fixedWidthSolution.value());
+            }
+            statistics.completedMicroseconds += elapsedMicroseconds();
+            return true;
+        }
+        catch (const model::numeric::OverflowError& e)
+        {
+            LOG_DEBUG << "Overflow in fixed-width arithmetic (" << e.what() << "), solving again.";
+            ++statistics.nFallbacks;
+            statistics.discardedMicroseconds += elapsedMicroseconds();
+            return false;
+        }
     }
 
-    template <model::numeric::BigInt NumT>
-    std::optional<model::Solution<NumT>> Solver<NumT>::solve()
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<model::Solution<NumT, VarT>> Solver<NumT, VarT>::solveDirectly()
     {
         LOG_DEBUG << "Solving equation system: " << std::endl << equationSystem;
 
+        if (!eliminate())
+        {
+            return std::nullopt;
+        }
+
+        LOG_DEBUG << "Resubstituting...";
+        std::vector<model::Assignment<NumT, VarT>> allAssignments = backPropagateDeducedEquations();
+
+        LOG_DEBUG << "Extracting solution...";
+        return getSolutionFromAssignments(allAssignments);
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void Solver<NumT, VarT>::addEquation(const model::Equation<NumT, VarT>& equation)
+    {
+        requireEliminationEngine();
+        if (!hasEliminationState)
+        {
+            throw std::logic_error("equations can only be added after an elimination of the equation system");
+        }
+        for (VarT variable : equation.getLeftSide().getVariables())
+        {
+            if (variable >= nOriginalVariables)
+            {
+                throw std::invalid_argument("unknown variable x[" + std::to_string(variable) + "]");
+            }
+        }
+        if (isUnsolvable)
+        {
+            return;
+        }
+
+        indexEliminatedVariables();
+        model::Equation<NumT, VarT> residual = equation;
+
+        // Substitute the deduced equations in the order in which they were deduced. A deduced
+        // equation only contains variables that were not eliminated yet when it was deduced, so
+        // each one is substituted at most once.
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<>> pendingEquations;
+        auto enqueueDeducedEquations = [&](const model::Sum<NumT, VarT>& sum) {
+            for (VarT variable : sum.getVariables())
+            {
+                if (variable < deducedEquationIndices.size() && deducedEquationIndices[variable] != notEliminated)
+                {
+                    pendingEquations.push(deducedEquationIndices[variable]);
+                }
+            }
+        };
+
+        enqueueDeducedEquations(residual.getLeftSide());
+        while (!pendingEquations.empty())
+        {
+            const size_t deducedIndex = pendingEquations.top();
+            while (!pendingEquations.empty() && pendingEquations.top() == deducedIndex)
+            {
+                pendingEquations.pop();
+            }
+
+            const model::DeducedEquation<NumT, VarT>& deducedEquation = deducedEquations[deducedIndex];
+            if (residual.substitute(deducedEquation).has_value())
+            {
+                enqueueDeducedEquations(deducedEquation.getRightSideSum());
+            }
+        }
+
+        // The assignments hold constants, so their order does not matter
+        std::vector<size_t> assignedIndices;
+        for (VarT variable : residual.getLeftSide().getVariables())
+        {
+            if (variable < assignmentIndices.size() && assignmentIndices[variable] != notEliminated)
+            {
+                assignedIndices.push_back(assignmentIndices[variable]);
+            }
+        }
+        for (size_t assignmentIndex : assignedIndices)
+        {
+            residual.substitute(assignments[assignmentIndex]);
+        }
+
+        LOG_DEBUG << "Adding residual equation " << residual;
+        equationSystem.addEquation(residual);
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::optional<model::Solution<NumT, VarT>> Solver<NumT, VarT>::resolve()
+    {
+        requireEliminationEngine();
+        if (!hasEliminationState)
+        {
+            throw std::logic_error("the equation system can only be resolved after an elimination");
+        }
+        if (isUnsolvable || !eliminate())
+        {
+            return std::nullopt;
+        }
+
+        std::vector<model::Assignment<NumT, VarT>> allAssignments = backPropagateDeducedEquations();
+        return getSolutionFromAssignments(allAssignments);
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void Solver<NumT, VarT>::push()
+    {
+        requireEliminationEngine();
+        if (!hasEliminationState)
+        {
+            throw std::logic_error("scopes can only be opened after an elimination of the equation system");
+        }
+
+        scopes.push_back(Scope {
+            .nDeducedEquations = deducedEquations.size(),
+            .nAssignments = assignments.size(),
+            .isUnsolvable = isUnsolvable
+        });
+        equationSystem.push();
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void Solver<NumT, VarT>::pop()
+    {
+        if (scopes.empty())
+        {
+            throw std::logic_error("no scope to pop");
+        }
+        const Scope scope = scopes.back();
+        scopes.pop_back();
+        equationSystem.pop();
+
+        // The variables eliminated within the scope are free again
+        for (size_t deducedIndex = scope.nDeducedEquations; deducedIndex < nIndexedDeducedEquations; ++deducedIndex)
+        {
+            deducedEquationIndices[deducedEquations[deducedIndex].getVariable()] = notEliminated;
+        }
+        for (size_t assignmentIndex = scope.nAssignments; assignmentIndex < nIndexedAssignments; ++assignmentIndex)
+        {
+            assignmentIndices[assignments[assignmentIndex].variable] = notEliminated;
+        }
+        nIndexedDeducedEquations = std::min(nIndexedDeducedEquations, scope.nDeducedEquations);
+        nIndexedAssignments = std::min(nIndexedAssignments, scope.nAssignments);
+
+        deducedEquations.erase(deducedEquations.begin() + scope.nDeducedEquations, deducedEquations.end());
+        assignments.erase(assignments.begin() + scope.nAssignments, assignments.end());
+        isUnsolvable = scope.isUnsolvable;
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void Solver<NumT, VarT>::requireEliminationEngine() const
+    {
+        if (parameters.engine != SolvingEngine::Elimination)
+        {
+            throw std::logic_error("equations can only be added and retracted with the elimination engine");
+        }
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool Solver<NumT, VarT>::eliminate()
+    {
+        hasEliminationState = true;
+
+        equationSystem.setRowPolicy(parameters.rowPolicy);
+        if (parameters.doUseRowArena)
+        {
+            equationSystem.useRowArena();
+        }
+
         for (unsigned int i = 0;; ++i)
         {
             LOG_DEBUG << "Iteration " << i;
@@ -45,31 +414,57 @@ namespace diophantus
             model::SimplificationResult result = equationSystem.simplify();
             if (result == model::SimplificationResult::Conflict)
             {
-                return std::nullopt;
+                isUnsolvable = true;
+                return false;
             }
             else if (result == model::SimplificationResult::IsEmpty)
             {
                 break;
             }
 
-            model::Equation<NumT>& currentEquation = pickEquation();
+            if (parameters.variableRenumbering.has_value() && equationSystem.getScopeDepth() == 0
+                && 2 * equationSystem.getEliminatedVariableCount() >= equationSystem.getVariableCount())
+            {
+                equationSystem.renumberVariables(parameters.variableRenumbering.value());
+            }
+
+            updatePivotQueue(i == 0);
+            const auto [equationIndex, termIndex] = pickEquation();
 
-            const auto newEquation = deduceNewEquation(currentEquation);
+            auto newEquation = deduceNewEquation(equationIndex, termIndex);
 
             // TODO: Make more expressive
             if (newEquation.getRightSideSum().getTerms().size() == 0)
             {
-                model::Assignment<NumT> assignment{
+                model::Assignment<NumT, VarT> assignment{
                     .variable = newEquation.getVariable(),
                     .value = newEquation.getRightSideConstant()
                 };
                 equationSystem.substitute(assignment);
-                assignments.push_back(assignment);
+
+                // Back propagation works on the original ids, which stay valid across renumberings
+                if (equationSystem.isRenumbered())
+                {
+                    assignment.variable = equationSystem.getVariables()[assignment.variable];
+                }
+                assignments.push_back(std::move(assignment));
+                if (constantTrace != nullptr)
+                {
+                    assignmentRegisters.push_back(constantTrace->getSubstitutedRegister());
+                }
             }
             else
             {
                 equationSystem.substitute(newEquation);
-                deducedEquations.push_back(newEquation);
+                if (equationSystem.isRenumbered())
+                {
+                    newEquation.renameVariables(equationSystem.getVariables());
+                }
+                deducedEquations.push_back(std::move(newEquation));
+                if (constantTrace != nullptr)
+                {
+                    deducedEquationRegisters.push_back(constantTrace->getSubstitutedRegister());
+                }
             }
 
             size_t nEquationsLeft = equationSystem.getEquationCount();
@@ -80,54 +475,76 @@ namespace diophantus
             lastIterationNumberOfEquations = nEquationsLeft;
         }
 
-        LOG_DEBUG << "Resubstituting...";
-
-        backPropagateDeducedEquations();
-
-        LOG_DEBUG << "Extracting solution...";
-        auto solution = getSolutionFromAssignments();
-
-        return solution;
+        return true;
     }
 
-    template <model::numeric::BigInt NumT>
-    model::Equation<NumT>& Solver<NumT>::pickEquation()
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void Solver<NumT, VarT>::updatePivotQueue(bool isFirstIteration)
     {
-        auto& equations = equationSystem.getEquations();
-
-        auto minEquation = equations.begin();
-        NumT minCoefficient = minEquation->getLowestCoefficientTerm().getCoefficient();
-
-        auto eqIterator = minEquation;
+        const auto& equations = equationSystem.getEquations();
 
-        for (uint currentIndex = 0; eqIterator != equations.end(); ++eqIterator, ++currentIndex)
+        if (isFirstIteration)
         {
-            if (eqIterator->getLeftSide().getTerms().size() == 1)
+            pivotQueue.clear();
+            equationSystem.takeChangedEquations();
+            for (size_t equationIndex = 0; equationIndex < equations.size(); ++equationIndex)
             {
-                return *eqIterator;
+                pivotQueue.update(equationIndex, equations[equationIndex]);
             }
+            return;
+        }
 
-            NumT thisMinCoefficient = eqIterator->getLowestCoefficientTerm().getCoefficient();
-            if (thisMinCoefficient.absCmp(minCoefficient) == std::strong_ordering::less)
+        // Follow the removals of the last simplification, where the last equation takes the
+        // place of the removed one
+        for (const auto& removal : equationSystem.getLastRemovals())
+        {
+            pivotQueue.remove(removal.index);
+            if (removal.movedIndex != removal.index)
             {
-                minEquation = eqIterator;
-                minCoefficient = thisMinCoefficient;
+                pivotQueue.move(removal.movedIndex, removal.index);
             }
         }
 
-        return *minEquation;
+        for (size_t equationIndex : equationSystem.takeChangedEquations())
+        {
+            pivotQueue.update(equationIndex, equations[equationIndex]);
+        }
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    typename PivotQueue<NumT, VarT>::Entry Solver<NumT, VarT>::pickEquation() const
+    {
+        return pivotQueue.top();
     }
 
-    template <model::numeric::BigInt NumT>
-    const model::DeducedEquation<NumT> Solver<NumT>::deduceNewEquation(
-        model::Equation<NumT>& currentEquation)
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    model::DeducedEquation<NumT, VarT> Solver<NumT, VarT>::deduceNewEquation(size_t equationIndex, size_t termIndex)
     {
-        const auto& currentTerm = currentEquation.getLowestCoefficientTerm();
+        model::Equation<NumT, VarT>& currentEquation = equationSystem.getEquations()[equationIndex];
+        const auto& currentTerm = currentEquation.getLeftSide().getTerms()[termIndex];
 
         // Ensure that the lowest coefficient is positive
         if (currentTerm.getCoefficient() < 0)
         {
-            currentEquation.invert();
+            equationSystem.invertEquation(equationIndex);
+        }
+
+        // The constant of the deduced equation gets a register of its own, which the following
+        // substitution reads from
+        if (constantTrace != nullptr)
+        {
+            const size_t constantRegister = constantTrace->addRegister();
+            const size_t equationRegister = constantTrace->getEquationRegister(equationIndex);
+            if (currentTerm.getCoefficient() == 1)
+            {
+                constantTrace->copy(constantRegister, equationRegister);
+            }
+            else
+            {
+                constantTrace->copyNegatedSymMod(constantRegister, equationRegister,
+                                                 currentTerm.getCoefficient() + NumT(1));
+            }
+            constantTrace->setSubstitutedRegister(constantRegister);
         }
 
         if (currentTerm.getCoefficient() == 1)
@@ -142,44 +559,83 @@ namespace diophantus
         }
     }
 
-    template <model::numeric::BigInt NumT>
-    void Solver<NumT>::backPropagateDeducedEquations()
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    std::vector<model::Assignment<NumT, VarT>> Solver<NumT, VarT>::backPropagateDeducedEquations()
     {
-        // for (auto& deducedEquation : std::views::reverse(deducedEquations))
-        for (auto de = deducedEquations.rbegin(); de != deducedEquations.rend(); ++de)
-        {
-            // Substitute variables where the value is already known
-            for (const auto& assignment : assignments)
+        std::vector<model::Assignment<NumT, VarT>> allAssignments = assignments;
+
+        // position of the assignment of each variable in allAssignments
+        std::vector<size_t> positions;
+        auto setPosition = [&positions](VarT variable, size_t position) {
+            if (variable >= positions.size())
             {
-                de->substitute(assignment);
+                positions.resize(variable + size_t(1), notEliminated);
             }
+            positions[variable] = position;
+        };
+        for (size_t position = 0; position < allAssignments.size(); ++position)
+        {
+            setPosition(allAssignments[position].variable, position);
+        }
 
-            // Set all other variables in this equation to zero
-            for (const auto& term : de->getRightSideSum().getTerms())
+        for (size_t deducedIndex = deducedEquations.size(); deducedIndex-- > 0;)
+        {
+            const model::DeducedEquation<NumT, VarT>& deducedEquation = deducedEquations[deducedIndex];
+            const size_t deducedRegister = constantTrace != nullptr ? deducedEquationRegisters[deducedIndex] : 0;
+            NumT value = deducedEquation.getRightSideConstant();
+
+            for (const auto& term : deducedEquation.getRightSideSum().getTerms())
             {
-                if (term.getCoefficient() != 0)
+                if (term.getCoefficient() == 0)
                 {
-                    model::Assignment<NumT> zeroAssignment {
-                        .variable = term.getVariable(),
-                        .value = std::move(NumT(0))
-                    };
-                    assignments.push_back(std::move(zeroAssignment));
+                    continue;
+                }
+
+                // Substitute variables where the value is already known
+                const VarT variable = term.getVariable();
+                if (variable < positions.size() && positions[variable] != notEliminated)
+                {
+                    value.addMul(term.getCoefficient(), allAssignments[positions[variable]].value);
+                    if (constantTrace != nullptr)
+                    {
+                        constantTrace->addMultiple(deducedRegister, term.getCoefficient(),
+                                                   assignmentRegisters[positions[variable]]);
+                    }
+                    continue;
+                }
+
+                // Set all other variables in this equation to zero
+                setPosition(variable, allAssignments.size());
+                allAssignments.push_back(model::Assignment<NumT, VarT> {
+                    .variable = variable,
+                    .value = NumT(0)
+                });
+                if (constantTrace != nullptr)
+                {
+                    assignmentRegisters.push_back(constantTrace->getZeroRegister());
                 }
             }
 
             // Set the left hand side variable to the right hand side constant
-            model::Assignment<NumT> varAssignment {
-                .variable = de->getVariable(),
-                .value = de->getRightSideConstant()
-            };
-            assignments.push_back(std::move(varAssignment));
+            setPosition(deducedEquation.getVariable(), allAssignments.size());
+            allAssignments.push_back(model::Assignment<NumT, VarT> {
+                .variable = deducedEquation.getVariable(),
+                .value = std::move(value)
+            });
+            if (constantTrace != nullptr)
+            {
+                assignmentRegisters.push_back(deducedRegister);
+            }
         }
+
+        return allAssignments;
     }
 
-    template <model::numeric::BigInt NumT>
-    const model::Solution<NumT> Solver<NumT>::getSolutionFromAssignments() const
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    model::Solution<NumT, VarT> Solver<NumT, VarT>::getSolutionFromAssignments(
+        const std::vector<model::Assignment<NumT, VarT>>& allAssignments) const
     {
-        std::vector<model::Assignment<NumT>> relevantAssignments;
+        std::vector<model::Assignment<NumT, VarT>> relevantAssignments;
 
         // An assignment is relevant if its variable appears in the original equation system
         auto maxVariableNumber = nOriginalVariables;
@@ -188,12 +644,48 @@ namespace diophantus
         };
 
         // Copy all assignments that are relevant to the original equation
-        std::ranges::copy_if(assignments,
+        std::ranges::copy_if(allAssignments,
                              std::back_inserter(relevantAssignments),
                              isRelevant);
 
-        return model::Solution<NumT> {.assignments = relevantAssignments};
+        return model::Solution<NumT, VarT> {.assignments = std::move(relevantAssignments)};
+    }
+
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    void Solver<NumT, VarT>::indexEliminatedVariables()
+    {
+        auto setIndex = [](std::vector<size_t>& indices, VarT variable, size_t index) {
+            if (variable >= indices.size())
+            {
+                indices.resize(variable + size_t(1), notEliminated);
+            }
+            indices[variable] = index;
+        };
+
+        for (; nIndexedDeducedEquations < deducedEquations.size(); ++nIndexedDeducedEquations)
+        {
+            setIndex(deducedEquationIndices, deducedEquations[nIndexedDeducedEquations].getVariable(),
+                     nIndexedDeducedEquations);
+        }
+        for (; nIndexedAssignments < assignments.size(); ++nIndexedAssignments)
+        {
+            setIndex(assignmentIndices, assignments[nIndexedAssignments].variable, nIndexedAssignments);
+        }
     }
 
-    template class Solver<model::numeric::GmpBigInt>;
+    template class Solver<model::numeric::GmpBigInt, std::uint16_t>;
+    template class Solver<model::numeric::GmpBigInt, std::uint32_t>;
+    template class Solver<model::numeric::GmpBigInt, std::uint64_t>;
+    template class Solver<model::numeric::HybridBigInt, std::uint16_t>;
+    template class Solver<model::numeric::HybridBigInt, std::uint32_t>;
+    template class Solver<model::numeric::HybridBigInt, std::uint64_t>;
+    template class Solver<model::numeric::CheckedInt64, std::uint16_t>;
+    template class Solver<model::numeric::CheckedInt64, std::uint32_t>;
+    template class Solver<model::numeric::CheckedInt64, std::uint64_t>;
+    template class Solver<model::numeric::FixedInt<128>, std::uint16_t>;
+    template class Solver<model::numeric::FixedInt<128>, std::uint32_t>;
+    template class Solver<model::numeric::FixedInt<128>, std::uint64_t>;
+    template class Solver<model::numeric::FixedInt<256>, std::uint16_t>;
+    template class Solver<model::numeric::FixedInt<256>, std::uint32_t>;
+    template class Solver<model::numeric::FixedInt<256>, std::uint64_t>;
 }
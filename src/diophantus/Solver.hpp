@@ -1,22 +1,33 @@
 #pragma once
 
+#include "EliminationPlan.hpp"
+#include "PivotQueue.hpp"
+#include "SolvingEngine.hpp"
+
+#include "model/ConstantTrace.hpp"
 #include "model/DeducedEquation.hpp"
 #include "model/Equation.hpp"
 #include "model/EquationSystem.hpp"
+#include "model/RowPolicy.hpp"
 #include "model/Solution.hpp"
 #include "model/Term.hpp"
+#include "model/ThreadPool.hpp"
 #include "model/Variable.hpp"
+#include "model/VariableOrdering.hpp"
 
 #include "model/numeric/GmpBigInt.hpp"
 #include "model/numeric/BigInt.hpp"
 
 #include <cstddef>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <random>
+#include <vector>
 
 namespace diophantus
 {
-    template <model::numeric::BigInt NumT>
+    template <model::numeric::BigInt NumT, model::VariableId VarT = model::Variable>
     class Solver
     {
         public:
@@ -24,57 +35,257 @@ namespace diophantus
             {
                 // whether to log the progress of the solver during solving
                 bool doShowProgress = false;
+
+                // whether to first attempt solving with overflow-checked 64 bit arithmetic, and
+                // only solve with NumT if an overflow occurs
+                bool doUseFixedWidthArithmetic = false;
+
+                // whether to serve GMP allocations from an arena that is released after solving.
+                // The solver's working state is discarded after solving in this case.
+                bool doUseGmpArena = false;
+
+                // whether to keep the rows of the equation system in a row arena while solving,
+                // see EquationSystem::useRowArena
+                bool doUseRowArena = false;
+
+                // decides whether the rows of the equation system are laid out sparse or dense,
+                // see model::Sum
+                model::RowPolicy rowPolicy = {};
+
+                // if set, the live variables are renumbered densely in this order whenever at
+                // least half of the variable ids belong to eliminated variables, see
+                // EquationSystem::renumberVariables
+                std::optional<model::VariableOrdering> variableRenumbering = std::nullopt;
+
+                // algorithm to solve with. All other parameters only apply to the elimination
+                // engine.
+                SolvingEngine engine = SolvingEngine::Elimination;
+
+                // if set, the row arithmetic of substitutions and simplifications runs on this
+                // pool in iterations that process at least minParallelRows rows, see
+                // EquationSystem::setThreadPool. It is not used together with the GMP arena.
+                std::shared_ptr<model::ThreadPool> threadPool = nullptr;
+                size_t minParallelRows = 256;
             };
 
         public:
-            explicit Solver(const model::EquationSystem<NumT>& equationSystem, const Parameters& parameters = Parameters());
+            /**
+             * @param equationSystem
+             *      The equation system to solve. The solver works on it in place, so callers that
+             *      don't need it anymore should move it in.
+             * @param parameters
+             */
+            explicit Solver(model::EquationSystem<NumT, VarT> equationSystem, const Parameters& parameters = Parameters());
 
             /**
              * Solves the given equation system.
              * @return A solution if the equation system is solvable, nullopt otherwise. 
              */
-            std::optional<model::Solution<NumT>> solve();
+            std::optional<model::Solution<NumT, VarT>> solve();
+
+            /**
+             * Solves the equation system for several right sides at once, by compiling a plan
+             * and solving each right side with it, see compilePlan(). The solver is left
+             * unchanged, and throws std::logic_error under the same conditions as compilePlan().
+             * @param rightSides
+             *      Right side vectors, each with one constant per equation
+             * @return A solution for each right side vector if the equation system is solvable
+             *         with it, nullopt otherwise.
+             */
+            std::vector<std::optional<model::Solution<NumT, VarT>>> solveBatch(
+                const std::vector<std::vector<NumT>>& rightSides) const;
+
+            /**
+             * Compiles the elimination of the equation system into a plan that solves it for
+             * other right sides. The elimination only depends on the left sides, so it runs once,
+             * on the homogeneous equation system, while the arithmetic on the right sides is
+             * recorded. The right sides of the equation system itself are ignored, as are the
+             * engine, fixed-width arithmetic and GMP arena parameters. The elimination runs on a
+             * copy, so the solver is left unchanged. Throws std::logic_error if the solver
+             * already solved its equation system, which consumes it.
+             * @return the plan, which can be saved and loaded by other processes.
+             */
+            EliminationPlan<NumT, VarT> compilePlan() const;
+
+            /**
+             * Adds an equation to the solved equation system, see resolve(). The equation is
+             * rewritten through the deduced equations and assignments of the previous
+             * elimination, so that only its residual in the variables that are still free is
+             * left to eliminate. Throws std::logic_error if the solver does not use the
+             * elimination engine or did not eliminate the equation system before, i.e. if it was
+             * solved with fixed-width arithmetic or in a GMP arena, and std::invalid_argument if the
+             * equation contains a variable that is not part of the original equation system.
+             * @param equation
+             */
+            void addEquation(const model::Equation<NumT, VarT>& equation);
+
+            /**
+             * Solves the equation system with the equations that were added since the last
+             * solve() or resolve(). Only the residuals of the added equations are eliminated.
+             * Throws std::logic_error under the same conditions as addEquation().
+             * @return A solution if the equation system is solvable, nullopt otherwise.
+             */
+            std::optional<model::Solution<NumT, VarT>> resolve();
+
+            /**
+             * Opens a scope for backtracking. The equations that are added after it, and
+             * everything deduced from them, are retracted by the matching pop() at a cost
+             * proportional to the changes since. Variables are not renumbered while a scope is
+             * open. Throws std::logic_error under the same conditions as addEquation().
+             */
+            void push();
+
+            /**
+             * Retracts the equations added since the matching push() and closes its scope.
+             * Throws std::logic_error if no scope is open.
+             */
+            void pop();
 
         private:
             /**
-             * Picks the next equation to process, considering the minimum and maximum
-             * coefficients. If a variable has coefficient 1, the corresponding equation will be
-             * picked. Otherwise the equation containing the highest coefficient will be picked.
-             * @return The next equation to process
+             * Compiles the plan of compilePlan() on the equation system of this solver, whose
+             * right sides have to be zero. The elimination state is used up afterwards.
+             * @return the plan.
+             */
+            EliminationPlan<NumT, VarT> compileHomogeneousPlan();
+
+            /**
+             * Solves the equation system with overflow-checked 64 bit arithmetic.
+             * @param solution
+             *      Receives the result of solving, if no overflow occured.
+             * @return false if an overflow occured and the result has to be discarded.
              */
-            model::Equation<NumT>& pickEquation();
+            bool trySolveFixedWidth(std::optional<model::Solution<NumT, VarT>>& solution);
+
+            /**
+             * Solves the equation system while GMP allocates from an arena.
+             * @return A solution if the equation system is solvable, nullopt otherwise.
+             */
+            std::optional<model::Solution<NumT, VarT>> solveInArena();
+
+            /**
+             * Throws std::logic_error if the solver does not use the elimination engine, which
+             * is the only one that supports adding and retracting equations.
+             */
+            void requireEliminationEngine() const;
+
+            /**
+             * Runs the elimination loop on the equation system.
+             * @return A solution if the equation system is solvable, nullopt otherwise.
+             */
+            std::optional<model::Solution<NumT, VarT>> solveDirectly();
+
+            /**
+             * Eliminates the equations of the equation system until it is empty. The deduced
+             * equations and assignments are kept for later additions, see addEquation().
+             * @return false if the equation system is unsolvable.
+             */
+            bool eliminate();
+
+            /**
+             * Updates the pivot queue with the equations that changed in the last iteration.
+             * @param isFirstIteration
+             *      Whether the queue has to be filled with all equations.
+             */
+            void updatePivotQueue(bool isFirstIteration);
+
+            /**
+             * Picks the next equation to process. Equations with a single term are picked first,
+             * then equations with a coefficient of absolute value 1, and otherwise the equation
+             * with the lowest absolute coefficient.
+             * @return The next equation to process and the position of its lowest coefficient
+             */
+            typename PivotQueue<NumT, VarT>::Entry pickEquation() const;
 
             /**
              * Deduces a new equation from the given equation by solving it for one variable.
-             * @param currentEquation
-             *      The equation to process
+             * @param equationIndex
+             *      Index of the equation to process
+             * @param termIndex
+             *      Position of the term with the lowest absolute coefficient in the equation
              * @return The deduced equation.
              */
-            const model::DeducedEquation<NumT> deduceNewEquation(model::Equation<NumT>& currentEquation);
+            model::DeducedEquation<NumT, VarT> deduceNewEquation(size_t equationIndex, size_t termIndex);
 
             /**
-             * Substitute variables in the equation system by the previously deduced equations.
+             * Evaluates the deduced equations backwards, starting from the assignments of the
+             * elimination. Variables that are still free are set to zero. The deduced equations
+             * and assignments are left unchanged.
+             * @return The assignments of the elimination followed by an assignment for each
+             *         variable of the deduced equations.
              */
-            void backPropagateDeducedEquations();
+            std::vector<model::Assignment<NumT, VarT>> backPropagateDeducedEquations();
 
             /**
              * Creates a solution from the deduced variable assignments.
+             * @param allAssignments
+             *      The result of backPropagateDeducedEquations()
              * @return A solution for the equation system.
              */
-            const model::Solution<NumT> getSolutionFromAssignments() const;
+            model::Solution<NumT, VarT> getSolutionFromAssignments(
+                const std::vector<model::Assignment<NumT, VarT>>& allAssignments) const;
+
+            /**
+             * Extends the index of the variables that were eliminated by deduced equations or
+             * assignments to the ones deduced since the last call.
+             */
+            void indexEliminatedVariables();
 
         private:
+            /**
+             * State of the solver when a scope was opened, see push(). The equation system keeps
+             * its own trail.
+             */
+            struct Scope
+            {
+                size_t nDeducedEquations;
+                size_t nAssignments;
+                bool isUnsolvable;
+            };
+
             const Parameters parameters;
 
-            model::EquationSystem<NumT> equationSystem;
+            model::EquationSystem<NumT, VarT> equationSystem;
             size_t nOriginalVariables;
 
-            std::vector<model::DeducedEquation<NumT>> deducedEquations;
-            std::vector<model::Assignment<NumT>> assignments;
+            std::vector<model::DeducedEquation<NumT, VarT>> deducedEquations;
+            std::vector<model::Assignment<NumT, VarT>> assignments;
+
+            // equations of the system, ordered by their suitability as pivot equation
+            PivotQueue<NumT, VarT> pivotQueue;
 
             size_t nOriginalEquations;
             size_t lastIterationNumberOfEquations;
 
-            
+            // records the arithmetic on the constants while solving in compilePlan, if set
+            model::ConstantTrace<NumT>* constantTrace = nullptr;
+
+            // registers of the constants of the deduced equations and of the assignment values in
+            // the constant trace, indexed like deducedEquations and assignments
+            std::vector<size_t> deducedEquationRegisters;
+            std::vector<size_t> assignmentRegisters;
+
+            // whether deducedEquations and assignments hold a complete elimination of the
+            // equation system, which equations can be added to
+            bool hasEliminationState = false;
+
+            // whether solve() worked on the equation system, which leaves it eliminated or
+            // discarded
+            bool hasSolved = false;
+
+            // whether the elimination ran into a conflict, which added equations can't resolve
+            bool isUnsolvable = false;
+
+            static constexpr size_t notEliminated = std::numeric_limits<size_t>::max();
+
+            // index of the deduced equation or assignment of each variable, indexed by original
+            // id, see indexEliminatedVariables()
+            std::vector<size_t> deducedEquationIndices;
+            std::vector<size_t> assignmentIndices;
+            size_t nIndexedDeducedEquations = 0;
+            size_t nIndexedAssignments = 0;
+
+            // open scopes, innermost last
+            std::vector<Scope> scopes;
     };
 }
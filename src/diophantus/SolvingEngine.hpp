@@ -0,0 +1,16 @@
+#pragma once
+
+namespace diophantus
+{
+    /**
+     * Algorithm that Solver::solve uses to solve an equation system.
+     */
+    enum class SolvingEngine
+    {
+        // Omega-style elimination of one equation at a time
+        Elimination,
+
+        // Hermite normal form of the coefficient matrix, see HermiteSolver
+        HermiteNormalForm
+    };
+}
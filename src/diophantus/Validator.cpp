@@ -1,32 +1,92 @@
 #include "Validator.hpp"
 
-#include "model/SimplificationResult.hpp"
+#include "model/Variable.hpp"
 
 #include "model/numeric/GmpBigInt.hpp"
+#include "model/numeric/HybridBigInt.hpp"
+#include "model/numeric/CheckedInt64.hpp"
+#include "model/numeric/FixedInt.hpp"
 #include "model/numeric/BigInt.hpp"
 
+#include <cstdint>
+#include <vector>
+
 namespace diophantus
 {
-    template <model::numeric::BigInt NumT>
-    Validator<NumT>::Validator(model::EquationSystem<NumT> equationSystem) :
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    Validator<NumT, VarT>::Validator(model::EquationSystem<NumT, VarT> equationSystem) :
         equationSystem(std::move(equationSystem))
     {}
     
-    template <model::numeric::BigInt NumT>
-    bool Validator<NumT>::isValidSolution(model::Solution<NumT> solution)
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool Validator<NumT, VarT>::isValidSolution(const model::Solution<NumT, VarT>& solution) const
     {
-        // Get a copy of the equation system and substitute all assignments in
-        model::EquationSystem<NumT> tmpEquationSystem = equationSystem;
+        return isValidSolution(equationSystem, solution);
+    }
 
+    template <model::numeric::BigInt NumT, model::VariableId VarT>
+    bool Validator<NumT, VarT>::isValidSolution(const model::EquationSystem<NumT, VarT>& equationSystem,
+                                                const model::Solution<NumT, VarT>& solution)
+    {
+        // Look up the values by variable. If a variable is assigned more than once, the first
+        // assignment counts, as it would when substituting the assignments one by one.
+        std::vector<const NumT*> values;
         for (const auto& assignment : solution.assignments)
         {
-            tmpEquationSystem.substitute(assignment);
+            if (assignment.variable >= values.size())
+            {
+                values.resize(assignment.variable + 1, nullptr);
+            }
+            if (values[assignment.variable] == nullptr)
+            {
+                values[assignment.variable] = &assignment.value;
+            }
         }
 
-        // If no equations are left to be solved and there is no conflict, the solution is valid
-        auto result = tmpEquationSystem.simplify();
-        return result == model::SimplificationResult::IsEmpty;
+        // Evaluate the left side of every equation in place, instead of substituting into a
+        // copy of the equation system
+        NumT leftSide(0);
+        for (const auto& equation : equationSystem.getEquations())
+        {
+            leftSide = NumT(0);
+            const auto& sum = equation.getLeftSide();
+            for (size_t i = 0; i < sum.getVariables().size(); ++i)
+            {
+                // Dense rows also list variables with coefficient 0
+                if (sum.getCoefficients()[i] == 0)
+                {
+                    continue;
+                }
+
+                const VarT variable = sum.getVariables()[i];
+                if (variable >= values.size() || values[variable] == nullptr)
+                {
+                    return false;
+                }
+                leftSide.addMul(sum.getCoefficients()[i], *values[variable]);
+            }
+
+            if (leftSide != equation.getRightSide())
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
-    template class Validator<model::numeric::GmpBigInt>;
+    template class Validator<model::numeric::GmpBigInt, std::uint16_t>;
+    template class Validator<model::numeric::GmpBigInt, std::uint32_t>;
+    template class Validator<model::numeric::GmpBigInt, std::uint64_t>;
+    template class Validator<model::numeric::HybridBigInt, std::uint16_t>;
+    template class Validator<model::numeric::HybridBigInt, std::uint32_t>;
+    template class Validator<model::numeric::HybridBigInt, std::uint64_t>;
+    template class Validator<model::numeric::CheckedInt64, std::uint16_t>;
+    template class Validator<model::numeric::CheckedInt64, std::uint32_t>;
+    template class Validator<model::numeric::CheckedInt64, std::uint64_t>;
+    template class Validator<model::numeric::FixedInt<128>, std::uint16_t>;
+    template class Validator<model::numeric::FixedInt<128>, std::uint32_t>;
+    template class Validator<model::numeric::FixedInt<128>, std::uint64_t>;
+    template class Validator<model::numeric::FixedInt<256>, std::uint16_t>;
+    template class Validator<model::numeric::FixedInt<256>, std::uint32_t>;
+    template class Validator<model::numeric::FixedInt<256>, std::uint64_t>;
 }
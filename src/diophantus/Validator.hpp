@@ -7,14 +7,29 @@
 
 namespace diophantus
 {
-    template <model::numeric::BigInt NumT>
+    template <model::numeric::BigInt NumT, model::VariableId VarT = model::Variable>
     class Validator
     {
         public:
-            Validator(model::EquationSystem<NumT> equationSystem);
-            bool isValidSolution(model::Solution<NumT> solution);
+            explicit Validator(model::EquationSystem<NumT, VarT> equationSystem);
+
+            /**
+             * Checks whether a solution satisfies all equations of the equation system.
+             * @param solution
+             * @return true if every variable of the system is assigned and all equations hold.
+             */
+            bool isValidSolution(const model::Solution<NumT, VarT>& solution) const;
+
+            /**
+             * Checks a solution against an equation system without taking a copy of it.
+             * @param equationSystem
+             * @param solution
+             * @return true if every variable of the system is assigned and all equations hold.
+             */
+            static bool isValidSolution(const model::EquationSystem<NumT, VarT>& equationSystem,
+                                        const model::Solution<NumT, VarT>& solution);
 
         private:
-            const model::EquationSystem<NumT> equationSystem;
+            const model::EquationSystem<NumT, VarT> equationSystem;
     };
 }
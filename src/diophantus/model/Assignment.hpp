@@ -10,15 +10,15 @@
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     struct Assignment
     {
-        const Variable variable;
-        const NumT value;
+        VarT variable;
+        NumT value;
     };
 
-    template <numeric::BigInt NumT>
-    std::ostream &operator<<(std::ostream &os, const Assignment<NumT>& assignment)
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::ostream &operator<<(std::ostream &os, const Assignment<NumT, VarT>& assignment)
     {
         os << "x" << assignment.variable << " = " << assignment.value;
         return os;
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "numeric/BigInt.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace diophantus::model
+{
+    /**
+     * Record of the arithmetic that solving an equation system applies to the constants, i.e. to
+     * the right sides of its equations and to the constants of the deduced equations. Which
+     * operations are applied only depends on the left sides, so the record of one solve can be
+     * replayed for other right sides of the same left sides, see EliminationPlan.
+     *
+     * Constants live in registers. Registers 0 to n - 1 hold the right sides of the n original
+     * equations and register n holds zero. Further registers are added for the constants of
+     * deduced equations. The trace follows the removals of the equation system, so that each
+     * equation knows its register.
+     *
+     * Operations whose outcome depends on the constants, like the divisibility check of a
+     * simplification, are recorded as requirements: if one fails when replaying, the equation
+     * system is unsolvable for these right sides.
+     */
+    template <numeric::BigInt NumT>
+    class ConstantTrace
+    {
+        public:
+            // The values are stored in plan files, so new opcodes may only be appended
+            enum class Opcode
+            {
+                Negate,
+                Copy,
+                CopyNegatedSymMod,
+                AddMultiple,
+                SubtractMultiple,
+                DivideExactly,
+                RequireZero,
+                RequireEqual,
+                RequireOpposite
+            };
+
+            /**
+             * Operation on the registers, see the recording methods for the meaning of each
+             * opcode.
+             */
+            struct Operation
+            {
+                Opcode opcode;
+                size_t target;
+                size_t source;
+
+                // factor, modulus or divisor of the operation
+                NumT factor;
+            };
+
+        public:
+            /**
+             * @param nEquations
+             *      Number of equations of the equation system that is solved
+             */
+            explicit ConstantTrace(size_t nEquations) :
+                nRightSides(nEquations),
+                nRegisters(nEquations + 1)
+            {
+                equationRegisters.reserve(nEquations);
+                for (size_t eqIndex = 0; eqIndex < nEquations; ++eqIndex)
+                {
+                    equationRegisters.push_back(eqIndex);
+                }
+            }
+
+            // register that holds the right side of an equation
+            size_t getEquationRegister(size_t eqIndex) const
+            {
+                return equationRegisters[eqIndex];
+            }
+
+            // register that always holds zero
+            size_t getZeroRegister() const
+            {
+                return nRightSides;
+            }
+
+            /**
+             * Follows the removal of an equation, where the last equation takes its place.
+             * @param eqIndex
+             */
+            void removeEquation(size_t eqIndex)
+            {
+                equationRegisters[eqIndex] = equationRegisters.back();
+                equationRegisters.pop_back();
+            }
+
+            /**
+             * Adds a register that holds zero until an operation writes to it.
+             * @return the new register
+             */
+            size_t addRegister()
+            {
+                return nRegisters++;
+            }
+
+            /**
+             * Sets the register of the constant that the following substitutions subtract
+             * multiples of, i.e. the constant of the deduced equation or the value of the
+             * assignment that is substituted.
+             * @param source
+             */
+            void setSubstitutedRegister(size_t source)
+            {
+                substitutedRegister = source;
+            }
+
+            size_t getSubstitutedRegister() const
+            {
+                return substitutedRegister;
+            }
+
+            // target = -target
+            void negate(size_t target)
+            {
+                operations.push_back(Operation{Opcode::Negate, target, target, NumT(0)});
+            }
+
+            // target = source
+            void copy(size_t target, size_t source)
+            {
+                operations.push_back(Operation{Opcode::Copy, target, source, NumT(0)});
+            }
+
+            // target = -symMod(source, modulus)
+            void copyNegatedSymMod(size_t target, size_t source, const NumT& modulus)
+            {
+                operations.push_back(Operation{Opcode::CopyNegatedSymMod, target, source, modulus});
+            }
+
+            // target += factor * source
+            void addMultiple(size_t target, const NumT& factor, size_t source)
+            {
+                operations.push_back(Operation{Opcode::AddMultiple, target, source, factor});
+            }
+
+            // target -= factor * source
+            void subtractMultiple(size_t target, const NumT& factor, size_t source)
+            {
+                operations.push_back(Operation{Opcode::SubtractMultiple, target, source, factor});
+            }
+
+            // target /= divisor, requires that the divisor divides target
+            void divideExactly(size_t target, const NumT& divisor)
+            {
+                operations.push_back(Operation{Opcode::DivideExactly, target, target, divisor});
+            }
+
+            // requires that target == 0
+            void requireZero(size_t target)
+            {
+                operations.push_back(Operation{Opcode::RequireZero, target, target, NumT(0)});
+            }
+
+            // requires that target == source, or target == -source if isOpposite
+            void requireEqual(size_t target, size_t source, bool isOpposite)
+            {
+                operations.push_back(Operation{isOpposite ? Opcode::RequireOpposite : Opcode::RequireEqual,
+                                               target, source, NumT(0)});
+            }
+
+            // number of recorded operations
+            size_t getOperationCount() const
+            {
+                return operations.size();
+            }
+
+            // number of registers
+            size_t getRegisterCount() const
+            {
+                return nRegisters;
+            }
+
+            // number of registers that hold the right sides of the original equations
+            size_t getRightSideCount() const
+            {
+                return nRightSides;
+            }
+
+            // recorded operations, in the order in which they have to be replayed
+            const std::vector<Operation>& getOperations() const
+            {
+                return operations;
+            }
+
+        private:
+            size_t nRightSides;
+            size_t nRegisters;
+
+            // register of each equation, indexed like the equations of the equation system
+            std::vector<size_t> equationRegisters;
+
+            // see setSubstitutedRegister()
+            size_t substitutedRegister = 0;
+
+            std::vector<Operation> operations;
+    };
+}
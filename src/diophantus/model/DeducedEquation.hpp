@@ -8,27 +8,28 @@
 #include "numeric/BigInt.hpp"
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     class DeducedEquation
     {
         public:
-            DeducedEquation(const Variable variable,
-                            const Sum<NumT>& rightSideTerms,
-                            const NumT& rightSideConstant) :
+            DeducedEquation(const VarT variable,
+                            Sum<NumT, VarT> rightSideTerms,
+                            NumT rightSideConstant) :
                 variable(variable),
                 rightSideTerms(std::move(rightSideTerms)),
                 rightSideConstant(std::move(rightSideConstant))
             {}
 
-            Variable getVariable() const
+            VarT getVariable() const
             {
                 return variable;
             }
 
-            const Sum<NumT>& getRightSideSum() const
+            const Sum<NumT, VarT>& getRightSideSum() const
             {
                 return rightSideTerms;
             }
@@ -42,7 +43,7 @@ namespace diophantus::model
              * Adds a term to the right side of the deduced equation.
              * @param term
              */
-            void addTerm(const Term<NumT>& term)
+            void addTerm(const Term<NumT, VarT>& term)
             {
                 rightSideTerms.addTerm(term);
             }
@@ -60,7 +61,7 @@ namespace diophantus::model
              * Sets the constant on the right side of the equation.
              * @param constant
              */
-            void setRightSideConstant(const NumT& constant)
+            void setRightSideConstant(NumT constant)
             {
                 rightSideConstant = std::move(constant);
             }
@@ -69,17 +70,30 @@ namespace diophantus::model
              * Substitutes a variable on the right side of the equation with a given value.
              * @param assignment
              *      Assignment specifying the variable and its value.
+             * @return the coefficient the variable had, or nullopt if it did not occur.
              */
-            void substitute(const Assignment<NumT>& assignment)
+            std::optional<NumT> substitute(const Assignment<NumT, VarT>& assignment)
             {
-                std::optional<NumT> coefficient = rightSideTerms.setCoefficientOfVariableToZero(assignment.variable);
+                std::optional<NumT> coefficient = rightSideTerms.removeTermOfVariable(assignment.variable);
                 if (coefficient != std::nullopt)
                 {
-                    rightSideConstant += coefficient.value() * assignment.value;
+                    rightSideConstant.addMul(coefficient.value(), assignment.value);
                 }
+                return coefficient;
             }
 
-            friend std::ostream& operator<<(std::ostream& os, const DeducedEquation<NumT>& eq)
+            /**
+             * Renames the variables of the deduced equation, see Sum::renameVariables.
+             * @param newVariables
+             *      The new name of each variable, indexed by the current one
+             */
+            void renameVariables(const std::vector<VarT>& newVariables)
+            {
+                variable = newVariables[variable];
+                rightSideTerms.renameVariables(newVariables);
+            }
+
+            friend std::ostream& operator<<(std::ostream& os, const DeducedEquation<NumT, VarT>& eq)
             {
                 os << "x[" << eq.variable << "] = "
                    << eq.rightSideTerms << " + " << eq.rightSideConstant;
@@ -87,8 +101,8 @@ namespace diophantus::model
             }
 
         private:
-            const Variable variable;
-            Sum<NumT> rightSideTerms;
+            VarT variable;
+            Sum<NumT, VarT> rightSideTerms;
             NumT rightSideConstant;
     };
 }
@@ -3,16 +3,22 @@
 #include "diophantus/model/DeducedEquation.hpp"
 #include "diophantus/model/Sum.hpp"
 #include "diophantus/model/Term.hpp"
+#include "diophantus/model/TermReference.hpp"
 #include "diophantus/model/Variable.hpp"
 #include "diophantus/model/numeric/GmpBigInt.hpp"
+#include "diophantus/model/numeric/HybridBigInt.hpp"
+#include "diophantus/model/numeric/CheckedInt64.hpp"
+#include "diophantus/model/numeric/FixedInt.hpp"
 
 #include <common/logging.hpp>
 
 #include <algorithm>
 #include <bits/ranges_algo.h>
+#include <cstdint>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <pstl/glue_execution_defs.h>
 #include <ranges>
@@ -20,64 +26,88 @@
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
-    Equation<NumT>::Equation(const Sum<NumT>& leftSide, const NumT& rightSide) :
+    template <numeric::BigInt NumT, VariableId VarT>
+    Equation<NumT, VarT>::Equation(Sum<NumT, VarT> leftSide, NumT rightSide) :
         leftSide(std::move(leftSide)),
         rightSide(std::move(rightSide))
     {}
 
-    template <numeric::BigInt NumT>
-    Equation<NumT>::Equation(const Sum<NumT>& leftSide, const long rightSide) :
+    template <numeric::BigInt NumT, VariableId VarT>
+    Equation<NumT, VarT>::Equation(Sum<NumT, VarT> leftSide, const long rightSide) :
         leftSide(std::move(leftSide)),
         rightSide(NumT(rightSide))
     {}
 
-    template <numeric::BigInt NumT>
-    SimplificationResult Equation<NumT>::simplify()
+    template <numeric::BigInt NumT, VariableId VarT>
+    Equation<NumT, VarT>::Equation(Equation<NumT, VarT>&& other, std::pmr::memory_resource* resource) :
+        leftSide(std::move(other.leftSide), resource),
+        rightSide(std::move(other.rightSide)),
+        isPrimitive(other.isPrimitive)
+    {}
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    SimplificationResult Equation<NumT, VarT>::simplify()
+    {
+        std::optional<NumT> divisor;
+        return simplify(divisor);
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    SimplificationResult Equation<NumT, VarT>::simplify(std::optional<NumT>& divisor)
     {
+        divisor.reset();
+        if (isPrimitive)
+        {
+            return SimplificationResult::Ok;
+        }
+
         const std::optional<NumT>& gcd = leftSide.simplify();
         if (!gcd)
         {
             return rightSide == 0 ? SimplificationResult::IsEmpty
                                   : SimplificationResult::Conflict;
         }
-        
-        if (rightSide % gcd.value() != 0)
-        {
-            // Equation system is unsolvable
-            return SimplificationResult::Conflict;
-        }
-        else
+
+        if (gcd.value() != 1)
         {
-            rightSide /= gcd.value();
-            leftSide.divideCoefficientsBy(gcd.value());
-            return SimplificationResult::Ok;
+            if (!rightSide.isDivisibleBy(gcd.value()))
+            {
+                // Equation system is unsolvable
+                return SimplificationResult::Conflict;
+            }
+            rightSide.divExact(gcd.value());
+            leftSide.divideCoefficientsExactlyBy(gcd.value());
+            divisor = gcd;
         }
+
+        isPrimitive = true;
+        return SimplificationResult::Ok;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void Equation<NumT, VarT>::invert()
+    {
+        leftSide.negateCoefficients();
+        rightSide.negate();
     }
 
-    template <numeric::BigInt NumT>
-    void Equation<NumT>::invert()
+    template <numeric::BigInt NumT, VariableId VarT>
+    void Equation<NumT, VarT>::applyRowPolicy(const RowPolicy& policy)
     {
-        const NumT minusOne(-1);
-        leftSide.divideCoefficientsBy(minusOne);
-        rightSide *= minusOne;
+        leftSide.applyRowPolicy(policy);
     }
 
-    template <numeric::BigInt NumT>
-    DeducedEquation<NumT> Equation<NumT>::solveFor(const Term<NumT>& term, bool doNormalInversion)
+    template <numeric::BigInt NumT, VariableId VarT>
+    void Equation<NumT, VarT>::renameVariables(const std::vector<VarT>& newVariables)
     {
-        std::vector<Term<NumT>> newTerms;
+        leftSide.renameVariables(newVariables);
+    }
 
+    template <numeric::BigInt NumT, VariableId VarT>
+    DeducedEquation<NumT, VarT> Equation<NumT, VarT>::solveFor(const Term<NumT, VarT>& term, bool doNormalInversion)
+    {
         // Copy all terms that do not have the same variable
-        const auto& variableNumber = term.getVariable();
-        auto isDifferentVariable = [variableNumber](const Term<NumT>& srcTerm)
-        {
-            return (srcTerm.getVariable() != variableNumber);
-        };
-        std::copy_if(std::execution::par,
-                     leftSide.getTerms().begin(), leftSide.getTerms().end(),
-                     std::back_inserter(newTerms),
-                     isDifferentVariable);
+        Sum<NumT, VarT> newSum = leftSide.withoutVariable(term.getVariable());
 
         // Invert coefficients if necessary
         bool coefficientPositive = (term.getCoefficient() > 0);
@@ -85,130 +115,104 @@ namespace diophantus::model
 
         if (doCoefficientInversion)
         {
-            auto invertCoefficient = [](Term<NumT>& newTerm)
-            {
-                newTerm.divideCoefficientBy(NumT(-1));
-                return newTerm;
-            };
-            std::transform(std::execution::par,
-                           newTerms.begin(), newTerms.end(),
-                           newTerms.begin(),
-                           invertCoefficient);
+            newSum.negateCoefficients();
         }
         
         // Create the full new deduced equation
         bool doConstantInversion = not(doNormalInversion) || coefficientPositive;
         NumT newRightSide = doConstantInversion ? rightSide : -rightSide;
-        DeducedEquation<NumT> d(term.getVariable(), Sum<NumT>(newTerms), newRightSide);
+        DeducedEquation<NumT, VarT> d(term.getVariable(), newSum, newRightSide);
 
         return d;
     }
 
-    template <numeric::BigInt NumT>
-    DeducedEquation<NumT> Equation<NumT>::eliminate(const Term<NumT>& term,
-                                                    const Variable newVariable)
+    template <numeric::BigInt NumT, VariableId VarT>
+    DeducedEquation<NumT, VarT> Equation<NumT, VarT>::eliminate(const Term<NumT, VarT>& term,
+                                                                const VarT newVariable)
     {
         NumT modulus(std::move(term.getCoefficient() + NumT(1)));
 
-        DeducedEquation<NumT> newEquation = this->solveFor(term, false);
+        DeducedEquation<NumT, VarT> newEquation = this->solveFor(term, false);
         newEquation.coefficientsModulo(modulus);
-        newEquation.addTerm(Term<NumT>(-modulus, newVariable));
+        newEquation.addTerm(Term<NumT, VarT>(-modulus, newVariable));
         NumT newConstant = -NumT::symMod(newEquation.getRightSideConstant(), modulus);
         newEquation.setRightSideConstant(newConstant);
 
         return newEquation;
     }
 
-    template <numeric::BigInt NumT>
-    void Equation<NumT>::substitute(const DeducedEquation<NumT>& deducedEquation)
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::optional<NumT> Equation<NumT, VarT>::substitute(const DeducedEquation<NumT, VarT>& deducedEquation)
     {
-        std::optional<NumT> varCoefficient = leftSide.setCoefficientOfVariableToZero(deducedEquation.getVariable());
+        // Replace the variable's term by the correspondingly scaled terms of the deduced equation
+        std::optional<NumT> varCoefficient = leftSide.substituteVariable(deducedEquation.getVariable(),
+                                                                         deducedEquation.getRightSideSum());
         if (varCoefficient == std::nullopt)
         {
-            return;
+            return std::nullopt;
         }
 
-        const auto& equationTerms = leftSide.getTerms();
-        const auto& deducedTerms = deducedEquation.getRightSideSum().getTerms();
-
-        // Merge the two lists of terms
-        // TODO: Move implementation of merging to somewhere else (depends on an implementation detail of Sum)
-        auto etIterator = equationTerms.begin();
-        auto dtIterator = deducedTerms.begin();
-        std::vector<Term<NumT>> newTerms;
-
-        while (dtIterator != deducedTerms.end() || etIterator != equationTerms.end())
-        {
-            if (dtIterator != deducedTerms.end() && etIterator != equationTerms.end()
-                && dtIterator->getVariable() == etIterator->getVariable())
-            {
-                NumT coeff{etIterator->getCoefficient()
-                            + dtIterator->getCoefficient() * varCoefficient.value()};
-                if (coeff != 0)
-                {
-                    Term<NumT> term(std::move(coeff), dtIterator->getVariable());
-                    newTerms.push_back(std::move(term));
-                }
-                ++dtIterator;
-                ++etIterator;
-            }
-            else if(dtIterator != deducedTerms.end() && (etIterator == equationTerms.end()
-                || dtIterator->getVariable() < etIterator->getVariable()))
-            {
-                Term<NumT> term(dtIterator->getCoefficient() * varCoefficient.value(),
-                                dtIterator->getVariable());
-                newTerms.push_back(std::move(term));
-                ++dtIterator;
-            }
-            else if (etIterator != equationTerms.end())
-            {
-                if (etIterator->getCoefficient() != 0)
-                {
-                    newTerms.push_back(std::move(*etIterator));
-                }
-                ++etIterator;
-            }
-        }
-        
-        // Update equation
-        leftSide = Sum<NumT>(newTerms);
-        rightSide -= varCoefficient.value() * deducedEquation.getRightSideConstant();
+        isPrimitive = false;
+        rightSide.subMul(varCoefficient.value(), deducedEquation.getRightSideConstant());
+        return varCoefficient;
     }
 
-    template <numeric::BigInt NumT>
-    void Equation<NumT>::substitute(const Assignment<NumT>& assignment)
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::optional<NumT> Equation<NumT, VarT>::substitute(const Assignment<NumT, VarT>& assignment)
     {
-        std::optional<NumT> coefficient = leftSide.setCoefficientOfVariableToZero(assignment.variable);
+        std::optional<NumT> coefficient = leftSide.removeTermOfVariable(assignment.variable);
         if (coefficient == std::nullopt)
         {
-            return;
+            return std::nullopt;
         }
-        rightSide -= coefficient.value() * assignment.value;
+        isPrimitive = false;
+        rightSide.subMul(coefficient.value(), assignment.value);
+        return coefficient;
     }
 
-    template <numeric::BigInt NumT>
-    const Term<NumT>& Equation<NumT>::getLowestCoefficientTerm() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    TermReference<NumT, VarT> Equation<NumT, VarT>::getLowestCoefficientTerm() const
     {
         return leftSide.getLowestCoefficientTerm();
     }
 
-    template <numeric::BigInt NumT>
-    const Term<NumT>& Equation<NumT>::getHighestCoefficientTerm() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    TermReference<NumT, VarT> Equation<NumT, VarT>::getHighestCoefficientTerm() const
     {
         return leftSide.getHighestCoefficientTerm();
     }
 
-    template <numeric::BigInt NumT>
-    const Sum<NumT>& Equation<NumT>::getLeftSide() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    const Sum<NumT, VarT>& Equation<NumT, VarT>::getLeftSide() const
     {
         return leftSide;
     }
 
-    template <numeric::BigInt NumT>
-    const NumT& Equation<NumT>::getRightSide() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    const NumT& Equation<NumT, VarT>::getRightSide() const
     {
         return rightSide;
     }
 
-    template class Equation<numeric::GmpBigInt>;
+    template <numeric::BigInt NumT, VariableId VarT>
+    bool Equation<NumT, VarT>::isDirty() const
+    {
+        return !isPrimitive;
+    }
+
+    template class Equation<numeric::GmpBigInt, std::uint16_t>;
+    template class Equation<numeric::GmpBigInt, std::uint32_t>;
+    template class Equation<numeric::GmpBigInt, std::uint64_t>;
+    template class Equation<numeric::HybridBigInt, std::uint16_t>;
+    template class Equation<numeric::HybridBigInt, std::uint32_t>;
+    template class Equation<numeric::HybridBigInt, std::uint64_t>;
+    template class Equation<numeric::CheckedInt64, std::uint16_t>;
+    template class Equation<numeric::CheckedInt64, std::uint32_t>;
+    template class Equation<numeric::CheckedInt64, std::uint64_t>;
+    template class Equation<numeric::FixedInt<128>, std::uint16_t>;
+    template class Equation<numeric::FixedInt<128>, std::uint32_t>;
+    template class Equation<numeric::FixedInt<128>, std::uint64_t>;
+    template class Equation<numeric::FixedInt<256>, std::uint16_t>;
+    template class Equation<numeric::FixedInt<256>, std::uint32_t>;
+    template class Equation<numeric::FixedInt<256>, std::uint64_t>;
 }
@@ -2,21 +2,25 @@
 
 #include "Assignment.hpp"
 #include "DeducedEquation.hpp"
+#include "RowPolicy.hpp"
 #include "SimplificationResult.hpp"
 #include "Sum.hpp"
 #include "Term.hpp"
+#include "TermReference.hpp"
 #include "Variable.hpp"
 
 #include "numeric/BigInt.hpp"
 #include "numeric/GmpBigInt.hpp"
 
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <ostream>
 #include <vector>
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     class Equation
     {
         public:
@@ -26,34 +30,64 @@ namespace diophantus::model
              * @param rightSide
              *      The constant on the right side of the equation
              */
-            Equation(const Sum<NumT>& leftSide, const NumT& rightSide);
+            Equation(Sum<NumT, VarT> leftSide, NumT rightSide);
 
-            Equation(const Sum<NumT>& leftSide, const long rightSide);
+            Equation(Sum<NumT, VarT> leftSide, const long rightSide);
+
+            /**
+             * Moves an equation into storage from the given memory resource, see Sum.
+             * @param other
+             * @param resource
+             */
+            Equation(Equation<NumT, VarT>&& other, std::pmr::memory_resource* resource);
 
             /**
              * Simplify the equation by dividing both sides by the GCD g of all coefficients.
+             * Equations that are already primitive, i.e. g = 1, are not processed again until
+             * they are changed by a substitution.
              * @return false if equation has no solution, i.e. g doesn't divide the right side.
              */
             SimplificationResult simplify();
 
+            /**
+             * Simplifies the equation like simplify().
+             * @param divisor
+             *      Receives g if both sides were divided by it, and is reset otherwise.
+             * @return see simplify()
+             */
+            SimplificationResult simplify(std::optional<NumT>& divisor);
+
             /**
              * Invert the equation by multiplying both sides with -1
              */
             void invert();
 
+            /**
+             * Chooses the layout of the left side according to a row policy, see Sum.
+             * @param policy
+             */
+            void applyRowPolicy(const RowPolicy& policy);
+
+            /**
+             * Renames the variables of the left side, see Sum::renameVariables.
+             * @param newVariables
+             *      The new name of each variable, indexed by the current one
+             */
+            void renameVariables(const std::vector<VarT>& newVariables);
+
             /**
              * Determines the term with the lowest coefficient in the equation.
              * 
              * @return The term containing the lowest coefficient
              */
-            const Term<NumT>& getLowestCoefficientTerm() const;
+            TermReference<NumT, VarT> getLowestCoefficientTerm() const;
 
             /**
              * Determines the term with the highest coefficient in the equation.
              * 
              * @return The term containing the highest coefficient
              */
-            const Term<NumT>& getHighestCoefficientTerm() const;
+            TermReference<NumT, VarT> getHighestCoefficientTerm() const;
             
             /**
              * Solve the equation for a given variable as if that variable's coefficient was 1.
@@ -64,7 +98,7 @@ namespace diophantus::model
              *      will switch their sign. If false, change of sign is ignored.
              * @returns a deduced equation  TODO:
              */
-            DeducedEquation<NumT> solveFor(const Term<NumT>& term, bool doNormalInversion = true);
+            DeducedEquation<NumT, VarT> solveFor(const Term<NumT, VarT>& term, bool doNormalInversion = true);
 
             /**
              * Solve the equation for a given variable and introduce a new variable, in order to
@@ -75,35 +109,43 @@ namespace diophantus::model
              *      The new variable to introduce
              * @returns a deduced equation relating the old and new variable to each other.
              */
-            DeducedEquation<NumT> eliminate(const Term<NumT>& term,
-                                            const Variable newVariable);
+            DeducedEquation<NumT, VarT> eliminate(const Term<NumT, VarT>& term,
+                                                  const VarT newVariable);
 
             /**
              * Substitute a variable in the equation by an expression (sum).
              * @param deducedEquation
              *      The equation to use for substitution.
+             * @return the coefficient the variable had, or nullopt if it did not occur.
              */
-            void substitute(const DeducedEquation<NumT>& deducedEquation);
+            std::optional<NumT> substitute(const DeducedEquation<NumT, VarT>& deducedEquation);
 
             /**
              * Substitute a variable in the equation by a constant.
              * @param assignment
              *      The assignment to use for substitution.
+             * @return the coefficient the variable had, or nullopt if it did not occur.
              */
-            void substitute(const Assignment<NumT>& assignment);
+            std::optional<NumT> substitute(const Assignment<NumT, VarT>& assignment);
 
 
-            friend std::ostream& operator<<(std::ostream& os, const Equation<NumT>& eq)
+            friend std::ostream& operator<<(std::ostream& os, const Equation<NumT, VarT>& eq)
             {
                 os << eq.leftSide << " = " << eq.rightSide;
                 return os;
             }
 
-            const Sum<NumT>& getLeftSide() const;
+            const Sum<NumT, VarT>& getLeftSide() const;
             const NumT& getRightSide() const;
 
+            // whether the equation was changed by a substitution since it was last simplified
+            bool isDirty() const;
+
         private:
-            Sum<NumT> leftSide;
+            Sum<NumT, VarT> leftSide;
             NumT rightSide;
+
+            // whether the coefficients are known to have no common divisor other than 1
+            bool isPrimitive = false;
     };
 }
@@ -1,9 +1,16 @@
 #pragma once
 
 #include "Assignment.hpp"
+#include "ConstantTrace.hpp"
 #include "DeducedEquation.hpp"
 #include "Equation.hpp"
+#include "RowArena.hpp"
+#include "RowPolicy.hpp"
 #include "SimplificationResult.hpp"
+#include "Sum.hpp"
+#include "Term.hpp"
+#include "ThreadPool.hpp"
+#include "VariableOrdering.hpp"
 
 #include "numeric/GmpBigInt.hpp"
 #include "numeric/BigInt.hpp"
@@ -12,52 +19,200 @@
 
 #include <algorithm>
 #include <execution>
+#include <functional>
+#include <limits>
 #include <list>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <pstl/glue_execution_defs.h>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     class EquationSystem
     {
         public:
-            EquationSystem(const std::vector<Variable>& variables,
-                           const std::vector<Equation<NumT>>& equations);
+            EquationSystem(std::vector<VarT> variables,
+                           std::vector<Equation<NumT, VarT>> equations);
 
-            std::vector<Equation<NumT>>& getEquations();
+            std::vector<Equation<NumT, VarT>>& getEquations();
+            const std::vector<Equation<NumT, VarT>>& getEquations() const;
+            // original ids of the variables, indexed by their current id, see renumberVariables()
+            const std::vector<VarT>& getVariables() const;
 
-            unsigned int getVariableCount() const;
+            size_t getVariableCount() const;
             size_t getEquationCount() const;
 
             /**
-             * Creates a new variable for use in the equation system.
+             * Determines the equations that may contain a variable. The list contains every equation
+             * with the variable, but may also contain equations in which the variable cancelled out.
+             * @param variable
+             * @return indices of the equations in getEquations()
+             */
+            const std::vector<size_t>& getOccurrences(const VarT variable);
+
+            /**
+             * Determines the equations whose left side was changed by substitutions or
+             * simplification since the last call, and forgets them.
+             * @return indices of the changed equations in getEquations(), possibly repeated
+             */
+            std::vector<size_t> takeChangedEquations();
+
+            /**
+             * Removal of an equation. The last equation is moved into the place of the removed one.
+             */
+            struct Removal
+            {
+                // index of the removed equation
+                size_t index;
+
+                // previous index of the equation that took its place, equal to index if the
+                // removed equation was the last one
+                size_t movedIndex;
+            };
+
+            /**
+             * Determines how the last simplify() removed equations.
+             * @return The removals in the order in which they were applied.
+             */
+            const std::vector<Removal>& getLastRemovals() const;
+
+            /**
+             * Adds an equation. Its variables are given by their original ids, see
+             * renumberVariables(). Variables that were dropped by a renumbering get a new id.
+             * Throws std::invalid_argument if the equation contains a variable that was never
+             * part of the equation system.
+             * @param equation
+             */
+            void addEquation(const Equation<NumT, VarT>& equation);
+
+            /**
+             * Removes all equations. Open scopes are discarded.
+             */
+            void clear();
+
+            /**
+             * Opens a scope. All changes to the equation system are recorded on a trail of undo
+             * records from now on, so that pop() can revert them at a cost proportional to the
+             * changes. Variables can't be renumbered while a scope is open, and scopes can't be
+             * combined with a constant trace.
+             */
+            void push();
+
+            /**
+             * Reverts all changes since the matching push() and closes its scope. The equations
+             * get their rows back, but their order in getEquations() and the occurrence lists may
+             * differ from before. Throws std::logic_error if no scope is open.
+             */
+            void pop();
+
+            // number of open scopes
+            size_t getScopeDepth() const;
+
+            // number of undo records that pop() would revert, summed over all open scopes
+            size_t getTrailSize() const;
+
+            /**
+             * Moves the rows of all equations into a row arena owned by the equation system, so
+             * that they are packed into a few large buffers. Whenever simplification leaves less
+             * than half of the arena in use, the rows are compacted into a fresh arena.
+             */
+            void useRowArena();
+
+            // the row arena, or nullptr if the rows allocate from the default heap
+            const RowArena* getRowArena() const;
+
+            /**
+             * Sets the policy that decides the layout of the rows, see Sum. It is applied to all
+             * equations right away, and to every equation that is simplified later on.
+             * @param policy
+             */
+            void setRowPolicy(const RowPolicy& policy);
+
+            /**
+             * Records the arithmetic on the right sides of all following substitutions and
+             * simplifications in a trace, see ConstantTrace. The trace must have been created for
+             * the current equations, and has to outlive the equation system or be unset again.
+             * @param trace
+             *      The trace to record in, or nullptr to stop recording
+             */
+            void setConstantTrace(ConstantTrace<NumT>* trace);
+
+            /**
+             * Runs the row arithmetic of substitute() and simplify() on a thread pool whenever
+             * they process enough rows at once. Everything else, like the occurrence lists, the
+             * duplicate index and the constant trace, is updated on the calling thread in the
+             * same order as without a pool, so the results don't depend on it. Rows in a row
+             * arena are always processed on the calling thread. The pool has to outlive the
+             * equation system or be unset again.
+             * @param pool
+             *      The thread pool, or nullptr to process all rows on the calling thread
+             * @param minParallelRows
+             *      Number of rows below which a phase is not worth distributing
+             */
+            void setThreadPool(ThreadPool* pool, size_t minParallelRows);
+
+            /**
+             * Creates a new variable for use in the equation system. Throws std::overflow_error if
+             * the new variable can not be represented by the variable id type.
              * @return pointer to the newly created variable
              */
-            Variable addNewVariable();
+            VarT addNewVariable();
 
             /**
-             * Substitute a variable by applying an assignment to all equations.
+             * Renumbers the variables that still occur in some equation densely from 0, so that
+             * the ids of eliminated variables are reclaimed. Each variable keeps its original id,
+             * i.e. the id it was created with, in getVariables(). All equations are reported as
+             * changed, since the order of their terms may change.
+             * @param ordering
+             *      The order of the renumbered variables
+             */
+            void renumberVariables(VariableOrdering ordering);
+
+            // whether the variables were renumbered, so that their ids may differ from the original ids
+            bool isRenumbered() const;
+
+            // number of variables eliminated by substitutions since the last renumbering
+            size_t getEliminatedVariableCount() const;
+
+            /**
+             * Inverts an equation in place, see Equation::invert. The previous row is recorded for
+             * pop(), and the negation of the right side for the constant trace.
+             * @param eqIndex
+             */
+            void invertEquation(size_t eqIndex);
+
+            /**
+             * Substitute a variable by applying an assignment to all equations that contain it.
              * @param assignment
              *      The assignment used for substitution
              */
-            void substitute(const Assignment<NumT>& assignment);
+            void substitute(const Assignment<NumT, VarT>& assignment);
 
             /**
-             * Substitute a variable by a deduced equation, for all equations.
+             * Substitute a variable by a deduced equation, for all equations that contain it.
              * @param deducedEquation
              *      The deduced equation used for substitution
              */
-            void substitute(const DeducedEquation<NumT>& deducedEquation);
+            void substitute(const DeducedEquation<NumT, VarT>& deducedEquation);
 
             /**
              * Simplify the equation system by deleting duplicate equations and simplifying all
-             * other equations.
+             * other equations. Only equations that changed since the last simplification are
+             * processed, and empty equations are replaced by the last equation.
+             *
+             * Equations are duplicates if they are equal after division by the gcd of their
+             * coefficients, up to their sign. If two such equations have different right sides,
+             * the equation system is unsolvable.
              */
             SimplificationResult simplify();
 
-            friend std::ostream& operator<<(std::ostream& os, const EquationSystem<NumT>& system)
+            friend std::ostream& operator<<(std::ostream& os, const EquationSystem<NumT, VarT>& system)
             {
                 if (system.equations.empty())
                 {
@@ -79,88 +234,1064 @@ namespace diophantus::model
             }
 
         private:
-            std::vector<Variable> variables;
-            std::vector<Equation<NumT>> equations;
+            /**
+             * Rebuilds the occurrence lists of all variables from the equations.
+             */
+            void buildOccurrences();
+
+            /**
+             * Moves the rows of all equations into a fresh row arena and releases the previous
+             * one. The order of the equations is kept.
+             */
+            void compactRows();
+
+            /**
+             * Orders the live variables by reverse Cuthill-McKee: a breadth-first search through
+             * the equations, which visits the neighbours of each variable by increasing number of
+             * equations, starting each connected component at a variable with the fewest
+             * equations. The resulting order is reversed.
+             * @param equationsOfVariables
+             *      The equations of each variable
+             * @return the live variables in their new order
+             */
+            std::vector<VarT> orderByReverseCuthillMcKee(
+                const std::vector<std::vector<size_t>>& equationsOfVariables) const;
+
+            /**
+             * Removes an equation by moving the last equation into its place, and updates the
+             * occurrence lists, the changed equations and the duplicate index accordingly.
+             * @param eqIndex
+             */
+            void removeEquation(size_t eqIndex);
+
+            /**
+             * Looks up a simplified equation in the index of simplified equations, and adds it if
+             * there is no equation with the same left side yet.
+             * @param eqIndex
+             * @return Ok if the equation was added, IsEmpty if it duplicates an indexed equation,
+             *         Conflict if an indexed equation has the same left side but a different
+             *         right side.
+             */
+            SimplificationResult indexSimplifiedEquation(size_t eqIndex);
+
+            /**
+             * Records the row of an equation on the trail before it is changed, if a scope is open
+             * and the row was not recorded since the innermost scope was opened. pop() only needs
+             * the earliest row within the scope.
+             * @param eqIndex
+             */
+            void saveEquation(size_t eqIndex);
+
+            /**
+             * Removes an equation from the index of simplified equations, if it is indexed.
+             * @param eqIndex
+             */
+            void unindexEquation(size_t eqIndex);
+
+            /**
+             * Determines the equations that contain a variable, each once and in the order of its
+             * occurrence list, and marks them as dirty and changed before they are substituted.
+             * @param variable
+             * @param eqIndices
+             *      Receives the indices of the equations
+             */
+            void collectSubstitutedEquations(VarT variable, std::vector<size_t>& eqIndices);
+
+            /**
+             * Calls processRow(i) for all i < nRows, on the thread pool if there are enough rows.
+             * The calls must only touch the row they are given.
+             * @param nRows
+             * @param processRow
+             */
+            template <typename Function>
+            void forEachRow(size_t nRows, const Function& processRow);
+
+        private:
+            /**
+             * Change of the equation system within a scope, see push().
+             */
+            struct UndoRecord
+            {
+                enum class Kind
+                {
+                    AddEquation,
+                    ChangeEquation,
+                    RemoveEquation,
+                    AddVariable
+                };
+
+                Kind kind;
+
+                // index of the equation, and for removals the previous index of the equation that
+                // took its place
+                size_t index = 0;
+                size_t movedIndex = 0;
+
+                // previous row of a changed or removed equation, copied to the default heap so
+                // that it survives compactions of the row arena
+                std::optional<Equation<NumT, VarT>> equation = std::nullopt;
+
+                // previous save stamp of a changed or removed equation, see saveStamps
+                size_t saveStamp = 0;
+            };
+
+            /**
+             * State of the equation system when a scope was opened, besides the trail.
+             */
+            struct Scope
+            {
+                // unique among all scopes of the equation system, see saveStamps
+                size_t stamp;
+                size_t trailSize;
+                size_t nextOriginalVariable;
+                size_t nEliminatedVariables;
+            };
+
+            /**
+             * Owner of the row arena. Copies of an equation system don't share the arena, their
+             * rows allocate from the default heap.
+             */
+            struct RowArenaOwner
+            {
+                RowArenaOwner() = default;
+                RowArenaOwner(const RowArenaOwner&) {}
+                RowArenaOwner(RowArenaOwner&&) = default;
+
+                // Replacing the arena would release rows that are still in use
+                RowArenaOwner& operator=(const RowArenaOwner&) = delete;
+                RowArenaOwner& operator=(RowArenaOwner&&) = delete;
+
+                std::unique_ptr<RowArena> arena;
+            };
+
+            // must be declared before the equations, so that it outlives their rows
+            RowArenaOwner rowArenaOwner;
+
+            std::vector<VarT> variables;
+            std::vector<Equation<NumT, VarT>> equations;
+
+            // original id of the next new variable
+            size_t nextOriginalVariable;
+
+            // see isRenumbered() and getEliminatedVariableCount()
+            bool hasRenumberedVariables = false;
+            size_t nEliminatedVariables = 0;
+
+            // current id of each original id that has one, only kept once the variables were
+            // renumbered
+            std::unordered_map<VarT, VarT> currentVariables;
+
+            // for each variable, the indices of the equations that (may) contain it
+            std::vector<std::vector<size_t>> occurrences;
+
+            // equations changed since the last takeChangedEquations()
+            std::vector<size_t> changedEquations;
+
+            // decides the layout of the rows
+            RowPolicy rowPolicy;
+
+            // records the arithmetic on the right sides, if set
+            ConstantTrace<NumT>* constantTrace = nullptr;
+
+            // runs the row arithmetic if set, see setThreadPool()
+            ThreadPool* threadPool = nullptr;
+            size_t minParallelRows = 0;
+
+            // equations that have to be simplified, each listed once
+            std::vector<size_t> dirtyEquations;
+
+            // equations removed by the last simplify()
+            std::vector<Removal> lastRemovals;
+
+            // simplified equations by the hash of their left side, see Sum::hashUpToSign
+            std::unordered_multimap<size_t, size_t> equationsByHash;
+
+            // for each equation, its hash if it is in equationsByHash
+            std::vector<std::optional<size_t>> equationHashes;
+
+            // open scopes, innermost last, and the undo records of all of them
+            std::vector<Scope> scopes;
+            std::vector<UndoRecord> trail;
+
+            // for each equation, the stamp of the scope in which its row was last recorded on the
+            // trail, or 0 if it never was
+            std::vector<size_t> saveStamps;
+
+            // number of scopes opened so far, which stamps the next scope
+            size_t nOpenedScopes = 0;
     };
 }
 
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
-    EquationSystem<NumT>::EquationSystem(const std::vector<Variable>& variables,
-                                         const std::vector<Equation<NumT>>& equations) :
+    template <numeric::BigInt NumT, VariableId VarT>
+    EquationSystem<NumT, VarT>::EquationSystem(std::vector<VarT> variables,
+                                               std::vector<Equation<NumT, VarT>> equations) :
         variables(std::move(variables)),
-        equations(std::move(equations))
-    {}
+        equations(std::move(equations)),
+        nextOriginalVariable(this->variables.empty() ? 0 : std::ranges::max(this->variables) + size_t(1))
+    {
+        buildOccurrences();
+        equationHashes.resize(this->equations.size());
+        saveStamps.resize(this->equations.size());
+        for (size_t eqIndex = 0; eqIndex < this->equations.size(); ++eqIndex)
+        {
+            if (this->equations[eqIndex].isDirty())
+            {
+                dirtyEquations.push_back(eqIndex);
+            }
+        }
+    }
 
-    template <numeric::BigInt NumT>
-    std::vector<Equation<NumT>>& EquationSystem<NumT>::getEquations()
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::vector<Equation<NumT, VarT>>& EquationSystem<NumT, VarT>::getEquations()
     {
         return equations;
     }
 
-    template <numeric::BigInt NumT>
-    unsigned int EquationSystem<NumT>::getVariableCount() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    const std::vector<Equation<NumT, VarT>>& EquationSystem<NumT, VarT>::getEquations() const
+    {
+        return equations;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    const std::vector<VarT>& EquationSystem<NumT, VarT>::getVariables() const
+    {
+        return variables;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    size_t EquationSystem<NumT, VarT>::getVariableCount() const
     {
         return variables.size();
     }
 
-    template <numeric::BigInt NumT>
-    size_t EquationSystem<NumT>::getEquationCount() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    size_t EquationSystem<NumT, VarT>::getEquationCount() const
     {
         return equations.size();
     }
 
-    template <numeric::BigInt NumT>
-    Variable EquationSystem<NumT>::addNewVariable()
+    template <numeric::BigInt NumT, VariableId VarT>
+    const std::vector<size_t>& EquationSystem<NumT, VarT>::getOccurrences(const VarT variable)
+    {
+        if (variable >= occurrences.size())
+        {
+            occurrences.resize(variable + 1);
+        }
+        return occurrences[variable];
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::vector<size_t> EquationSystem<NumT, VarT>::takeChangedEquations()
+    {
+        return std::exchange(changedEquations, {});
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    const std::vector<typename EquationSystem<NumT, VarT>::Removal>& EquationSystem<NumT, VarT>::getLastRemovals() const
+    {
+        return lastRemovals;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::addEquation(const Equation<NumT, VarT>& equation)
+    {
+        // Map the original ids to the current ones
+        std::vector<Term<NumT, VarT>> terms;
+        terms.reserve(equation.getLeftSide().getTermCount());
+        for (const auto& term : equation.getLeftSide().getTerms())
+        {
+            if (term.getCoefficient() == 0)
+            {
+                continue;
+            }
+
+            const VarT variable = term.getVariable();
+            if (variable >= nextOriginalVariable)
+            {
+                throw std::invalid_argument("unknown variable x[" + std::to_string(variable) + "]");
+            }
+            if (!hasRenumberedVariables)
+            {
+                terms.emplace_back(term.getCoefficient(), variable);
+                continue;
+            }
+
+            auto [it, isDropped] = currentVariables.try_emplace(variable, variables.size());
+            if (isDropped)
+            {
+                variables.push_back(variable);
+                if (!scopes.empty())
+                {
+                    trail.push_back(UndoRecord{.kind = UndoRecord::Kind::AddVariable});
+                }
+            }
+            terms.emplace_back(term.getCoefficient(), it->second);
+        }
+
+        const size_t eqIndex = equations.size();
+        Equation<NumT, VarT> currentEquation(Sum<NumT, VarT>(terms), equation.getRightSide());
+        currentEquation.applyRowPolicy(rowPolicy);
+        if (rowArenaOwner.arena != nullptr)
+        {
+            equations.emplace_back(std::move(currentEquation), rowArenaOwner.arena.get());
+        }
+        else
+        {
+            equations.push_back(std::move(currentEquation));
+        }
+        equationHashes.emplace_back();
+
+        // Pop removes an added equation entirely, so its rows never need to be recorded
+        saveStamps.push_back(scopes.empty() ? 0 : scopes.back().stamp);
+
+        for (VarT variable : equations[eqIndex].getLeftSide().getVariables())
+        {
+            getOccurrences(variable);
+            occurrences[variable].push_back(eqIndex);
+        }
+        if (equations[eqIndex].isDirty())
+        {
+            dirtyEquations.push_back(eqIndex);
+        }
+        changedEquations.push_back(eqIndex);
+
+        if (!scopes.empty())
+        {
+            trail.push_back(UndoRecord{.kind = UndoRecord::Kind::AddEquation, .index = eqIndex});
+        }
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::clear()
+    {
+        equations.clear();
+        occurrences.clear();
+        changedEquations.clear();
+        dirtyEquations.clear();
+        lastRemovals.clear();
+        equationsByHash.clear();
+        equationHashes.clear();
+        scopes.clear();
+        trail.clear();
+        saveStamps.clear();
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::push()
+    {
+        scopes.push_back(Scope {
+            .stamp = ++nOpenedScopes,
+            .trailSize = trail.size(),
+            .nextOriginalVariable = nextOriginalVariable,
+            .nEliminatedVariables = nEliminatedVariables
+        });
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::pop()
+    {
+        if (scopes.empty())
+        {
+            throw std::logic_error("no scope to pop");
+        }
+        const Scope scope = scopes.back();
+        scopes.pop_back();
+
+        // Undo the changes in reverse, so that every record finds the state it was made in
+        std::vector<size_t> restoredEquations;
+        while (trail.size() > scope.trailSize)
+        {
+            UndoRecord& record = trail.back();
+            switch (record.kind)
+            {
+                case UndoRecord::Kind::AddEquation:
+                    unindexEquation(equations.size() - 1);
+                    equations.pop_back();
+                    equationHashes.pop_back();
+                    saveStamps.pop_back();
+                    break;
+
+                case UndoRecord::Kind::ChangeEquation:
+                    unindexEquation(record.index);
+                    equations[record.index] = std::move(record.equation.value());
+                    saveStamps[record.index] = record.saveStamp;
+                    restoredEquations.push_back(record.index);
+                    break;
+
+                case UndoRecord::Kind::RemoveEquation:
+                    if (record.index != record.movedIndex)
+                    {
+                        unindexEquation(record.index);
+                        equations.push_back(std::move(equations[record.index]));
+                        equations[record.index] = std::move(record.equation.value());
+                        saveStamps.push_back(saveStamps[record.index]);
+                        saveStamps[record.index] = record.saveStamp;
+                        restoredEquations.push_back(record.movedIndex);
+                    }
+                    else
+                    {
+                        equations.push_back(std::move(record.equation.value()));
+                        saveStamps.push_back(record.saveStamp);
+                    }
+                    equationHashes.emplace_back();
+                    restoredEquations.push_back(record.index);
+                    break;
+
+                case UndoRecord::Kind::AddVariable:
+                    if (hasRenumberedVariables)
+                    {
+                        currentVariables.erase(variables.back());
+                    }
+                    variables.pop_back();
+                    break;
+            }
+            trail.pop_back();
+        }
+        nextOriginalVariable = scope.nextOriginalVariable;
+        nEliminatedVariables = scope.nEliminatedVariables;
+
+        // Forget the equations that don't exist anymore
+        auto isRemoved = [this](size_t eqIndex) {
+            return eqIndex >= equations.size();
+        };
+        std::erase_if(changedEquations, isRemoved);
+        std::erase_if(restoredEquations, isRemoved);
+        std::erase_if(dirtyEquations, [this](size_t eqIndex) {
+            return eqIndex >= equations.size() || !equations[eqIndex].isDirty();
+        });
+        lastRemovals.clear();
+        if (occurrences.size() > variables.size())
+        {
+            occurrences.resize(variables.size());
+        }
+
+        // Restored equations are either dirty or simplified and indexed, like all others
+        std::ranges::sort(restoredEquations);
+        const auto [first, last] = std::ranges::unique(restoredEquations);
+        restoredEquations.erase(first, last);
+        for (size_t eqIndex : restoredEquations)
+        {
+            for (VarT variable : equations[eqIndex].getLeftSide().getVariables())
+            {
+                getOccurrences(variable);
+                occurrences[variable].push_back(eqIndex);
+            }
+            changedEquations.push_back(eqIndex);
+
+            if (equations[eqIndex].isDirty())
+            {
+                dirtyEquations.push_back(eqIndex);
+            }
+            else if (!equationHashes[eqIndex].has_value())
+            {
+                equationHashes[eqIndex] = equations[eqIndex].getLeftSide().hashUpToSign();
+                equationsByHash.emplace(equationHashes[eqIndex].value(), eqIndex);
+            }
+        }
+        std::ranges::sort(dirtyEquations);
+        const auto [firstDuplicate, lastDuplicate] = std::ranges::unique(dirtyEquations);
+        dirtyEquations.erase(firstDuplicate, lastDuplicate);
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    size_t EquationSystem<NumT, VarT>::getScopeDepth() const
+    {
+        return scopes.size();
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    size_t EquationSystem<NumT, VarT>::getTrailSize() const
+    {
+        return trail.size();
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::saveEquation(size_t eqIndex)
+    {
+        if (!scopes.empty() && saveStamps[eqIndex] != scopes.back().stamp)
+        {
+            trail.push_back(UndoRecord {
+                .kind = UndoRecord::Kind::ChangeEquation,
+                .index = eqIndex,
+                .movedIndex = eqIndex,
+                .equation = equations[eqIndex],
+                .saveStamp = saveStamps[eqIndex]
+            });
+            saveStamps[eqIndex] = scopes.back().stamp;
+        }
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::useRowArena()
     {
-        unsigned int newVarNumber = variables.size();
-        variables.push_back(newVarNumber);
+        if (rowArenaOwner.arena == nullptr)
+        {
+            compactRows();
+        }
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    const RowArena* EquationSystem<NumT, VarT>::getRowArena() const
+    {
+        return rowArenaOwner.arena.get();
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::setRowPolicy(const RowPolicy& policy)
+    {
+        rowPolicy = policy;
+        for (Equation<NumT, VarT>& equation : equations)
+        {
+            equation.applyRowPolicy(rowPolicy);
+        }
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::setConstantTrace(ConstantTrace<NumT>* trace)
+    {
+        constantTrace = trace;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::setThreadPool(ThreadPool* pool, size_t minParallelRows)
+    {
+        threadPool = pool;
+        this->minParallelRows = minParallelRows;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::compactRows()
+    {
+        auto arena = std::make_unique<RowArena>();
+
+        std::vector<Equation<NumT, VarT>> compactedEquations;
+        compactedEquations.reserve(equations.size());
+        for (Equation<NumT, VarT>& equation : equations)
+        {
+            compactedEquations.emplace_back(std::move(equation), arena.get());
+        }
+
+        // The moved-from rows still hold memory of the previous arena, so they have to be
+        // released before it
+        equations = std::move(compactedEquations);
+        rowArenaOwner.arena = std::move(arena);
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::renumberVariables(VariableOrdering ordering)
+    {
+        if (!scopes.empty())
+        {
+            throw std::logic_error("variables can't be renumbered while a scope is open");
+        }
+
+        // Unlike the occurrence lists, these contain exactly the equations of each variable
+        std::vector<std::vector<size_t>> equationsOfVariables(variables.size());
+        for (size_t eqIndex = 0; eqIndex < equations.size(); ++eqIndex)
+        {
+            for (const auto& term : equations[eqIndex].getLeftSide().getTerms())
+            {
+                if (term.getCoefficient() != 0)
+                {
+                    equationsOfVariables[term.getVariable()].push_back(eqIndex);
+                }
+            }
+        }
+
+        std::vector<VarT> order;
+        if (ordering == VariableOrdering::ReverseCuthillMcKee)
+        {
+            order = orderByReverseCuthillMcKee(equationsOfVariables);
+        }
+        else
+        {
+            for (size_t variable = 0; variable < variables.size(); ++variable)
+            {
+                if (!equationsOfVariables[variable].empty())
+                {
+                    order.push_back(variable);
+                }
+            }
+        }
+
+        // Variables without equations are dropped, they don't get a new id
+        std::vector<VarT> newVariables(variables.size(), std::numeric_limits<VarT>::max());
+        std::vector<VarT> originalVariables;
+        originalVariables.reserve(order.size());
+        for (size_t newVariable = 0; newVariable < order.size(); ++newVariable)
+        {
+            newVariables[order[newVariable]] = newVariable;
+            originalVariables.push_back(variables[order[newVariable]]);
+        }
+        variables = std::move(originalVariables);
+
+        currentVariables.clear();
+        for (size_t variable = 0; variable < variables.size(); ++variable)
+        {
+            currentVariables.emplace(variables[variable], variable);
+        }
+
+        // Renaming changes the hashes of the rows, so the duplicate index is rebuilt
+        equationsByHash.clear();
+        for (size_t eqIndex = 0; eqIndex < equations.size(); ++eqIndex)
+        {
+            equations[eqIndex].renameVariables(newVariables);
+            equations[eqIndex].applyRowPolicy(rowPolicy);
+            if (equationHashes[eqIndex].has_value())
+            {
+                equationHashes[eqIndex] = equations[eqIndex].getLeftSide().hashUpToSign();
+                equationsByHash.emplace(equationHashes[eqIndex].value(), eqIndex);
+            }
+            changedEquations.push_back(eqIndex);
+        }
+
+        buildOccurrences();
+        hasRenumberedVariables = true;
+        nEliminatedVariables = 0;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::vector<VarT> EquationSystem<NumT, VarT>::orderByReverseCuthillMcKee(
+        const std::vector<std::vector<size_t>>& equationsOfVariables) const
+    {
+        auto byEquationCount = [&equationsOfVariables](VarT variable) {
+            return equationsOfVariables[variable].size();
+        };
+
+        std::vector<VarT> startVariables;
+        for (size_t variable = 0; variable < variables.size(); ++variable)
+        {
+            if (!equationsOfVariables[variable].empty())
+            {
+                startVariables.push_back(variable);
+            }
+        }
+        std::ranges::stable_sort(startVariables, std::less<>(), byEquationCount);
+
+        // The order doubles as the queue of the breadth-first search
+        std::vector<VarT> order;
+        order.reserve(startVariables.size());
+        std::vector<bool> isVariableVisited(variables.size(), false);
+        std::vector<bool> isEquationVisited(equations.size(), false);
+        for (VarT start : startVariables)
+        {
+            if (isVariableVisited[start])
+            {
+                continue;
+            }
+            isVariableVisited[start] = true;
+            order.push_back(start);
+
+            for (size_t next = order.size() - 1; next < order.size(); ++next)
+            {
+                const size_t firstNeighbour = order.size();
+                for (size_t eqIndex : equationsOfVariables[order[next]])
+                {
+                    if (isEquationVisited[eqIndex])
+                    {
+                        continue;
+                    }
+                    isEquationVisited[eqIndex] = true;
+
+                    for (const auto& term : equations[eqIndex].getLeftSide().getTerms())
+                    {
+                        if (term.getCoefficient() != 0 && !isVariableVisited[term.getVariable()])
+                        {
+                            isVariableVisited[term.getVariable()] = true;
+                            order.push_back(term.getVariable());
+                        }
+                    }
+                }
+                std::stable_sort(order.begin() + firstNeighbour, order.end(), [&](VarT a, VarT b) {
+                    return byEquationCount(a) < byEquationCount(b);
+                });
+            }
+        }
+
+        std::ranges::reverse(order);
+        return order;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    bool EquationSystem<NumT, VarT>::isRenumbered() const
+    {
+        return hasRenumberedVariables;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    size_t EquationSystem<NumT, VarT>::getEliminatedVariableCount() const
+    {
+        return nEliminatedVariables;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    VarT EquationSystem<NumT, VarT>::addNewVariable()
+    {
+        // Original ids are never reused, so they run out before the current ids
+        if (nextOriginalVariable > std::numeric_limits<VarT>::max())
+        {
+            throw std::overflow_error("too many variables for " + std::to_string(sizeof(VarT) * 8)
+                                      + " bit variable ids");
+        }
+
+        const VarT newVarNumber = variables.size();
+        if (hasRenumberedVariables)
+        {
+            currentVariables.emplace(nextOriginalVariable, newVarNumber);
+        }
+        variables.push_back(nextOriginalVariable++);
+        if (!scopes.empty())
+        {
+            trail.push_back(UndoRecord{.kind = UndoRecord::Kind::AddVariable});
+        }
         return newVarNumber;
     }
 
-    template <numeric::BigInt NumT>
-    void EquationSystem<NumT>::substitute(const Assignment<NumT>& assignment)
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::invertEquation(size_t eqIndex)
     {
-        for (auto& eq : equations)
+        saveEquation(eqIndex);
+        equations[eqIndex].invert();
+        if (constantTrace != nullptr)
         {
-            eq.substitute(assignment);
+            constantTrace->negate(constantTrace->getEquationRegister(eqIndex));
         }
     }
 
-    template <numeric::BigInt NumT>
-    void EquationSystem<NumT>::substitute(const DeducedEquation<NumT>& deducedEquation)
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::substitute(const Assignment<NumT, VarT>& assignment)
     {
-        for (auto& eq : equations)
+        getOccurrences(assignment.variable);
+        std::vector<size_t> eqIndices;
+        collectSubstitutedEquations(assignment.variable, eqIndices);
+
+        // Only the constant trace needs the coefficients
+        std::vector<std::optional<NumT>> coefficients(constantTrace != nullptr ? eqIndices.size() : 0);
+        forEachRow(eqIndices.size(), [&](size_t i) {
+            std::optional<NumT> coefficient = equations[eqIndices[i]].substitute(assignment);
+            if (constantTrace != nullptr)
+            {
+                coefficients[i] = std::move(coefficient);
+            }
+        });
+
+        if (constantTrace != nullptr)
         {
-            eq.substitute(deducedEquation);
+            for (size_t i = 0; i < eqIndices.size(); ++i)
+            {
+                constantTrace->subtractMultiple(constantTrace->getEquationRegister(eqIndices[i]),
+                                                coefficients[i].value(), constantTrace->getSubstitutedRegister());
+            }
         }
+
+        // The variable does not occur in any equation anymore
+        occurrences[assignment.variable].clear();
+        ++nEliminatedVariables;
     }
 
-    template <numeric::BigInt NumT>
-    SimplificationResult EquationSystem<NumT>::simplify()
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::substitute(const DeducedEquation<NumT, VarT>& deducedEquation)
     {
-        auto eqIterator = equations.begin();
-        while (eqIterator != equations.end())
+        const VarT variable = deducedEquation.getVariable();
+        const auto& newVariables = deducedEquation.getRightSideSum().getVariables();
+
+        getOccurrences(variable);
+        for (VarT newVariable : newVariables)
         {
-            const SimplificationResult result = eqIterator->simplify();
+            getOccurrences(newVariable);
+        }
+
+        std::vector<size_t> eqIndices;
+        collectSubstitutedEquations(variable, eqIndices);
+
+        // Record the fill-in, i.e. variables of the deduced equation that are new to a row
+        for (size_t eqIndex : eqIndices)
+        {
+            const Sum<NumT, VarT>& leftSide = equations[eqIndex].getLeftSide();
+            for (VarT newVariable : newVariables)
+            {
+                if (!leftSide.containsVariable(newVariable))
+                {
+                    occurrences[newVariable].push_back(eqIndex);
+                }
+            }
+        }
+
+        // Only the constant trace needs the coefficients
+        std::vector<std::optional<NumT>> coefficients(constantTrace != nullptr ? eqIndices.size() : 0);
+        forEachRow(eqIndices.size(), [&](size_t i) {
+            std::optional<NumT> coefficient = equations[eqIndices[i]].substitute(deducedEquation);
+            if (constantTrace != nullptr)
+            {
+                coefficients[i] = std::move(coefficient);
+            }
+        });
+
+        if (constantTrace != nullptr)
+        {
+            for (size_t i = 0; i < eqIndices.size(); ++i)
+            {
+                constantTrace->subtractMultiple(constantTrace->getEquationRegister(eqIndices[i]),
+                                                coefficients[i].value(), constantTrace->getSubstitutedRegister());
+            }
+        }
+
+        // The variable does not occur in any equation anymore
+        occurrences[variable].clear();
+        ++nEliminatedVariables;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::collectSubstitutedEquations(VarT variable, std::vector<size_t>& eqIndices)
+    {
+        // An equation may be listed repeatedly, e.g. if the variable cancelled out and came back
+        thread_local std::vector<bool> isCollected;
+        if (isCollected.size() < equations.size())
+        {
+            isCollected.resize(equations.size(), false);
+        }
+
+        eqIndices.clear();
+        for (size_t eqIndex : occurrences[variable])
+        {
+            // Skip stale entries of equations that were removed or lost the variable
+            if (eqIndex >= equations.size() || isCollected[eqIndex]
+                || !equations[eqIndex].getLeftSide().containsVariable(variable))
+            {
+                continue;
+            }
+            isCollected[eqIndex] = true;
+            eqIndices.push_back(eqIndex);
+
+            if (!equations[eqIndex].isDirty())
+            {
+                dirtyEquations.push_back(eqIndex);
+                unindexEquation(eqIndex);
+            }
+            saveEquation(eqIndex);
+            changedEquations.push_back(eqIndex);
+        }
+
+        for (size_t eqIndex : eqIndices)
+        {
+            isCollected[eqIndex] = false;
+        }
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    template <typename Function>
+    void EquationSystem<NumT, VarT>::forEachRow(size_t nRows, const Function& processRow)
+    {
+        // The row arena is not thread-safe
+        if (threadPool == nullptr || nRows < minParallelRows || rowArenaOwner.arena != nullptr)
+        {
+            for (size_t i = 0; i < nRows; ++i)
+            {
+                processRow(i);
+            }
+            return;
+        }
+
+        // Several chunks per thread balance out rows of different lengths
+        const size_t chunkSize = std::max<size_t>(nRows / (8 * threadPool->getThreadCount()), 1);
+        threadPool->parallelFor(nRows, chunkSize, [&processRow](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                processRow(i);
+            }
+        });
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    SimplificationResult EquationSystem<NumT, VarT>::simplify()
+    {
+        lastRemovals.clear();
+
+        // Equations that did not change since their last simplification are still primitive
+        // and indexed. The rows are simplified independently, then indexed one by one.
+        for (size_t eqIndex : dirtyEquations)
+        {
+            saveEquation(eqIndex);
+        }
+        std::vector<SimplificationResult> results(dirtyEquations.size());
+        std::vector<std::optional<NumT>> divisors(constantTrace != nullptr ? dirtyEquations.size() : 0);
+        forEachRow(dirtyEquations.size(), [&](size_t i) {
+            Equation<NumT, VarT>& equation = equations[dirtyEquations[i]];
+            std::optional<NumT> divisor;
+            results[i] = equation.simplify(constantTrace != nullptr ? divisors[i] : divisor);
+            if (results[i] == SimplificationResult::Ok)
+            {
+                equation.applyRowPolicy(rowPolicy);
+            }
+        });
+
+        thread_local std::vector<size_t> deadEquations;
+        deadEquations.clear();
+        for (size_t i = 0; i < dirtyEquations.size(); ++i)
+        {
+            const size_t eqIndex = dirtyEquations[i];
+            SimplificationResult result = results[i];
+            if (constantTrace != nullptr)
+            {
+                const size_t constantRegister = constantTrace->getEquationRegister(eqIndex);
+                if (divisors[i].has_value())
+                {
+                    constantTrace->divideExactly(constantRegister, divisors[i].value());
+                }
+                else if (result == SimplificationResult::IsEmpty)
+                {
+                    constantTrace->requireZero(constantRegister);
+                }
+            }
+
+            if (result == SimplificationResult::Ok)
+            {
+                result = indexSimplifiedEquation(eqIndex);
+            }
+
             switch (result) {
                 case SimplificationResult::Conflict:
                     return SimplificationResult::Conflict;
                     break;
                 
                 case SimplificationResult::IsEmpty:
-                    eqIterator = equations.erase(eqIterator);
+                    deadEquations.push_back(eqIndex);
                     break;
 
                 case SimplificationResult::Ok:
-                    ++eqIterator;
                     break;
             }
         }
+        dirtyEquations.clear();
+
+        // Removing from the back first ensures that only live equations are moved
+        std::ranges::sort(deadEquations, std::greater<>());
+        for (size_t eqIndex : deadEquations)
+        {
+            removeEquation(eqIndex);
+        }
+
+        if (rowArenaOwner.arena != nullptr && rowArenaOwner.arena->isFragmented())
+        {
+            compactRows();
+        }
 
         return equations.empty() ? SimplificationResult::IsEmpty
                                  : SimplificationResult::Ok;
     }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    SimplificationResult EquationSystem<NumT, VarT>::indexSimplifiedEquation(size_t eqIndex)
+    {
+        const Equation<NumT, VarT>& equation = equations[eqIndex];
+        const size_t hash = equation.getLeftSide().hashUpToSign();
+
+        const auto [begin, end] = equationsByHash.equal_range(hash);
+        for (auto entry = begin; entry != end; ++entry)
+        {
+            const Equation<NumT, VarT>& other = equations[entry->second];
+            const int comparison = equation.getLeftSide().compareUpToSign(other.getLeftSide());
+            if (comparison == 0)
+            {
+                continue;
+            }
+
+            if (constantTrace != nullptr)
+            {
+                constantTrace->requireEqual(constantTrace->getEquationRegister(eqIndex),
+                                            constantTrace->getEquationRegister(entry->second), comparison < 0);
+            }
+
+            const bool hasSameRightSide = comparison > 0 ? equation.getRightSide() == other.getRightSide()
+                                                         : equation.getRightSide() == -other.getRightSide();
+            return hasSameRightSide ? SimplificationResult::IsEmpty
+                                    : SimplificationResult::Conflict;
+        }
+
+        equationsByHash.emplace(hash, eqIndex);
+        equationHashes[eqIndex] = hash;
+        return SimplificationResult::Ok;
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::unindexEquation(size_t eqIndex)
+    {
+        if (!equationHashes[eqIndex].has_value())
+        {
+            return;
+        }
+
+        const auto [begin, end] = equationsByHash.equal_range(equationHashes[eqIndex].value());
+        equationsByHash.erase(std::find_if(begin, end, [eqIndex](const auto& entry) {
+            return entry.second == eqIndex;
+        }));
+        equationHashes[eqIndex].reset();
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::removeEquation(size_t eqIndex)
+    {
+        const size_t lastIndex = equations.size() - 1;
+        std::erase(changedEquations, eqIndex);
+        unindexEquation(eqIndex);
+        if (constantTrace != nullptr)
+        {
+            constantTrace->removeEquation(eqIndex);
+        }
+        if (!scopes.empty())
+        {
+            trail.push_back(UndoRecord {
+                .kind = UndoRecord::Kind::RemoveEquation,
+                .index = eqIndex,
+                .movedIndex = lastIndex,
+                .equation = equations[eqIndex],
+                .saveStamp = saveStamps[eqIndex]
+            });
+        }
+
+        if (eqIndex != lastIndex)
+        {
+            equations[eqIndex] = std::move(equations[lastIndex]);
+
+            // Entries of the removed equation are stale now and skipped on lookup
+            for (VarT variable : equations[eqIndex].getLeftSide().getVariables())
+            {
+                std::ranges::replace(occurrences[variable], lastIndex, eqIndex);
+            }
+            std::ranges::replace(changedEquations, lastIndex, eqIndex);
+
+            if (equationHashes[lastIndex].has_value())
+            {
+                const auto [begin, end] = equationsByHash.equal_range(equationHashes[lastIndex].value());
+                std::find_if(begin, end, [lastIndex](const auto& entry) {
+                    return entry.second == lastIndex;
+                })->second = eqIndex;
+                equationHashes[eqIndex] = std::move(equationHashes[lastIndex]);
+            }
+            saveStamps[eqIndex] = saveStamps[lastIndex];
+        }
+
+        equations.pop_back();
+        equationHashes.pop_back();
+        saveStamps.pop_back();
+        lastRemovals.push_back(Removal{eqIndex, lastIndex});
+    }
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    void EquationSystem<NumT, VarT>::buildOccurrences()
+    {
+        occurrences.assign(variables.size(), {});
+        for (size_t eqIndex = 0; eqIndex < equations.size(); ++eqIndex)
+        {
+            for (VarT variable : equations[eqIndex].getLeftSide().getVariables())
+            {
+                getOccurrences(variable);
+                occurrences[variable].push_back(eqIndex);
+            }
+        }
+    }
 }
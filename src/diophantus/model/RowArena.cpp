@@ -0,0 +1,72 @@
+#include "RowArena.hpp"
+
+namespace diophantus::model
+{
+    namespace
+    {
+        // Rows up to this size are pooled, larger rows are passed on to the system directly
+        constexpr size_t largestPooledRow = size_t(1) << 16;
+    }
+
+    RowArena::RowArena() :
+        pool(std::pmr::pool_options{.max_blocks_per_chunk = 0, .largest_required_pool_block = largestPooledRow},
+             &reservationCounter)
+    {}
+
+    size_t RowArena::getUsedBytes() const
+    {
+        return usedBytes;
+    }
+
+    size_t RowArena::getReservedBytes() const
+    {
+        return reservationCounter.getReservedBytes();
+    }
+
+    bool RowArena::isFragmented() const
+    {
+        const size_t reservedBytes = getReservedBytes();
+        return reservedBytes >= minFragmentedBytes && usedBytes < reservedBytes / 2;
+    }
+
+    void* RowArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        void* ptr = pool.allocate(bytes, alignment);
+        usedBytes += bytes;
+        return ptr;
+    }
+
+    void RowArena::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        pool.deallocate(ptr, bytes, alignment);
+        usedBytes -= bytes;
+    }
+
+    bool RowArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    size_t RowArena::ReservationCounter::getReservedBytes() const
+    {
+        return reservedBytes;
+    }
+
+    void* RowArena::ReservationCounter::do_allocate(size_t bytes, size_t alignment)
+    {
+        void* ptr = std::pmr::get_default_resource()->allocate(bytes, alignment);
+        reservedBytes += bytes;
+        return ptr;
+    }
+
+    void RowArena::ReservationCounter::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        std::pmr::get_default_resource()->deallocate(ptr, bytes, alignment);
+        reservedBytes -= bytes;
+    }
+
+    bool RowArena::ReservationCounter::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+}
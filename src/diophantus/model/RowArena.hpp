@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace diophantus::model
+{
+    /**
+     * Memory resource for the rows of an equation system. Rows are served from a pool that
+     * obtains memory from the system in large chunks and reuses freed blocks of the same size, so
+     * the rows of a system are packed into a few buffers instead of being scattered over the heap.
+     *
+     * The arena keeps track of the bytes in use by rows and the bytes reserved from the system,
+     * so that its owner can tell when compacting the rows into a fresh arena pays off. The
+     * coefficients' own limbs, e.g. of GMP numbers, are not allocated from the arena.
+     */
+    class RowArena : public std::pmr::memory_resource
+    {
+        public:
+            // reserved memory below which an arena is never considered fragmented
+            static constexpr size_t minFragmentedBytes = size_t(1) << 20;
+
+            RowArena();
+
+            RowArena(const RowArena&) = delete;
+            RowArena& operator=(const RowArena&) = delete;
+
+            // number of bytes currently allocated by rows
+            size_t getUsedBytes() const;
+
+            // number of bytes reserved from the system
+            size_t getReservedBytes() const;
+
+            /**
+             * @return true if less than half of a significant amount of reserved memory is in
+             *         use by rows.
+             */
+            bool isFragmented() const;
+
+        private:
+            /**
+             * Forwards to the default resource and counts the memory that is reserved through it.
+             */
+            class ReservationCounter : public std::pmr::memory_resource
+            {
+                public:
+                    size_t getReservedBytes() const;
+
+                private:
+                    void* do_allocate(size_t bytes, size_t alignment) override;
+                    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+                    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+                private:
+                    size_t reservedBytes = 0;
+            };
+
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        private:
+            ReservationCounter reservationCounter;
+            std::pmr::unsynchronized_pool_resource pool;
+
+            size_t usedBytes = 0;
+    };
+}
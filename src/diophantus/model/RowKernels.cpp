@@ -0,0 +1,388 @@
+#include "RowKernels.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace diophantus::model::kernels
+{
+    bool isAvx2Supported()
+    {
+#if defined(__x86_64__)
+        static const bool isSupported = __builtin_cpu_supports("avx2");
+        return isSupported;
+#else
+        return false;
+#endif
+    }
+
+    void symModAll(int64_t* values, size_t size, int64_t modulus)
+    {
+        isAvx2Supported() ? avx2::symModAll(values, size, modulus)
+                          : scalar::symModAll(values, size, modulus);
+    }
+
+    bool divideAll(int64_t* values, size_t size, int64_t divisor)
+    {
+        return isAvx2Supported() ? avx2::divideAll(values, size, divisor)
+                                 : scalar::divideAll(values, size, divisor);
+    }
+
+    bool multiplyAll(int64_t* values, size_t size, int64_t factor)
+    {
+        return isAvx2Supported() ? avx2::multiplyAll(values, size, factor)
+                                 : scalar::multiplyAll(values, size, factor);
+    }
+
+    size_t findLowestAbsolute(const int64_t* values, size_t size)
+    {
+        return isAvx2Supported() ? avx2::findLowestAbsolute(values, size)
+                                 : scalar::findLowestAbsolute(values, size);
+    }
+
+
+    namespace scalar
+    {
+        static uint64_t magnitude(const int64_t value)
+        {
+            // Negate in unsigned arithmetic, so that INT64_MIN does not overflow
+            return value < 0 ? -static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        }
+
+        void symModAll(int64_t* values, size_t size, int64_t modulus)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                int64_t& value = values[i];
+                int64_t remainder = value % modulus;
+                if (remainder < 0)
+                {
+                    remainder += modulus;
+                }
+                value = remainder < modulus - remainder ? remainder : remainder - modulus;
+            }
+        }
+
+        bool divideAll(int64_t* values, size_t size, int64_t divisor)
+        {
+            if (divisor == 0)
+            {
+                return false;
+            }
+            if (divisor == -1)
+            {
+                // INT64_MIN / -1 is the only quotient that overflows
+                for (size_t i = 0; i < size; ++i)
+                {
+                    if (values[i] == std::numeric_limits<int64_t>::min())
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                values[i] /= divisor;
+            }
+            return true;
+        }
+
+        bool multiplyAll(int64_t* values, size_t size, int64_t factor)
+        {
+            int64_t product;
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (__builtin_mul_overflow(values[i], factor, &product))
+                {
+                    return false;
+                }
+            }
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                values[i] *= factor;
+            }
+            return true;
+        }
+
+        size_t findLowestAbsolute(const int64_t* values, size_t size)
+        {
+            if (size == 0 || values[0] == 0)
+            {
+                return 0;
+            }
+
+            size_t lowestIndex = 0;
+            uint64_t lowestMagnitude = magnitude(values[0]);
+            for (size_t i = 1; i < size; ++i)
+            {
+                const int64_t value = values[i];
+                if (value != 0 && magnitude(value) < lowestMagnitude)
+                {
+                    lowestIndex = i;
+                    lowestMagnitude = magnitude(value);
+                }
+            }
+            return lowestIndex;
+        }
+    }
+
+
+#if defined(__x86_64__)
+    namespace avx2
+    {
+        // Values below 2^51 in magnitude are converted exactly between int64_t and double by
+        // adding them to the mantissa of 2^52 + 2^51. Products and quotients of such values are
+        // exact, or rounded correctly, in double precision.
+        constexpr int64_t limit = int64_t(1) << 51;
+        constexpr double magicDouble = static_cast<double>((int64_t(1) << 52) + (int64_t(1) << 51));
+        constexpr int64_t magic = std::bit_cast<int64_t>(magicDouble);
+
+        #define AVX2_FUNCTION __attribute__((target("avx2")))
+
+        AVX2_FUNCTION inline __m256i load(const int64_t* values)
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+        }
+
+        AVX2_FUNCTION inline void store(int64_t* values, const __m256i v)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), v);
+        }
+
+        AVX2_FUNCTION inline __m256d toDouble(const __m256i v)
+        {
+            const __m256i magicVector = _mm256_set1_epi64x(magic);
+            return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, magicVector)),
+                                 _mm256_set1_pd(magicDouble));
+        }
+
+        AVX2_FUNCTION inline __m256i toInt64(const __m256d d)
+        {
+            const __m256i magicVector = _mm256_set1_epi64x(magic);
+            return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(d, _mm256_set1_pd(magicDouble))),
+                                    magicVector);
+        }
+
+        /**
+         * @return true if all values are in the interval [-bound, bound)
+         */
+        AVX2_FUNCTION bool areAllBelow(const int64_t* values, size_t size, int64_t bound)
+        {
+            const __m256i upper = _mm256_set1_epi64x(bound - 1);
+            const __m256i lower = _mm256_set1_epi64x(-bound);
+            __m256i outside = _mm256_setzero_si256();
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                __m256i v = load(values + i);
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi64(v, upper));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi64(lower, v));
+            }
+            if (!_mm256_testz_si256(outside, outside))
+            {
+                return false;
+            }
+
+            for (; i < size; ++i)
+            {
+                const int64_t value = values[i];
+                if (value >= bound || value < -bound)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        AVX2_FUNCTION void symModAllVectorized(int64_t* values, size_t size, int64_t modulus)
+        {
+            const __m256d m = _mm256_set1_pd(static_cast<double>(modulus));
+            const __m256d negativeM = _mm256_set1_pd(-static_cast<double>(modulus));
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                __m256d a = toDouble(load(values + i));
+
+                // r = a - m * round(a / m) is exact, then move it into [-m/2, m/2)
+                __m256d q = _mm256_round_pd(_mm256_div_pd(a, m), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                __m256d r = _mm256_sub_pd(a, _mm256_mul_pd(q, m));
+                __m256d twoR = _mm256_add_pd(r, r);
+                r = _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(twoR, m, _CMP_GE_OQ), m));
+                twoR = _mm256_add_pd(r, r);
+                r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(twoR, negativeM, _CMP_LT_OQ), m));
+
+                store(values + i, toInt64(r));
+            }
+            scalar::symModAll(values + i, size - i, modulus);
+        }
+
+        AVX2_FUNCTION void divideAllVectorized(int64_t* values, size_t size, int64_t divisor)
+        {
+            const __m256d d = _mm256_set1_pd(static_cast<double>(divisor));
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                __m256d a = toDouble(load(values + i));
+
+                // The rounding error of the division is too small to cross an integer
+                __m256d q = _mm256_round_pd(_mm256_div_pd(a, d), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+
+                store(values + i, toInt64(q));
+            }
+            scalar::divideAll(values + i, size - i, divisor);
+        }
+
+        AVX2_FUNCTION void multiplyAllVectorized(int64_t* values, size_t size, int64_t factor)
+        {
+            const __m256i f = _mm256_set1_epi64x(factor);
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                // All values and the factor fit into 32 bits, so the product of the low halves is exact
+                store(values + i, _mm256_mul_epi32(load(values + i), f));
+            }
+            scalar::multiplyAll(values + i, size - i, factor);
+        }
+
+        AVX2_FUNCTION size_t findLowestAbsoluteVectorized(const int64_t* values, size_t size)
+        {
+            // Magnitudes are compared as unsigned numbers by flipping their sign bit. Zeros get the
+            // largest key, so they are never picked over a nonzero value.
+            const __m256i signBit = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+            const __m256i zeroKey = _mm256_set1_epi64x(std::numeric_limits<int64_t>::max());
+            const __m256i zero = _mm256_setzero_si256();
+
+            __m256i lowestKeys = zeroKey;
+            __m256i lowestIndices = _mm256_setzero_si256();
+            __m256i indices = _mm256_setr_epi64x(0, 1, 2, 3);
+            const __m256i four = _mm256_set1_epi64x(4);
+
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                __m256i v = load(values + i);
+                __m256i sign = _mm256_cmpgt_epi64(zero, v);
+                __m256i absolute = _mm256_sub_epi64(_mm256_xor_si256(v, sign), sign);
+                __m256i keys = _mm256_xor_si256(absolute, signBit);
+                keys = _mm256_blendv_epi8(keys, zeroKey, _mm256_cmpeq_epi64(v, zero));
+
+                // Strict comparison keeps the first index per lane
+                __m256i isLower = _mm256_cmpgt_epi64(lowestKeys, keys);
+                lowestKeys = _mm256_blendv_epi8(lowestKeys, keys, isLower);
+                lowestIndices = _mm256_blendv_epi8(lowestIndices, indices, isLower);
+                indices = _mm256_add_epi64(indices, four);
+            }
+
+            alignas(32) int64_t laneKeys[4];
+            alignas(32) int64_t laneIndices[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneKeys), lowestKeys);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), lowestIndices);
+
+            int64_t lowestKey = std::numeric_limits<int64_t>::max();
+            size_t lowestIndex = 0;
+            auto consider = [&lowestKey, &lowestIndex](int64_t key, size_t index) {
+                if (key < lowestKey || (key == lowestKey && index < lowestIndex))
+                {
+                    lowestKey = key;
+                    lowestIndex = index;
+                }
+            };
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                if (laneKeys[lane] != std::numeric_limits<int64_t>::max())
+                {
+                    consider(laneKeys[lane], laneIndices[lane]);
+                }
+            }
+            for (; i < size; ++i)
+            {
+                const int64_t value = values[i];
+                if (value != 0)
+                {
+                    consider(static_cast<int64_t>(scalar::magnitude(value) ^ (uint64_t(1) << 63)), i);
+                }
+            }
+            return lowestIndex;
+        }
+
+        void symModAll(int64_t* values, size_t size, int64_t modulus)
+        {
+            if (modulus < limit && areAllBelow(values, size, limit))
+            {
+                symModAllVectorized(values, size, modulus);
+            }
+            else
+            {
+                scalar::symModAll(values, size, modulus);
+            }
+        }
+
+        bool divideAll(int64_t* values, size_t size, int64_t divisor)
+        {
+            if (divisor == 0 || divisor >= limit || divisor < -limit || !areAllBelow(values, size, limit))
+            {
+                return scalar::divideAll(values, size, divisor);
+            }
+            divideAllVectorized(values, size, divisor);
+            return true;
+        }
+
+        bool multiplyAll(int64_t* values, size_t size, int64_t factor)
+        {
+            constexpr int64_t factorLimit = int64_t(1) << 31;
+            if (factor >= factorLimit || factor < -factorLimit || !areAllBelow(values, size, factorLimit))
+            {
+                return scalar::multiplyAll(values, size, factor);
+            }
+            multiplyAllVectorized(values, size, factor);
+            return true;
+        }
+
+        size_t findLowestAbsolute(const int64_t* values, size_t size)
+        {
+            if (size == 0 || values[0] == 0)
+            {
+                return 0;
+            }
+            return findLowestAbsoluteVectorized(values, size);
+        }
+
+        #undef AVX2_FUNCTION
+    }
+#else
+    namespace avx2
+    {
+        void symModAll(int64_t* values, size_t size, int64_t modulus)
+        {
+            scalar::symModAll(values, size, modulus);
+        }
+
+        bool divideAll(int64_t* values, size_t size, int64_t divisor)
+        {
+            return scalar::divideAll(values, size, divisor);
+        }
+
+        bool multiplyAll(int64_t* values, size_t size, int64_t factor)
+        {
+            return scalar::multiplyAll(values, size, factor);
+        }
+
+        size_t findLowestAbsolute(const int64_t* values, size_t size)
+        {
+            return scalar::findLowestAbsolute(values, size);
+        }
+    }
+#endif
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Element-wise operations on rows of int64_t coefficients. A row is given by a pointer to its
+ * first coefficient and the number of coefficients, which are stored contiguously.
+ *
+ * The functions in the kernels namespace dispatch at runtime to the AVX2 implementation if the
+ * CPU supports it, and to the scalar implementation otherwise. Both produce identical results.
+ */
+namespace diophantus::model::kernels
+{
+    /**
+     * @return true if the AVX2 kernels can be used on this CPU.
+     */
+    bool isAvx2Supported();
+
+    /**
+     * Replaces every value by its symmetric remainder modulo a positive modulus, see symMod.
+     */
+    void symModAll(int64_t* values, size_t size, int64_t modulus);
+
+    /**
+     * Divides every value by the divisor, rounding towards zero.
+     * @return false if the divisor is zero or a quotient overflows. The row is unchanged then.
+     */
+    bool divideAll(int64_t* values, size_t size, int64_t divisor);
+
+    /**
+     * Multiplies every value by the factor.
+     * @return false if a product overflows. The row is unchanged then.
+     */
+    bool multiplyAll(int64_t* values, size_t size, int64_t factor);
+
+    /**
+     * Finds the nonzero value with the lowest absolute value. If the row starts with a zero, or
+     * all values are zero, the first value is reported.
+     * @return the index of the first such value
+     */
+    size_t findLowestAbsolute(const int64_t* values, size_t size);
+
+    namespace scalar
+    {
+        void symModAll(int64_t* values, size_t size, int64_t modulus);
+        bool divideAll(int64_t* values, size_t size, int64_t divisor);
+        bool multiplyAll(int64_t* values, size_t size, int64_t factor);
+        size_t findLowestAbsolute(const int64_t* values, size_t size);
+    }
+
+    /**
+     * Must only be called if isAvx2Supported(). Rows with values that are too large for the
+     * vectorized arithmetic are processed by the scalar implementation.
+     */
+    namespace avx2
+    {
+        void symModAll(int64_t* values, size_t size, int64_t modulus);
+        bool divideAll(int64_t* values, size_t size, int64_t divisor);
+        bool multiplyAll(int64_t* values, size_t size, int64_t factor);
+        size_t findLowestAbsolute(const int64_t* values, size_t size);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+namespace diophantus::model
+{
+    /**
+     * Layout of the rows of an equation system, see Sum.
+     */
+    enum class RowLayout
+    {
+        Sparse,
+        Dense,
+        Adaptive
+    };
+
+    /**
+     * Decides the layout of each row. Adaptive rows become dense once they fill enough of the
+     * range between their first and last variable, and sparse again once they thin out. The gap
+     * between both thresholds keeps rows from switching back and forth.
+     */
+    struct RowPolicy
+    {
+        RowLayout layout = RowLayout::Sparse;
+
+        // fill ratio from which an adaptive row becomes dense
+        double denseFillRatio = 0.5;
+
+        // fill ratio below which a dense adaptive row becomes sparse
+        double sparseFillRatio = 0.25;
+
+        // minimum number of terms for an adaptive row to become dense
+        size_t minDenseTermCount = 16;
+    };
+}
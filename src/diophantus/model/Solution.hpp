@@ -8,18 +8,15 @@
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
-    struct Assignment;
-
-    template <numeric::BigInt NumT>
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     struct Solution
     {
         public:
-            std::vector<Assignment<NumT>> assignments;
+            std::vector<Assignment<NumT, VarT>> assignments;
     };
 
-    template <numeric::BigInt NumT>
-    std::ostream &operator<<(std::ostream &os, const Solution<NumT>& solution)
+    template <numeric::BigInt NumT, VariableId VarT>
+    std::ostream &operator<<(std::ostream &os, const Solution<NumT, VarT>& solution)
     {
         for (const auto& a : solution.assignments)
         {
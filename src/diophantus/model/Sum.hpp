@@ -1,95 +1,466 @@
 #pragma once
 
+#include "RowKernels.hpp"
+#include "RowPolicy.hpp"
 #include "Term.hpp"
+#include "TermReference.hpp"
 
 #include <compare>
 #include <diophantus/model/Variable.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
 #include <diophantus/model/numeric/GmpBigInt.hpp>
 #include <diophantus/model/numeric/BigInt.hpp>
 
 #include <logging.hpp>
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <bits/ranges_algo.h>
 #include <execution>
+#include <functional>
 #include <ios>
+#include <memory_resource>
+#include <numeric>
 #include <optional>
 #include <pstl/glue_algorithm_defs.h>
 #include <pstl/glue_execution_defs.h>
 #include <ranges>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
+    /**
+     * A sum of terms. The coefficients and the variables of the terms are stored in two separate
+     * arrays, so that scans and merges by variable only touch the dense array of variables.
+     *
+     * The terms are always ordered by their variables and each variable occurs at most once.
+     *
+     * A sum is laid out either sparse or dense. A sparse sum only holds the terms with a nonzero
+     * coefficient. A dense sum holds a term for every variable between its first and its last
+     * variable, including terms with coefficient 0, so that adding a multiple of another sum
+     * indexes the coefficients directly instead of merging by variable. getTerms(),
+     * getCoefficients() and getVariables() include the zero terms of dense sums.
+     *
+     * Both arrays allocate from a memory resource, which is the default heap unless the sum was
+     * moved into other storage, e.g. the row arena of an equation system. Copies of a sum always
+     * allocate from the default heap.
+     */
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     class Sum
     {
         public:
-            explicit Sum<NumT>(const std::vector<Term<NumT>>& terms) :
-                terms(std::move(terms))
+            using Coefficients = std::pmr::vector<NumT>;
+            using Variables = std::pmr::vector<VarT>;
+
+        public:
+            /**
+             * @param terms
+             *      The terms of the sum in any order. Terms with the same variable are combined
+             *      and terms with coefficient 0 are left out.
+             */
+            explicit Sum(const std::vector<Term<NumT, VarT>>& terms)
+            {
+                // Sort a permutation of the terms, so that they are only copied once
+                std::vector<size_t> order(terms.size());
+                std::iota(order.begin(), order.end(), size_t(0));
+                std::ranges::stable_sort(order, std::less<>(), [&terms](size_t i) {
+                    return terms[i].getVariable();
+                });
+
+                coefficients.reserve(terms.size());
+                variables.reserve(terms.size());
+                for (size_t i : order)
+                {
+                    if (!variables.empty() && variables.back() == terms[i].getVariable())
+                    {
+                        coefficients.back() += terms[i].getCoefficient();
+                    }
+                    else
+                    {
+                        coefficients.push_back(terms[i].getCoefficient());
+                        variables.push_back(terms[i].getVariable());
+                    }
+                }
+                removeZeroTerms();
+            }
+
+            /**
+             * Moves a sum into storage from the given memory resource. If the other sum allocates
+             * from a different resource, its terms are moved one by one.
+             * @param other
+             * @param resource
+             */
+            Sum(Sum<NumT, VarT>&& other, std::pmr::memory_resource* resource) :
+                coefficients(std::move(other.coefficients), resource),
+                variables(std::move(other.variables), resource),
+                hasDenseLayout(other.hasDenseLayout)
             {}
 
-            const std::vector<Term<NumT>>& getTerms() const
+            /**
+             * Random access iterator over references to the terms of a sum.
+             */
+            class TermIterator
+            {
+                public:
+                    using iterator_concept = std::random_access_iterator_tag;
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = TermReference<NumT, VarT>;
+                    using difference_type = std::ptrdiff_t;
+
+                    TermIterator() = default;
+
+                    TermIterator(const Sum<NumT, VarT>* sum, size_t index) :
+                        sum(sum),
+                        index(index)
+                    {}
+
+                    TermReference<NumT, VarT> operator*() const
+                    {
+                        return sum->getTerm(index);
+                    }
+
+                    TermReference<NumT, VarT> operator[](difference_type offset) const
+                    {
+                        return sum->getTerm(index + offset);
+                    }
+
+                    TermIterator& operator++() { ++index; return *this; }
+                    TermIterator operator++(int) { TermIterator old = *this; ++index; return old; }
+                    TermIterator& operator--() { --index; return *this; }
+                    TermIterator operator--(int) { TermIterator old = *this; --index; return old; }
+                    TermIterator& operator+=(difference_type offset) { index += offset; return *this; }
+                    TermIterator& operator-=(difference_type offset) { index -= offset; return *this; }
+
+                    friend TermIterator operator+(TermIterator iterator, difference_type offset)
+                    {
+                        return iterator += offset;
+                    }
+
+                    friend TermIterator operator+(difference_type offset, TermIterator iterator)
+                    {
+                        return iterator += offset;
+                    }
+
+                    friend TermIterator operator-(TermIterator iterator, difference_type offset)
+                    {
+                        return iterator -= offset;
+                    }
+
+                    friend difference_type operator-(const TermIterator& a, const TermIterator& b)
+                    {
+                        return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+                    }
+
+                    friend bool operator==(const TermIterator& a, const TermIterator& b)
+                    {
+                        return a.index == b.index;
+                    }
+
+                    friend auto operator<=>(const TermIterator& a, const TermIterator& b)
+                    {
+                        return a.index <=> b.index;
+                    }
+
+                private:
+                    const Sum<NumT, VarT>* sum = nullptr;
+                    size_t index = 0;
+            };
+
+            /**
+             * Range of references to the terms of a sum. It always reflects the current terms of
+             * the sum, also after terms have been added.
+             */
+            class TermRange : public std::ranges::view_interface<TermRange>
+            {
+                public:
+                    explicit TermRange(const Sum<NumT, VarT>* sum) :
+                        sum(sum)
+                    {}
+
+                    TermIterator begin() const
+                    {
+                        return TermIterator(sum, 0);
+                    }
+
+                    TermIterator end() const
+                    {
+                        return TermIterator(sum, sum->variables.size());
+                    }
+
+                private:
+                    const Sum<NumT, VarT>* sum;
+            };
+
+            // References to the terms of this sum, in the order of their variables
+            TermRange getTerms() const
+            {
+                return TermRange(this);
+            }
+
+            // Coefficients of the terms, in the same order as getVariables()
+            const Coefficients& getCoefficients() const
+            {
+                return coefficients;
+            }
+
+            // Variables of the terms, in the same order as getCoefficients()
+            const Variables& getVariables() const
+            {
+                return variables;
+            }
+
+            // whether the sum is laid out dense, see Sum
+            bool isDense() const
+            {
+                return hasDenseLayout;
+            }
+
+            /**
+             * Counts the terms with a nonzero coefficient.
+             * @return the number of terms
+             */
+            size_t getTermCount() const
+            {
+                if (!hasDenseLayout)
+                {
+                    return variables.size();
+                }
+                return std::ranges::count_if(coefficients, [](const NumT& coefficient) {
+                    return coefficient != 0;
+                });
+            }
+
+            /**
+             * Determines the share of the variables from the first to the last variable of the sum
+             * that have a nonzero coefficient.
+             * @return the fill ratio, or 0 if the sum has no terms
+             */
+            double getFillRatio() const
+            {
+                const auto [first, last] = getNonzeroRange();
+                if (first == last)
+                {
+                    return 0;
+                }
+                const double width = variables[last - 1] - variables[first] + 1;
+                return getTermCount() / width;
+            }
+
+            /**
+             * Switches to the dense layout. Sums without terms stay sparse.
+             */
+            void makeDense()
+            {
+                if (hasDenseLayout || variables.empty())
+                {
+                    return;
+                }
+
+                const VarT first = variables.front();
+                const size_t width = variables.back() - first + 1;
+
+                Coefficients denseCoefficients(coefficients.get_allocator());
+                Variables denseVariables(variables.get_allocator());
+                denseCoefficients.reserve(width);
+                denseVariables.reserve(width);
+
+                size_t position = 0;
+                for (VarT variable = first; denseVariables.size() < width; ++variable)
+                {
+                    denseVariables.push_back(variable);
+                    if (variables[position] == variable)
+                    {
+                        denseCoefficients.push_back(std::move(coefficients[position]));
+                        ++position;
+                    }
+                    else
+                    {
+                        denseCoefficients.push_back(NumT(0));
+                    }
+                }
+
+                coefficients = std::move(denseCoefficients);
+                variables = std::move(denseVariables);
+                hasDenseLayout = true;
+            }
+
+            /**
+             * Switches to the sparse layout by dropping the terms with coefficient 0.
+             */
+            void makeSparse()
             {
-                return terms;
+                if (!hasDenseLayout)
+                {
+                    return;
+                }
+                removeZeroTerms();
+                hasDenseLayout = false;
             }
 
-            void addTerm(const Term<NumT>& term)
+            /**
+             * Chooses the layout of the sum according to a row policy.
+             * @param policy
+             */
+            void applyRowPolicy(const RowPolicy& policy)
             {
-                terms.push_back(std::move(term));
+                switch (policy.layout)
+                {
+                    case RowLayout::Sparse:
+                        makeSparse();
+                        break;
+
+                    case RowLayout::Dense:
+                        makeDense();
+                        break;
+
+                    case RowLayout::Adaptive:
+                        if (hasDenseLayout)
+                        {
+                            trimZeroTerms();
+                            if (getFillRatio() < policy.sparseFillRatio)
+                            {
+                                makeSparse();
+                            }
+                        }
+                        else if (variables.size() >= policy.minDenseTermCount
+                                 && getFillRatio() >= policy.denseFillRatio)
+                        {
+                            makeDense();
+                        }
+                        break;
+                }
+            }
+
+            /**
+             * Adds a term to the sum, keeping the terms ordered by their variables. If the sum
+             * already has a term with the same variable, the coefficients are added up.
+             * @param term
+             */
+            void addTerm(const Term<NumT, VarT>& term)
+            {
+                if (term.getCoefficient() == 0)
+                {
+                    return;
+                }
+
+                if (hasDenseLayout)
+                {
+                    coverVariables(term.getVariable(), term.getVariable());
+                    coefficients[term.getVariable() - variables.front()] += term.getCoefficient();
+                    return;
+                }
+
+                const size_t position = findPosition(term.getVariable());
+                if (position < variables.size() && variables[position] == term.getVariable())
+                {
+                    coefficients[position] += term.getCoefficient();
+                    if (coefficients[position] == 0)
+                    {
+                        eraseTerm(position);
+                    }
+                }
+                else
+                {
+                    coefficients.insert(coefficients.begin() + position, term.getCoefficient());
+                    variables.insert(variables.begin() + position, term.getVariable());
+                }
+            }
+
+            /**
+             * @param var
+             * @return true if the sum has a term with the variable
+             */
+            bool containsVariable(const VarT var) const
+            {
+                if (hasDenseLayout)
+                {
+                    return !variables.empty() && var >= variables.front() && var <= variables.back()
+                        && coefficients[var - variables.front()] != 0;
+                }
+                return std::ranges::binary_search(variables, var);
             }
 
             /**
              * Determines the term with the lowest coefficient.
              * @return 
              */
-            const Term<NumT>& getLowestCoefficientTerm() const
+            TermReference<NumT, VarT> getLowestCoefficientTerm() const
+            {
+                return getTerm(getLowestCoefficientIndex());
+            }
+
+            /**
+             * Determines the position of the term with the lowest coefficient, see getTerms().
+             * @return 
+             */
+            size_t getLowestCoefficientIndex() const
             {
+                // Start at the first nonzero coefficient, which only differs from the first
+                // coefficient for dense sums
+                const size_t first = getNonzeroRange().first;
+
+                if constexpr (hasInt64Coefficients)
+                {
+                    if (first < coefficients.size())
+                    {
+                        return first + kernels::findLowestAbsolute(getCoefficientRow() + first,
+                                                                   coefficients.size() - first);
+                    }
+                }
+
                 // Find term with the minimum absolute coefficient other than zero
-                auto compareAbsolute = [](const Term<NumT>& a, const Term<NumT> &b)
+                auto compareAbsolute = [](const NumT& a, const NumT& b)
                 {
-                    bool aIsLower = a.getCoefficient().absCmp(b.getCoefficient()) == std::strong_ordering::less;
-                    return aIsLower && (a.getCoefficient() != 0);
+                    bool aIsLower = a.absCmp(b) == std::strong_ordering::less;
+                    return aIsLower && (a != 0);
                 };
 
-                return *std::min_element(terms.begin(), terms.end(), compareAbsolute);
+                auto lowest = std::min_element(coefficients.begin() + first, coefficients.end(), compareAbsolute);
+                return std::distance(coefficients.begin(), lowest);
             }
 
             /**
              * Determines the term with the highest coefficient.
              * @return 
              */
-            const Term<NumT>& getHighestCoefficientTerm() const
+            TermReference<NumT, VarT> getHighestCoefficientTerm() const
             {
                 // Find term with the maximum absolute coefficient other than zero
-                auto compareAbsolute = [](const Term<NumT>& a, const Term<NumT> &b)
+                auto compareAbsolute = [](const NumT& a, const NumT& b)
                 {
-                    bool aIsLower = a.getCoefficient().absCmp(b.getCoefficient()) == std::strong_ordering::less;
-                    return aIsLower || (a.getCoefficient() == 0);
+                    bool aIsLower = a.absCmp(b) == std::strong_ordering::less;
+                    return aIsLower || (a == 0);
                 };
 
-                return *std::max_element(terms.begin(), terms.end(), compareAbsolute);
+                auto highest = std::max_element(coefficients.begin(), coefficients.end(), compareAbsolute);
+                return getTerm(std::distance(coefficients.begin(), highest));
             }
 
             /**
-             * Simplifies the equation by:
-             *      - Deleting terms with coefficient 0
-             *      - Dividing all coefficients by their greatest common divisor
-             * @return The greatest common divisor of all coefficients if there are terms left,
-                       std::nullopt otherwise.
+             * Simplifies the sum by deleting terms with coefficient 0 and determines its content,
+             * i.e. the positive greatest common divisor of all coefficients.
+             * @return The content of the sum if there are terms left, std::nullopt otherwise.
              */
             const std::optional<NumT> simplify()
             {
-                removeZeroTerms();
+                if (hasDenseLayout)
+                {
+                    trimZeroTerms();
+                }
+                else
+                {
+                    removeZeroTerms();
+                }
 
-                auto gcd = gcdOfCoefficients();
-                if (gcd == 0)
+                if (coefficients.empty())
                 {
                     return std::nullopt;
                 }
-                return gcd;
+                return content();
             }
 
             /**
@@ -98,85 +469,338 @@ namespace diophantus::model
              */
             void divideCoefficientsBy(const NumT& divisor)
             {
-                for (Term<NumT>& term : terms)
+                if constexpr (hasInt64Coefficients)
                 {
-                    term.divideCoefficientBy(divisor);
+                    if (kernels::divideAll(getCoefficientRow(), coefficients.size(), divisor.get()))
+                    {
+                        return;
+                    }
+                }
+
+                for (NumT& coefficient : coefficients)
+                {
+                    coefficient /= divisor;
                 }
             }
 
             /**
-             * Takes the coefficients of all terms modulo a number.
+             * Divides the coefficients of all terms by a number that is known to divide all of them.
              * @param divisor
              */
+            void divideCoefficientsExactlyBy(const NumT& divisor)
+            {
+                if constexpr (hasInt64Coefficients)
+                {
+                    if (kernels::divideAll(getCoefficientRow(), coefficients.size(), divisor.get()))
+                    {
+                        return;
+                    }
+                }
+
+                for (NumT& coefficient : coefficients)
+                {
+                    coefficient.divExact(divisor);
+                }
+            }
+
+            /**
+             * Negates the coefficients of all terms.
+             */
+            void negateCoefficients()
+            {
+                for (NumT& coefficient : coefficients)
+                {
+                    coefficient.negate();
+                }
+            }
+
+            /**
+             * Adds a multiple of another sum to this sum, i.e. this += factor * other.
+             * Terms whose coefficient becomes zero are removed, unless the sum is dense.
+             * @param other
+             * @param factor
+             */
+            void addMultipleOf(const Sum<NumT, VarT>& other, const NumT& factor)
+            {
+                if (hasDenseLayout)
+                {
+                    addMultipleToDense(other, factor);
+                    return;
+                }
+
+                if constexpr (hasInt64Coefficients)
+                {
+                    // Scale a copy of the other coefficients in one pass, then merge by plain addition
+                    thread_local Coefficients scaledCoefficients;
+                    scaledCoefficients.assign(other.coefficients.begin(), other.coefficients.end());
+                    auto* scaledRow = reinterpret_cast<int64_t*>(scaledCoefficients.data());
+                    if (kernels::multiplyAll(scaledRow, scaledCoefficients.size(), factor.get()))
+                    {
+                        mergeTerms(other.variables, scaledCoefficients,
+                                   [](NumT& coefficient, const NumT& scaledCoefficient) {
+                                       coefficient += scaledCoefficient;
+                                   });
+                        return;
+                    }
+                }
+
+                mergeTerms(other.variables, other.coefficients,
+                           [&factor](NumT& coefficient, const NumT& otherCoefficient) {
+                               coefficient.addMul(otherCoefficient, factor);
+                           });
+            }
+
+            /**
+             * Takes the coefficients of all terms modulo a number and removes the terms whose
+             * coefficient becomes zero, unless the sum is dense.
+             * @param modulus
+             */
             void coefficientsModulo(const NumT& modulus)
             {
-                for (Term<NumT>& term : terms)
+                bool isReduced = false;
+                if constexpr (hasInt64Coefficients)
                 {
-                    term.coefficientMod(modulus);
+                    if (modulus > 0)
+                    {
+                        kernels::symModAll(getCoefficientRow(), coefficients.size(), modulus.get());
+                        isReduced = true;
+                    }
                 }
 
-                // TODO: Handle terms with coefficient 0?
+                if (!isReduced)
+                {
+                    for (NumT& coefficient : coefficients)
+                    {
+                        coefficient = NumT::symMod(coefficient, modulus);
+                    }
+                }
+
+                // Variables whose coefficient is a multiple of the modulus drop out
+                if (!hasDenseLayout)
+                {
+                    removeZeroTerms();
+                }
             }
 
             /**
-             * Sets the coefficient of the specified variable to zero.
+             * Removes the term of the specified variable.
              * @param var
              *      The variable
-             * @return The old coefficient of the variable, if it is present in the sum.
+             * @return The coefficient of the removed term, if the variable is present in the sum.
              *         nullopt, otherwise.
              */
-            const std::optional<NumT> setCoefficientOfVariableToZero(const Variable var)
+            std::optional<NumT> removeTermOfVariable(const VarT var)
             {
-                // Search for the first (and only) term with this variable
-                auto variableMatches = [var](const Term<NumT>& term)
+                if (hasDenseLayout)
                 {
-                    return (term.getVariable() == var);
-                };
-                const auto& varTerm = std::find_if(terms.begin(), terms.end(), variableMatches);
+                    if (!containsVariable(var))
+                    {
+                        return std::nullopt;
+                    }
+                    return std::exchange(coefficients[var - variables.front()], NumT(0));
+                }
 
-                if (varTerm == terms.end())
+                const size_t position = findPosition(var);
+                if (position == variables.size() || variables[position] != var)
                 {
                     // Term was not present in this sum, cannot return any old coefficient.
                     return std::nullopt;
                 }
-                else
+
+                NumT coefficient = std::move(coefficients[position]);
+                eraseTerm(position);
+                return coefficient;
+            }
+
+            /**
+             * Substitutes a variable by another sum, i.e. removes the term c*var and adds c times
+             * the other sum.
+             * @param var
+             *      The variable to substitute
+             * @param other
+             *      The sum to substitute the variable by. It must not contain the variable itself.
+             * @return The coefficient c of the variable, if it is present in the sum.
+             *         nullopt, otherwise.
+             */
+            std::optional<NumT> substituteVariable(const VarT var, const Sum<NumT, VarT>& other)
+            {
+                if (!containsVariable(var))
+                {
+                    return std::nullopt;
+                }
+                const size_t position = hasDenseLayout ? var - variables.front() : findPosition(var);
+
+                // The merge drops the zeroed term of a sparse sum, so it does not need to be erased
+                // separately
+                NumT coefficient = std::exchange(coefficients[position], NumT(0));
+                addMultipleOf(other, coefficient);
+                return coefficient;
+            }
+
+            /**
+             * Renames the variables of the sum and restores the order of the terms. Dense sums
+             * become sparse, since the renamed variables are not contiguous in general.
+             * @param newVariables
+             *      The new name of each variable, indexed by the current one. Different variables
+             *      of the sum must get different names.
+             */
+            void renameVariables(const std::vector<VarT>& newVariables)
+            {
+                makeSparse();
+                for (VarT& variable : variables)
+                {
+                    variable = newVariables[variable];
+                }
+                if (std::ranges::is_sorted(variables))
+                {
+                    return;
+                }
+
+                // Sort a permutation of the terms, so that the coefficients are moved only once
+                thread_local std::vector<size_t> order;
+                order.resize(variables.size());
+                std::iota(order.begin(), order.end(), size_t(0));
+                std::ranges::sort(order, std::less<>(), [this](size_t i) {
+                    return variables[i];
+                });
+
+                Coefficients sortedCoefficients(coefficients.get_allocator());
+                Variables sortedVariables(variables.get_allocator());
+                sortedCoefficients.reserve(coefficients.size());
+                sortedVariables.reserve(variables.size());
+                for (size_t i : order)
+                {
+                    sortedCoefficients.push_back(std::move(coefficients[i]));
+                    sortedVariables.push_back(variables[i]);
+                }
+                coefficients = std::move(sortedCoefficients);
+                variables = std::move(sortedVariables);
+            }
+
+            /**
+             * Copies this sum without the term of a variable.
+             * @param var
+             *      The variable to leave out
+             * @return A sparse sum with all other terms of this sum
+             */
+            Sum<NumT, VarT> withoutVariable(const VarT var) const
+            {
+                Sum<NumT, VarT> sum(std::vector<Term<NumT, VarT>>{});
+                sum.coefficients.reserve(coefficients.size());
+                sum.variables.reserve(variables.size());
+                for (size_t i = 0; i < variables.size(); ++i)
+                {
+                    if (variables[i] != var && coefficients[i] != 0)
+                    {
+                        sum.coefficients.push_back(coefficients[i]);
+                        sum.variables.push_back(variables[i]);
+                    }
+                }
+                return sum;
+            }
+
+            /**
+             * Computes a hash of the sum that is equal for sums that are equal up to their sign.
+             * @return the hash
+             */
+            size_t hashUpToSign() const
+            {
+                // Signs are taken relative to the first nonzero coefficient
+                const size_t first = getNonzeroRange().first;
+                const bool isFirstNegative = first < coefficients.size() && coefficients[first] < 0;
+
+                size_t hash = getTermCount();
+                auto combine = [&hash](size_t value)
+                {
+                    hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+                };
+                for (size_t i = 0; i < variables.size(); ++i)
+                {
+                    // Zero terms of dense sums are skipped, so the hash doesn't depend on the layout
+                    if (coefficients[i] == 0)
+                    {
+                        continue;
+                    }
+                    combine(variables[i]);
+                    combine(coefficients[i].absHash());
+                    combine((coefficients[i] < 0) != isFirstNegative);
+                }
+                return hash;
+            }
+
+            /**
+             * Compares two sums up to their sign.
+             * @param other
+             * @return 1 if the sums are equal, -1 if one is the negation of the other, 0 otherwise.
+             */
+            int compareUpToSign(const Sum<NumT, VarT>& other) const
+            {
+                if (!hasDenseLayout && !other.hasDenseLayout && variables != other.variables)
+                {
+                    return 0;
+                }
+
+                // Walk the nonzero terms of both sums in lockstep, so that sums with different
+                // layouts can be compared
+                auto [own, ownEnd] = getNonzeroRange();
+                auto [theirs, theirEnd] = other.getNonzeroRange();
+                std::optional<bool> isNegated;
+                while (own < ownEnd && theirs < theirEnd)
                 {
-                    // Copy old coefficient, set it to zero and return old coefficient
-                    // TODO: Remove term instead? Depending on the data structure
-                    // return std::exchange(varTerm->coefficient, NumT(0));
+                    if (variables[own] != other.variables[theirs])
+                    {
+                        return 0;
+                    }
+
+                    const bool isSignFlipped = (coefficients[own] < 0) != (other.coefficients[theirs] < 0);
+                    if (isSignFlipped != isNegated.value_or(isSignFlipped)
+                        || coefficients[own].absCmp(other.coefficients[theirs]) != std::strong_ordering::equal)
+                    {
+                        return 0;
+                    }
+                    isNegated = isSignFlipped;
 
-                    NumT oldCoefficient{varTerm->getCoefficient()};
-                    varTerm->setCoefficientToZero();
-                    return oldCoefficient;
+                    do { ++own; } while (own < ownEnd && coefficients[own] == 0);
+                    do { ++theirs; } while (theirs < theirEnd && other.coefficients[theirs] == 0);
                 }
+
+                if (own != ownEnd || theirs != theirEnd)
+                {
+                    return 0;
+                }
+                return isNegated.value_or(false) ? -1 : 1;
             }
 
-            friend std::ostream& operator<<(std::ostream& os, const Sum<NumT>& sum)
+            friend std::ostream& operator<<(std::ostream& os, const Sum<NumT, VarT>& sum)
             {
                 // C++23 -> std::ranges::views::drop_last | std::ranges::accumulate | ...
 
-                if (sum.terms.empty())
+                if (sum.getTermCount() == 0)
                 {
                     os << "0";
                 }
 
-                bool firstIteration = true;
-                for (const auto& term : sum.terms)
+                bool isFirst = true;
+                for (size_t i = 0; i < sum.variables.size(); ++i)
                 {
-                    if (!firstIteration)
+                    if (sum.coefficients[i] == 0)
+                    {
+                        continue;
+                    }
+                    if (!isFirst)
                     {
                         os << " + ";
                     }
-                    firstIteration = false;
+                    isFirst = false;
 
-                    if (!term.getVariable())
+                    if (!sum.variables[i])
                     {
                         os << "WARNING: VARIABLE MISSING";
                     }
                     else
                     {
-                        os <<  "(" << term.getCoefficient() << ")*"
-                           << "x[" << term.getVariable() << "]";
+                        os <<  "(" << sum.coefficients[i] << ")*"
+                           << "x[" << sum.variables[i] << "]";
                     }
                 }
 
@@ -184,49 +808,249 @@ namespace diophantus::model
             }
 
         private:
-            const NumT gcdOfCoefficients() const
+            // Coefficients of CheckedInt64 rows are processed by the vectorized int64 row kernels
+            static constexpr bool hasInt64Coefficients = std::is_same_v<NumT, numeric::CheckedInt64>;
+
+            // index of the first term whose variable is not less than the given one
+            size_t findPosition(const VarT var) const
+            {
+                return std::distance(variables.begin(), std::ranges::lower_bound(variables, var));
+            }
+
+            void eraseTerm(size_t index)
             {
-                NumT gcd = NumT(0);
+                coefficients.erase(coefficients.begin() + index);
+                variables.erase(variables.begin() + index);
+            }
+
+            TermReference<NumT, VarT> getTerm(size_t index) const
+            {
+                return TermReference<NumT, VarT>(coefficients[index], variables[index]);
+            }
+
+            int64_t* getCoefficientRow()
+            {
+                static_assert(std::is_standard_layout_v<NumT> && sizeof(NumT) == sizeof(int64_t),
+                              "the coefficients must be stored as plain int64_t values");
+                return reinterpret_cast<int64_t*>(coefficients.data());
+            }
 
-                bool firstIteration = true;
-                for (const auto& term : terms)
+            const int64_t* getCoefficientRow() const
+            {
+                return reinterpret_cast<const int64_t*>(coefficients.data());
+            }
+
+            /**
+             * Merges the terms of another sum into this sum. Terms whose coefficient becomes zero
+             * are removed.
+             * @param otherVariables
+             * @param otherCoefficients
+             * @param addCoefficient
+             *      Adds the contribution of an other coefficient to a coefficient of this sum
+             */
+            template <typename AddCoefficient>
+            void mergeTerms(const Variables& otherVariables,
+                            const Coefficients& otherCoefficients,
+                            AddCoefficient addCoefficient)
+            {
+                // The merged terms are collected in buffers that are recycled between calls
+                thread_local Coefficients newCoefficients;
+                thread_local Variables newVariables;
+                newCoefficients.clear();
+                newVariables.clear();
+                newCoefficients.reserve(coefficients.size() + otherCoefficients.size());
+                newVariables.reserve(variables.size() + otherVariables.size());
+
+                size_t own = 0;
+                size_t other = 0;
+
+                while (other < otherVariables.size() || own < variables.size())
                 {
-                    const NumT& coefficient = term.getCoefficient();
-                    if (coefficient == 0)
+                    if (other < otherVariables.size() && own < variables.size()
+                        && otherVariables[other] == variables[own])
                     {
-                        continue;
+                        // Update the coefficient in place and keep the term if it didn't vanish
+                        addCoefficient(coefficients[own], otherCoefficients[other]);
+                        if (coefficients[own] != 0)
+                        {
+                            newCoefficients.push_back(std::move(coefficients[own]));
+                            newVariables.push_back(variables[own]);
+                        }
+                        ++other;
+                        ++own;
                     }
-
-                    if (firstIteration)
+                    else if (other < otherVariables.size() && (own == variables.size()
+                        || otherVariables[other] < variables[own]))
                     {
-                        gcd = coefficient;
-                        firstIteration = false;
+                        NumT coefficient(0);
+                        addCoefficient(coefficient, otherCoefficients[other]);
+                        newCoefficients.push_back(std::move(coefficient));
+                        newVariables.push_back(otherVariables[other]);
+                        ++other;
                     }
                     else
                     {
-                        gcd = NumT::gcd(gcd, coefficient);
+                        if (coefficients[own] != 0)
+                        {
+                            newCoefficients.push_back(std::move(coefficients[own]));
+                            newVariables.push_back(variables[own]);
+                        }
+                        ++own;
                     }
-                    
+                }
+
+                if (coefficients.get_allocator() == newCoefficients.get_allocator())
+                {
+                    coefficients.swap(newCoefficients);
+                    variables.swap(newVariables);
+                }
+                else
+                {
+                    // The buffers can't change hands across resources, so the merged terms are
+                    // moved into the storage of this sum, which is reused if it is large enough
+                    coefficients.assign(std::make_move_iterator(newCoefficients.begin()),
+                                        std::make_move_iterator(newCoefficients.end()));
+                    variables.assign(newVariables.begin(), newVariables.end());
+                }
+                newCoefficients.clear();
+            }
+
+            const NumT content() const
+            {
+                NumT gcd = NumT::abs(coefficients.front());
+
+                // The running gcd can not get any smaller than 1, so stop as soon as it's reached
+                for (auto coefficient = std::next(coefficients.begin());
+                     coefficient != coefficients.end() && gcd != 1; ++coefficient)
+                {
+                    gcd.gcdWith(*coefficient);
                 }
                 return gcd;
             }
 
             bool areAllCoefficientsZero() const
             {
-                return std::ranges::find_if(terms, [](const Term<NumT>& term) {
-                    return term.getCoefficient() != 0;
-                }) == terms.end();
+                return std::ranges::find_if(coefficients, [](const NumT& coefficient) {
+                    return coefficient != 0;
+                }) == coefficients.end();
+            }
+
+            /**
+             * Determines the positions of the first nonzero term and of the end of the last
+             * nonzero term. Only dense sums can have zero terms at their ends.
+             * @return the half-open range of positions, which is empty if all terms are zero
+             */
+            std::pair<size_t, size_t> getNonzeroRange() const
+            {
+                if (!hasDenseLayout)
+                {
+                    return {0, coefficients.size()};
+                }
+
+                size_t first = 0;
+                size_t last = coefficients.size();
+                while (first < last && coefficients[first] == 0)
+                {
+                    ++first;
+                }
+                while (last > first && coefficients[last - 1] == 0)
+                {
+                    --last;
+                }
+                return {first, last};
+            }
+
+            /**
+             * Removes the zero terms at both ends of a dense sum, so that its first and last
+             * terms are nonzero.
+             */
+            void trimZeroTerms()
+            {
+                const auto [first, last] = getNonzeroRange();
+                coefficients.erase(coefficients.begin() + last, coefficients.end());
+                variables.erase(variables.begin() + last, variables.end());
+                coefficients.erase(coefficients.begin(), coefficients.begin() + first);
+                variables.erase(variables.begin(), variables.begin() + first);
+            }
+
+            /**
+             * Extends a dense sum by zero terms, so that it has a term for every variable from
+             * first to last.
+             * @param first
+             * @param last
+             */
+            void coverVariables(const VarT first, const VarT last)
+            {
+                if (variables.empty())
+                {
+                    variables.resize(last - first + 1);
+                    std::iota(variables.begin(), variables.end(), first);
+                    coefficients.insert(coefficients.end(), last - first + 1, NumT(0));
+                    return;
+                }
+
+                if (first < variables.front())
+                {
+                    const size_t count = variables.front() - first;
+                    variables.insert(variables.begin(), count, first);
+                    std::iota(variables.begin(), variables.begin() + count, first);
+                    coefficients.insert(coefficients.begin(), count, NumT(0));
+                }
+                if (last > variables.back())
+                {
+                    const size_t count = last - variables.back();
+                    const VarT next = variables.back() + 1;
+                    variables.resize(variables.size() + count);
+                    std::iota(variables.end() - count, variables.end(), next);
+                    coefficients.insert(coefficients.end(), count, NumT(0));
+                }
+            }
+
+            /**
+             * Dense variant of addMultipleOf(). The coefficients of the other sum are added at
+             * the positions of their variables, without merging.
+             */
+            void addMultipleToDense(const Sum<NumT, VarT>& other, const NumT& factor)
+            {
+                const auto [first, last] = other.getNonzeroRange();
+                if (first == last || factor == 0)
+                {
+                    return;
+                }
+                coverVariables(other.variables[first], other.variables[last - 1]);
+
+                const VarT base = variables.front();
+                for (size_t i = first; i < last; ++i)
+                {
+                    coefficients[other.variables[i] - base].addMul(other.coefficients[i], factor);
+                }
             }
 
             void removeZeroTerms()
             {
-                std::erase_if(terms,
-                            [](const Term<NumT>& term) {
-                                return term.getCoefficient() == 0;
-                            });
+                // Compact both arrays in one pass, keeping the order of the remaining terms
+                size_t kept = 0;
+                for (size_t i = 0; i < coefficients.size(); ++i)
+                {
+                    if (coefficients[i] != 0)
+                    {
+                        if (kept != i)
+                        {
+                            coefficients[kept] = std::move(coefficients[i]);
+                            variables[kept] = variables[i];
+                        }
+                        ++kept;
+                    }
+                }
+                coefficients.erase(coefficients.begin() + kept, coefficients.end());
+                variables.erase(variables.begin() + kept, variables.end());
             }
 
         private:
-            std::vector<Term<NumT>> terms;
+            Coefficients coefficients;
+            Variables variables;
+
+            // whether there is a term for every variable from the first to the last one, see Sum
+            bool hasDenseLayout = false;
     };
 }
@@ -1,58 +1,52 @@
 #include "Term.hpp"
 
 #include <diophantus/model/Variable.hpp>
+#include <diophantus/model/numeric/HybridBigInt.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
+#include <diophantus/model/numeric/FixedInt.hpp>
 
+#include <cstdint>
 #include <utility>
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
-    Term<NumT>::Term(const NumT& coefficient, const Variable variable) :
+    template <numeric::BigInt NumT, VariableId VarT>
+    Term<NumT, VarT>::Term(const NumT& coefficient, const VarT variable) :
         coefficient(std::move(coefficient)),
         variable(std::move(variable))
     {}
 
-    template <numeric::BigInt NumT>
-    Term<NumT>::Term(const long coefficient, const Variable variable) :
+    template <numeric::BigInt NumT, VariableId VarT>
+    Term<NumT, VarT>::Term(const long coefficient, const VarT variable) :
         coefficient(NumT(coefficient)),
         variable(std::move(variable))
     {}
 
-    template <numeric::BigInt NumT>
-    const NumT& Term<NumT>::getCoefficient() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    const NumT& Term<NumT, VarT>::getCoefficient() const
     {
         return coefficient;
     }
 
-    template <numeric::BigInt NumT>
-    Variable Term<NumT>::getVariable() const
+    template <numeric::BigInt NumT, VariableId VarT>
+    VarT Term<NumT, VarT>::getVariable() const
     {
         return variable;
     }
 
-    template <numeric::BigInt NumT>
-    void Term<NumT>::divideCoefficientBy(const NumT& divisor)
-    {
-        coefficient /= divisor;
-    }
-
-    template <numeric::BigInt NumT>
-    void Term<NumT>::multiplyCoefficientBy(const NumT& factor)
-    {
-        coefficient *= factor;
-    }
-
-    template <numeric::BigInt NumT>
-    void Term<NumT>::coefficientMod(const NumT& modulus)
-    {
-        coefficient = NumT::symMod(coefficient, modulus);
-    }
-
-    template <numeric::BigInt NumT>
-    void Term<NumT>::setCoefficientToZero()
-    {
-        coefficient = NumT(0);
-    }
-
-    template class Term<numeric::GmpBigInt>;
+    template class Term<numeric::GmpBigInt, std::uint16_t>;
+    template class Term<numeric::GmpBigInt, std::uint32_t>;
+    template class Term<numeric::GmpBigInt, std::uint64_t>;
+    template class Term<numeric::HybridBigInt, std::uint16_t>;
+    template class Term<numeric::HybridBigInt, std::uint32_t>;
+    template class Term<numeric::HybridBigInt, std::uint64_t>;
+    template class Term<numeric::CheckedInt64, std::uint16_t>;
+    template class Term<numeric::CheckedInt64, std::uint32_t>;
+    template class Term<numeric::CheckedInt64, std::uint64_t>;
+    template class Term<numeric::FixedInt<128>, std::uint16_t>;
+    template class Term<numeric::FixedInt<128>, std::uint32_t>;
+    template class Term<numeric::FixedInt<128>, std::uint64_t>;
+    template class Term<numeric::FixedInt<256>, std::uint16_t>;
+    template class Term<numeric::FixedInt<256>, std::uint32_t>;
+    template class Term<numeric::FixedInt<256>, std::uint64_t>;
 }
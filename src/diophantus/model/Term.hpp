@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Variable.hpp"
+
 #include "numeric/GmpBigInt.hpp"
 #include "numeric/BigInt.hpp"
 
@@ -8,51 +10,29 @@
 
 namespace diophantus::model
 {
-    template <numeric::BigInt NumT>
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
     class Term
     {
         public:
-            Term<NumT>(const NumT& coefficient, const unsigned int variable);
+            Term(const NumT& coefficient, const VarT variable);
 
             /**
              * Constructor which converts the long coefficient to a NumT.
              */
-            Term<NumT>(const long coefficient, const unsigned int variable);
+            Term(const long coefficient, const VarT variable);
 
             // Getters
             const NumT& getCoefficient() const;
-            unsigned int getVariable() const;
-
-            /**
-             * Divides the coefficient by a divisor.
-             * @param divisor
-             */
-            void divideCoefficientBy(const NumT& divisor);
-
-            /**
-             * Multiply the coefficient by a factor.
-             * @param factor
-             */
-            void multiplyCoefficientBy(const NumT& factor);
-
-            /**
-             * Takes the coefficient mod another number.
-             */
-            void coefficientMod(const NumT& modulus);
-
-            /**
-             * Sets the coefficient to zero.
-             */
-            void setCoefficientToZero();
+            VarT getVariable() const;
 
-            friend std::ostream &operator<<(std::ostream &os, const Term<NumT>& term)
+            friend std::ostream &operator<<(std::ostream &os, const Term<NumT, VarT>& term)
             {
-                os << "(" << term.coefficient << ")*x[" << term.variable->variableNumber << "]";
+                os << "(" << term.coefficient << ")*x[" << term.variable << "]";
                 return os;
             }
 
         private:
             NumT coefficient;
-            unsigned int variable;
+            VarT variable;
     };
 }
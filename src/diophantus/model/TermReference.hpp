@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Term.hpp"
+#include "Variable.hpp"
+
+#include "numeric/BigInt.hpp"
+
+#include <ostream>
+
+namespace diophantus::model
+{
+    /**
+     * Read-only view of a term that is stored inside a sum. The coefficient is referenced, not
+     * copied, so the view reflects in-place changes of the sum, e.g. an inversion of its equation.
+     * It is invalidated when terms are added to or removed from the sum.
+     */
+    template <numeric::BigInt NumT, VariableId VarT = Variable>
+    class TermReference
+    {
+        public:
+            TermReference(const NumT& coefficient, const VarT variable) :
+                coefficient(&coefficient),
+                variable(variable)
+            {}
+
+            // Getters
+            const NumT& getCoefficient() const
+            {
+                return *coefficient;
+            }
+
+            VarT getVariable() const
+            {
+                return variable;
+            }
+
+            /**
+             * Copies the referenced term.
+             */
+            operator Term<NumT, VarT>() const
+            {
+                return Term<NumT, VarT>(*coefficient, variable);
+            }
+
+            friend std::ostream &operator<<(std::ostream &os, const TermReference<NumT, VarT>& term)
+            {
+                os << "(" << *term.coefficient << ")*x[" << term.variable << "]";
+                return os;
+            }
+
+        private:
+            const NumT* coefficient;
+            VarT variable;
+    };
+}
@@ -0,0 +1,126 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace diophantus::model
+{
+    ThreadPool::ThreadPool(size_t nThreads)
+    {
+        if (nThreads == 0)
+        {
+            nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        // The calling thread takes part in every loop
+        workers.reserve(nThreads - 1);
+        for (size_t i = 1; i < nThreads; ++i)
+        {
+            workers.emplace_back(&ThreadPool::runWorker, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        isStopping = true;
+        nLoops.fetch_add(1, std::memory_order_release);
+        nLoops.notify_all();
+
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t ThreadPool::getThreadCount() const
+    {
+        return workers.size() + 1;
+    }
+
+    void ThreadPool::parallelFor(size_t nItems, size_t chunkSize, const std::function<void(size_t, size_t)>& body)
+    {
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        if (nItems == 0)
+        {
+            return;
+        }
+        if (workers.empty() || nItems <= chunkSize)
+        {
+            for (size_t begin = 0; begin < nItems; begin += chunkSize)
+            {
+                body(begin, std::min(begin + chunkSize, nItems));
+            }
+            return;
+        }
+
+        this->body = &body;
+        this->nItems = nItems;
+        this->chunkSize = chunkSize;
+        nextItem.store(0, std::memory_order_relaxed);
+        nBusyWorkers.store(workers.size(), std::memory_order_relaxed);
+        nLoops.fetch_add(1, std::memory_order_release);
+        nLoops.notify_all();
+
+        runChunks();
+
+        for (uint32_t nBusy = nBusyWorkers.load(std::memory_order_acquire); nBusy != 0;
+             nBusy = nBusyWorkers.load(std::memory_order_acquire))
+        {
+            nBusyWorkers.wait(nBusy, std::memory_order_acquire);
+        }
+        this->body = nullptr;
+        if (error)
+        {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+    void ThreadPool::runWorker()
+    {
+        uint32_t nSeenLoops = 0;
+        while (true)
+        {
+            nLoops.wait(nSeenLoops, std::memory_order_acquire);
+            nSeenLoops = nLoops.load(std::memory_order_acquire);
+            if (isStopping)
+            {
+                return;
+            }
+
+            runChunks();
+
+            // The caller waits for every worker before it starts the next loop, so no worker
+            // can miss one
+            if (nBusyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                nBusyWorkers.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::runChunks()
+    {
+        while (true)
+        {
+            const size_t begin = nextItem.fetch_add(chunkSize, std::memory_order_relaxed);
+            if (begin >= nItems)
+            {
+                return;
+            }
+
+            try
+            {
+                (*body)(begin, std::min(begin + chunkSize, nItems));
+            }
+            catch (...)
+            {
+                std::lock_guard lock(errorMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                nextItem.store(nItems, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace diophantus::model
+{
+    /**
+     * Persistent pool of worker threads for parallel loops. The workers are started once and
+     * sleep between loops, so a loop only costs waking them up. They wait on atomics, see
+     * std::atomic::wait, which spin briefly before they put a thread to sleep.
+     *
+     * A loop is split into chunks of consecutive items. The workers and the calling thread take
+     * the next chunk whenever they are done with one, so that items of different cost even out.
+     */
+    class ThreadPool
+    {
+        public:
+            /**
+             * @param nThreads
+             *      Number of threads that run a loop, including the calling thread. 0 selects the
+             *      number of hardware threads.
+             */
+            explicit ThreadPool(size_t nThreads = 0);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            // number of threads that run a loop, including the calling thread
+            size_t getThreadCount() const;
+
+            /**
+             * Calls body(begin, end) for chunks [begin, end) of at most chunkSize items that cover
+             * [0, nItems), and returns once all of them are done. The chunks run concurrently and
+             * in no particular order. If a chunk throws, the chunks that did not start yet are
+             * skipped and the first exception is rethrown. Loops can't be nested, and only one
+             * thread at a time may run a loop on the pool.
+             * @param nItems
+             * @param chunkSize
+             * @param body
+             */
+            void parallelFor(size_t nItems, size_t chunkSize, const std::function<void(size_t, size_t)>& body);
+
+        private:
+            void runWorker();
+
+            /**
+             * Runs chunks of the current loop until none are left.
+             */
+            void runChunks();
+
+        private:
+            std::vector<std::thread> workers;
+
+            // current loop, published to the workers by incrementing nLoops
+            const std::function<void(size_t, size_t)>* body = nullptr;
+            size_t nItems = 0;
+            size_t chunkSize = 1;
+            bool isStopping = false;
+
+            // number of loops started so far, which the workers wait on
+            std::atomic<uint32_t> nLoops = 0;
+
+            // workers that did not finish the current loop yet, which the caller waits on
+            std::atomic<uint32_t> nBusyWorkers = 0;
+
+            // first item of the next chunk
+            std::atomic<size_t> nextItem = 0;
+
+            // first exception thrown by a chunk of the current loop
+            std::mutex errorMutex;
+            std::exception_ptr error;
+    };
+}
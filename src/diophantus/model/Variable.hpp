@@ -3,9 +3,17 @@
 #include "numeric/GmpBigInt.hpp"
 #include "numeric/BigInt.hpp"
 
+#include <concepts>
 #include <optional>
 
 namespace diophantus::model
 {
     typedef unsigned int Variable;
+
+    /**
+     * Integer type of the variable ids. The model classes take it as a template parameter that
+     * defaults to Variable, so that small systems can use narrower ids and huge systems wider ones.
+     */
+    template <typename VarT>
+    concept VariableId = std::unsigned_integral<VarT> && !std::same_as<VarT, bool>;
 }
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace diophantus::model
+{
+    /**
+     * Order in which the live variables of an equation system are renumbered, see
+     * EquationSystem::renumberVariables.
+     */
+    enum class VariableOrdering
+    {
+        // keep the relative order of the variables
+        Compact,
+
+        // reverse Cuthill-McKee order, which places variables that share equations next to each
+        // other, so that rows span narrow ranges of ids
+        ReverseCuthillMcKee
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <diophantus/model/Equation.hpp>
+#include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/Solution.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+#include <diophantus/model/Variable.hpp>
+#include <diophantus/model/numeric/BigInt.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+
+namespace diophantus::model
+{
+    /**
+     * Converts a number from one BigInt implementation to another.
+     * Conversions into a fixed-width type throw numeric::OverflowError if the value does not fit.
+     */
+    template <numeric::BigInt ToT, numeric::BigInt FromT>
+    ToT convertNumber(const FromT& number)
+    {
+        if constexpr (std::is_same_v<ToT, FromT>)
+        {
+            return number;
+        }
+        else if constexpr (std::is_same_v<FromT, numeric::CheckedInt64>)
+        {
+            return ToT(static_cast<long>(number.get()));
+        }
+        else if constexpr (std::is_same_v<FromT, numeric::GmpBigInt>)
+        {
+            if (mpz_fits_slong_p(number.get().get_mpz_t()))
+            {
+                return ToT(mpz_get_si(number.get().get_mpz_t()));
+            }
+            return ToT(number.get().get_str());
+        }
+        else
+        {
+            // Generic conversion via the decimal representation
+            std::ostringstream ss;
+            ss << number;
+            return ToT(ss.str());
+        }
+    }
+
+    template <numeric::BigInt ToT, numeric::BigInt FromT, VariableId VarT>
+    Sum<ToT, VarT> convertSum(const Sum<FromT, VarT>& sum)
+    {
+        std::vector<Term<ToT, VarT>> terms;
+        terms.reserve(sum.getTerms().size());
+        for (const auto& term : sum.getTerms())
+        {
+            terms.emplace_back(convertNumber<ToT>(term.getCoefficient()), term.getVariable());
+        }
+        return Sum<ToT, VarT>(std::move(terms));
+    }
+
+    template <numeric::BigInt ToT, numeric::BigInt FromT, VariableId VarT>
+    Equation<ToT, VarT> convertEquation(const Equation<FromT, VarT>& equation)
+    {
+        return Equation<ToT, VarT>(convertSum<ToT>(equation.getLeftSide()),
+                                   convertNumber<ToT>(equation.getRightSide()));
+    }
+
+    template <numeric::BigInt ToT, numeric::BigInt FromT, VariableId VarT>
+    EquationSystem<ToT, VarT> convertEquationSystem(const EquationSystem<FromT, VarT>& equationSystem)
+    {
+        std::vector<Equation<ToT, VarT>> equations;
+        equations.reserve(equationSystem.getEquationCount());
+        for (const auto& equation : equationSystem.getEquations())
+        {
+            equations.push_back(convertEquation<ToT>(equation));
+        }
+        return EquationSystem<ToT, VarT>(equationSystem.getVariables(), std::move(equations));
+    }
+
+    template <numeric::BigInt ToT, numeric::BigInt FromT, VariableId VarT>
+    Solution<ToT, VarT> convertSolution(const Solution<FromT, VarT>& solution)
+    {
+        Solution<ToT, VarT> converted;
+        converted.assignments.reserve(solution.assignments.size());
+        for (const auto& assignment : solution.assignments)
+        {
+            converted.assignments.push_back(Assignment<ToT, VarT> {
+                .variable = assignment.variable,
+                .value = convertNumber<ToT>(assignment.value)
+            });
+        }
+        return converted;
+    }
+}
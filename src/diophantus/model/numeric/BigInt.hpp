@@ -1,7 +1,10 @@
 #pragma once
 
 #include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <string>
 
 namespace diophantus::model::numeric
@@ -39,17 +42,69 @@ namespace diophantus::model::numeric
         Number::symMod(a, b);       // Calculate symmetric modulo
     };
 
+    template<typename Number>
+    concept InPlaceArithmetic = requires(Number a, Number b, Number c)
+    {
+        a.addMul(b, c);             // a += b * c
+        a.subMul(b, c);             // a -= b * c
+        a.negate();                 // a = -a
+        a.divExact(b);              // a /= b, where b is known to divide a
+        a.gcdWith(b);               // a = gcd(a, b)
+        { a.isDivisibleBy(b) } -> std::same_as<bool>;
+    };
+
     template<typename Number>
     concept AbsoluteComparable = requires(Number a, Number b, std::strong_ordering r)
     {
         r = a.absCmp(b);
     };
 
+    template<typename Number>
+    concept AbsoluteHashable = requires(Number a)
+    {
+        { a.absHash() } -> std::convertible_to<size_t>;  // Hash of the absolute value
+    };
+
+    /**
+     * Hashes the absolute value of a number given by its 64 bit limbs, least significant first.
+     * Leading zero limbs are ignored, so equal values hash equally in all representations. Only
+     * the number of limbs and the lowest and highest limb are mixed in, so that hashing a row of
+     * large coefficients doesn't cost more than a pass over it.
+     * @param nLimbs
+     * @param getLimb
+     *      Returns the limb at the given position
+     */
+    template<typename GetLimb>
+    constexpr size_t hashMagnitude(size_t nLimbs, GetLimb getLimb)
+    {
+        while (nLimbs > 0 && getLimb(nLimbs - 1) == 0)
+        {
+            --nLimbs;
+        }
+        if (nLimbs == 0)
+        {
+            return 0;
+        }
+
+        // Mix the limbs into the state with the finalizer of splitmix64
+        uint64_t hash = nLimbs;
+        for (size_t i : {size_t(0), nLimbs - 1})
+        {
+            hash ^= static_cast<uint64_t>(getLimb(i));
+            hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+            hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+            hash ^= hash >> 31;
+        }
+        return hash;
+    }
+
     template<typename Number>
     concept BigInt = (InitializableFromLong<Number>
                    && InitializableFromString<Number>
                    && Show<Number>
                    && Comparable<Number>
                    && Arithmetic<Number>
-                   && AbsoluteComparable<Number>);
+                   && InPlaceArithmetic<Number>
+                   && AbsoluteComparable<Number>
+                   && AbsoluteHashable<Number>);
 }
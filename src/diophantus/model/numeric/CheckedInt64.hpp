@@ -0,0 +1,241 @@
+#pragma once
+
+#include "BigInt.hpp"
+#include "OverflowError.hpp"
+
+#include <charconv>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <string>
+
+namespace diophantus::model::numeric
+{
+    /**
+     * Plain 64 bit integer with overflow-checked arithmetic. Every operation whose result does
+     * not fit into an int64_t throws an OverflowError instead of wrapping around.
+     */
+    class CheckedInt64
+    {
+        static_assert(sizeof(long) == sizeof(int64_t), "CheckedInt64 requires 64 bit longs");
+
+        public:
+            explicit CheckedInt64(const long i) : value(i) {}
+            explicit CheckedInt64(const std::string& s) : value(0)
+            {
+                const auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+                if (error == std::errc::result_out_of_range)
+                {
+                    throw OverflowError("integer literal does not fit into 64 bits: " + s);
+                }
+                else if (error != std::errc() || end != s.data() + s.size())
+                {
+                    throw std::invalid_argument("invalid integer literal: " + s);
+                }
+            }
+
+            int64_t get() const
+            {
+                return value;
+            }
+
+            // Comparable
+            std::strong_ordering operator<=>(const CheckedInt64& other) const = default;
+
+            std::strong_ordering operator<=>(const long other) const
+            {
+                return value <=> other;
+            }
+
+            bool operator==(const CheckedInt64&) const = default;
+
+            bool operator==(const long otherValue) const
+            {
+                return value == otherValue;
+            }
+
+            // Arithmetic
+            CheckedInt64 operator+(const CheckedInt64& other) const
+            {
+                int64_t result;
+                if (__builtin_add_overflow(value, other.value, &result))
+                {
+                    throw OverflowError("overflow in addition");
+                }
+                return CheckedInt64(result);
+            }
+
+            CheckedInt64 operator-(const CheckedInt64& other) const
+            {
+                int64_t result;
+                if (__builtin_sub_overflow(value, other.value, &result))
+                {
+                    throw OverflowError("overflow in subtraction");
+                }
+                return CheckedInt64(result);
+            }
+
+            CheckedInt64 operator*(const CheckedInt64& other) const
+            {
+                int64_t result;
+                if (__builtin_mul_overflow(value, other.value, &result))
+                {
+                    throw OverflowError("overflow in multiplication");
+                }
+                return CheckedInt64(result);
+            }
+
+            CheckedInt64 operator%(const CheckedInt64& other) const
+            {
+                // INT64_MIN % -1 overflows, but is zero
+                return CheckedInt64(other.value == -1 ? 0 : value % other.value);
+            }
+
+            void operator+=(const CheckedInt64& other)
+            {
+                *this = *this + other;
+            }
+
+            void operator-=(const CheckedInt64& other)
+            {
+                *this = *this - other;
+            }
+
+            void operator*=(const CheckedInt64& other)
+            {
+                *this = *this * other;
+            }
+
+            void operator/=(const CheckedInt64& other)
+            {
+                if (value == minValue && other.value == -1)
+                {
+                    throw OverflowError("overflow in division");
+                }
+                value /= other.value;
+            }
+
+            CheckedInt64 operator-() const
+            {
+                if (value == minValue)
+                {
+                    throw OverflowError("overflow in negation");
+                }
+                return CheckedInt64(-value);
+            }
+
+            // In-place arithmetic
+            void addMul(const CheckedInt64& a, const CheckedInt64& b)
+            {
+                int64_t product;
+                if (__builtin_mul_overflow(a.value, b.value, &product)
+                    || __builtin_add_overflow(value, product, &product))
+                {
+                    throw OverflowError("overflow in multiply-add");
+                }
+                value = product;
+            }
+
+            void subMul(const CheckedInt64& a, const CheckedInt64& b)
+            {
+                int64_t product;
+                if (__builtin_mul_overflow(a.value, b.value, &product)
+                    || __builtin_sub_overflow(value, product, &product))
+                {
+                    throw OverflowError("overflow in multiply-subtract");
+                }
+                value = product;
+            }
+
+            void negate()
+            {
+                *this = -*this;
+            }
+
+            void divExact(const CheckedInt64& divisor)
+            {
+                *this /= divisor;
+            }
+
+            void gcdWith(const CheckedInt64& other)
+            {
+                *this = gcd(*this, other);
+            }
+
+            bool isDivisibleBy(const CheckedInt64& divisor) const
+            {
+                // Like mpz_divisible_p, only zero is divisible by zero
+                return divisor.value == 0 ? value == 0
+                                          : divisor.value == -1 || value % divisor.value == 0;
+            }
+
+            static const CheckedInt64 abs(const CheckedInt64& a)
+            {
+                return a.value < 0 ? -a : a;
+            }
+
+            std::strong_ordering absCmp(const CheckedInt64& other) const
+            {
+                return magnitude(value) <=> magnitude(other.value);
+            }
+
+            // Hash of the absolute value
+            size_t absHash() const
+            {
+                const uint64_t valueMagnitude = magnitude(value);
+                return hashMagnitude(1, [valueMagnitude](size_t) { return valueMagnitude; });
+            }
+
+            // Calculate greatest common divisor
+            static const CheckedInt64 gcd(const CheckedInt64& a, const CheckedInt64& b)
+            {
+                uint64_t gcd = std::gcd(magnitude(a.value), magnitude(b.value));
+                if (gcd > static_cast<uint64_t>(maxValue))
+                {
+                    throw OverflowError("overflow in gcd");
+                }
+                return CheckedInt64(static_cast<long>(gcd));
+            }
+
+            // Calculate symmetric modulo
+            static const CheckedInt64 symMod(const CheckedInt64& a, const CheckedInt64& b)
+            {
+                CheckedInt64 aModB = a % b;
+                if (aModB < 0)
+                {
+                    aModB += abs(b);
+                }
+
+                if (b > 0 && aModB < b - aModB)
+                {
+                    return aModB;
+                }
+                else
+                {
+                    return aModB - b;
+                }
+            }
+
+            // Stream operator
+            friend std::ostream& operator<<(std::ostream& os, const CheckedInt64& number)
+            {
+                os << number.value;
+                return os;
+            }
+
+        private:
+            static constexpr int64_t minValue = std::numeric_limits<int64_t>::min();
+            static constexpr int64_t maxValue = std::numeric_limits<int64_t>::max();
+
+            static uint64_t magnitude(const int64_t value)
+            {
+                // Negate in unsigned arithmetic, so that INT64_MIN does not overflow
+                return value < 0 ? -static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            }
+
+        private:
+            int64_t value;
+    };
+}
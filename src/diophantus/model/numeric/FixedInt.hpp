@@ -0,0 +1,707 @@
+#pragma once
+
+#include "BigInt.hpp"
+#include "OverflowError.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace diophantus::model::numeric::limbs
+{
+    /**
+     * Double-width arithmetic on 64 bit limbs that only uses 64 bit integers, for compilers
+     * without a 128 bit integer type.
+     */
+    namespace portable
+    {
+        /**
+         * a * b + c + d, which always fits into two limbs.
+         * @param high
+         *      Receives the high limb
+         * @return the low limb
+         */
+        constexpr uint64_t mulAdd(const uint64_t a, const uint64_t b, const uint64_t c, const uint64_t d,
+                                  uint64_t& high)
+        {
+            constexpr uint64_t lowMask = 0xFFFFFFFF;
+            const uint64_t lowLow = (a & lowMask) * (b & lowMask);
+            const uint64_t lowHigh = (a & lowMask) * (b >> 32);
+            const uint64_t highLow = (a >> 32) * (b & lowMask);
+            const uint64_t highHigh = (a >> 32) * (b >> 32);
+
+            const uint64_t middle = (lowLow >> 32) + (lowHigh & lowMask) + (highLow & lowMask);
+            uint64_t low = (lowLow & lowMask) | (middle << 32);
+            high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+
+            low += c;
+            high += low < c;
+            low += d;
+            high += low < d;
+            return low;
+        }
+
+        /**
+         * (high * 2^64 + low) / divisor by binary long division, requires high < divisor so
+         * that the quotient fits into a limb.
+         * @param remainder
+         *      Receives the remainder
+         * @return the quotient
+         */
+        constexpr uint64_t divWide(const uint64_t high, const uint64_t low, const uint64_t divisor,
+                                   uint64_t& remainder)
+        {
+            uint64_t quotient = 0;
+            remainder = high;
+            for (int bit = 63; bit >= 0; --bit)
+            {
+                // The remainder stays below the divisor, so it has at most one bit more after
+                // the shift
+                const bool isCarried = remainder >> 63;
+                remainder = (remainder << 1) | ((low >> bit) & 1);
+                quotient <<= 1;
+                if (isCarried || remainder >= divisor)
+                {
+                    remainder -= divisor;
+                    quotient |= 1;
+                }
+            }
+            return quotient;
+        }
+    }
+
+#ifdef __SIZEOF_INT128__
+    __extension__ using uint128_t = unsigned __int128;
+
+    // see portable::mulAdd
+    constexpr uint64_t mulAdd(const uint64_t a, const uint64_t b, const uint64_t c, const uint64_t d,
+                              uint64_t& high)
+    {
+        const uint128_t t = uint128_t(a) * b + c + d;
+        high = static_cast<uint64_t>(t >> 64);
+        return static_cast<uint64_t>(t);
+    }
+
+    // see portable::divWide
+    constexpr uint64_t divWide(const uint64_t high, const uint64_t low, const uint64_t divisor,
+                               uint64_t& remainder)
+    {
+        const uint128_t t = (uint128_t(high) << 64) | low;
+        remainder = static_cast<uint64_t>(t % divisor);
+        return static_cast<uint64_t>(t / divisor);
+    }
+#else
+    using portable::mulAdd;
+    using portable::divWide;
+#endif
+}
+
+namespace diophantus::model::numeric
+{
+    /**
+     * Signed integer with a compile-time number of bits, stored inline as 64 bit limbs in two's
+     * complement. Like CheckedInt64, every operation whose result does not fit throws an
+     * OverflowError instead of wrapping around.
+     * @tparam Bits
+     *      Width of the integer, must be a multiple of 64 and at least 128.
+     */
+    template <size_t Bits>
+    class FixedInt
+    {
+        static_assert(Bits % 64 == 0 && Bits >= 128, "FixedInt requires a multiple of 64 bits");
+        static_assert(sizeof(long) == sizeof(int64_t), "FixedInt requires 64 bit longs");
+
+        static constexpr size_t nLimbs = Bits / 64;
+        using Limbs = std::array<uint64_t, nLimbs>;
+
+        public:
+            constexpr explicit FixedInt(const long i) : limbs{}
+            {
+                limbs.fill(i < 0 ? ~uint64_t(0) : 0);
+                limbs[0] = static_cast<uint64_t>(i);
+            }
+
+            explicit FixedInt(const std::string& s) : limbs{}
+            {
+                size_t position = (!s.empty() && (s[0] == '-' || s[0] == '+')) ? 1 : 0;
+                if (position == s.size())
+                {
+                    throw std::invalid_argument("invalid integer literal: " + s);
+                }
+
+                Limbs magnitude{};
+                for (; position < s.size(); ++position)
+                {
+                    if (s[position] < '0' || s[position] > '9')
+                    {
+                        throw std::invalid_argument("invalid integer literal: " + s);
+                    }
+                    if (mulAddSmall(magnitude, 10, s[position] - '0') != 0)
+                    {
+                        throw OverflowError("integer literal does not fit into " + std::to_string(Bits)
+                                            + " bits: " + s);
+                    }
+                }
+                *this = fromMagnitude(magnitude, s[0] == '-');
+            }
+
+            // Comparable
+            constexpr std::strong_ordering operator<=>(const FixedInt& other) const
+            {
+                if (isNegative() != other.isNegative())
+                {
+                    return isNegative() ? std::strong_ordering::less : std::strong_ordering::greater;
+                }
+                // Two's complement values of the same sign compare like their unsigned limbs
+                return compareLimbs(limbs, other.limbs);
+            }
+
+            constexpr std::strong_ordering operator<=>(const long other) const
+            {
+                return *this <=> FixedInt(other);
+            }
+
+            constexpr bool operator==(const FixedInt&) const = default;
+
+            constexpr bool operator==(const long otherValue) const
+            {
+                return *this == FixedInt(otherValue);
+            }
+
+            // Arithmetic
+            constexpr FixedInt operator+(const FixedInt& other) const
+            {
+                FixedInt result(*this);
+                addLimbs(result.limbs, other.limbs);
+                // Overflow iff both operands have the same sign, but the result does not
+                if (isNegative() == other.isNegative() && result.isNegative() != isNegative())
+                {
+                    throw OverflowError("overflow in addition");
+                }
+                return result;
+            }
+
+            constexpr FixedInt operator-(const FixedInt& other) const
+            {
+                FixedInt result(*this);
+                subLimbs(result.limbs, other.limbs);
+                if (isNegative() != other.isNegative() && result.isNegative() != isNegative())
+                {
+                    throw OverflowError("overflow in subtraction");
+                }
+                return result;
+            }
+
+            constexpr FixedInt operator*(const FixedInt& other) const
+            {
+                Limbs product{};
+                if (!mulLimbs(magnitude(), other.magnitude(), product))
+                {
+                    throw OverflowError("overflow in multiplication");
+                }
+                return fromMagnitude(product, isNegative() != other.isNegative());
+            }
+
+            constexpr FixedInt operator%(const FixedInt& other) const
+            {
+                // Like mpz_class, the remainder has the sign of the dividend
+                Limbs remainder{};
+                divModLimbs(magnitude(), other.magnitude(), remainder);
+                return fromMagnitude(remainder, isNegative());
+            }
+
+            constexpr void operator+=(const FixedInt& other)
+            {
+                *this = *this + other;
+            }
+
+            constexpr void operator-=(const FixedInt& other)
+            {
+                *this = *this - other;
+            }
+
+            constexpr void operator*=(const FixedInt& other)
+            {
+                *this = *this * other;
+            }
+
+            constexpr void operator/=(const FixedInt& other)
+            {
+                Limbs remainder{};
+                Limbs quotient = divModLimbs(magnitude(), other.magnitude(), remainder);
+                *this = fromMagnitude(quotient, isNegative() != other.isNegative());
+            }
+
+            constexpr FixedInt operator-() const
+            {
+                FixedInt result(*this);
+                result.negate();
+                return result;
+            }
+
+            // In-place arithmetic
+            constexpr void addMul(const FixedInt& a, const FixedInt& b)
+            {
+                *this = *this + a * b;
+            }
+
+            constexpr void subMul(const FixedInt& a, const FixedInt& b)
+            {
+                *this = *this - a * b;
+            }
+
+            constexpr void negate()
+            {
+                if (isMinimum())
+                {
+                    throw OverflowError("overflow in negation");
+                }
+                negateLimbs(limbs);
+            }
+
+            constexpr void divExact(const FixedInt& divisor)
+            {
+                *this /= divisor;
+            }
+
+            constexpr void gcdWith(const FixedInt& other)
+            {
+                *this = gcd(*this, other);
+            }
+
+            constexpr bool isDivisibleBy(const FixedInt& divisor) const
+            {
+                // Like mpz_divisible_p, only zero is divisible by zero
+                if (divisor.isZero())
+                {
+                    return isZero();
+                }
+                Limbs remainder{};
+                divModLimbs(magnitude(), divisor.magnitude(), remainder);
+                return remainder == Limbs{};
+            }
+
+            static constexpr const FixedInt abs(const FixedInt& a)
+            {
+                return a.isNegative() ? -a : a;
+            }
+
+            constexpr std::strong_ordering absCmp(const FixedInt& other) const
+            {
+                return compareLimbs(magnitude(), other.magnitude());
+            }
+
+            // Hash of the absolute value
+            constexpr size_t absHash() const
+            {
+                const Limbs absolute = magnitude();
+                return hashMagnitude(nLimbs, [&absolute](size_t i) { return absolute[i]; });
+            }
+
+            // Calculate greatest common divisor
+            static constexpr const FixedInt gcd(const FixedInt& a, const FixedInt& b)
+            {
+                Limbs x = a.magnitude();
+                Limbs y = b.magnitude();
+                if (x == Limbs{} || y == Limbs{})
+                {
+                    addLimbs(x, y);
+                    return fromMagnitude(x, false);
+                }
+
+                // Binary GCD, finishing in 64 bit arithmetic once both values fit
+                size_t xZeros = countTrailingZeros(x);
+                size_t yZeros = countTrailingZeros(y);
+                shiftRight(x, xZeros);
+                shiftRight(y, yZeros);
+
+                while (!fitsOneLimb(x) || !fitsOneLimb(y))
+                {
+                    // Both values are odd here, so their difference is even
+                    if (compareLimbs(x, y) == std::strong_ordering::greater)
+                    {
+                        std::swap(x, y);
+                    }
+                    subLimbs(y, x);
+                    if (y == Limbs{})
+                    {
+                        break;
+                    }
+                    shiftRight(y, countTrailingZeros(y));
+                }
+
+                Limbs result{};
+                result[0] = std::gcd(x[0], y[0]);
+                if (y == Limbs{})
+                {
+                    result = x;
+                }
+
+                // Shifting the common power of two back in may overflow
+                size_t commonZeros = std::min(xZeros, yZeros);
+                if (bitLength(result) + commonZeros > Bits)
+                {
+                    throw OverflowError("overflow in gcd");
+                }
+                shiftLeft(result, commonZeros);
+                return fromMagnitude(result, false);
+            }
+
+            // Calculate symmetric modulo
+            static constexpr const FixedInt symMod(const FixedInt& a, const FixedInt& b)
+            {
+                FixedInt aModB = a % b;
+                if (aModB < 0)
+                {
+                    aModB += abs(b);
+                }
+
+                if (b > 0 && aModB < b - aModB)
+                {
+                    return aModB;
+                }
+                else
+                {
+                    return aModB - b;
+                }
+            }
+
+            // Stream operator
+            friend std::ostream& operator<<(std::ostream& os, const FixedInt& number)
+            {
+                // Split the magnitude into chunks of 19 decimal digits, least significant first
+                constexpr uint64_t chunkBase = 10'000'000'000'000'000'000u;
+
+                Limbs magnitude = number.magnitude();
+                std::vector<uint64_t> chunks;
+                do
+                {
+                    chunks.push_back(divModSmall(magnitude, chunkBase));
+                } while (magnitude != Limbs{});
+
+                if (number.isNegative())
+                {
+                    os << '-';
+                }
+                os << chunks.back();
+                for (auto chunk = chunks.rbegin() + 1; chunk != chunks.rend(); ++chunk)
+                {
+                    os << std::setw(19) << std::setfill('0') << *chunk;
+                }
+                return os;
+            }
+
+        private:
+            constexpr bool isNegative() const
+            {
+                return (limbs[nLimbs - 1] >> 63) != 0;
+            }
+
+            constexpr bool isZero() const
+            {
+                return limbs == Limbs{};
+            }
+
+            constexpr bool isMinimum() const
+            {
+                return limbs == minimumMagnitude();
+            }
+
+            /**
+             * @return the absolute value as unsigned limbs. This does not overflow, not even for
+             *         the minimum value.
+             */
+            constexpr Limbs magnitude() const
+            {
+                Limbs result = limbs;
+                if (isNegative())
+                {
+                    negateLimbs(result);
+                }
+                return result;
+            }
+
+            /**
+             * Creates a number from its absolute value and sign.
+             * @throws OverflowError if the value does not fit.
+             */
+            static constexpr FixedInt fromMagnitude(const Limbs& magnitude, const bool negative)
+            {
+                FixedInt result(0);
+                result.limbs = magnitude;
+                if (result.isNegative() && !(negative && magnitude == minimumMagnitude()))
+                {
+                    throw OverflowError("value does not fit into " + std::to_string(Bits) + " bits");
+                }
+                if (negative)
+                {
+                    negateLimbs(result.limbs);
+                }
+                return result;
+            }
+
+            static constexpr Limbs minimumMagnitude()
+            {
+                Limbs result{};
+                result[nLimbs - 1] = uint64_t(1) << 63;
+                return result;
+            }
+
+            static constexpr bool fitsOneLimb(const Limbs& a)
+            {
+                for (size_t i = 1; i < nLimbs; ++i)
+                {
+                    if (a[i] != 0)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static constexpr size_t bitLength(const Limbs& a)
+            {
+                for (size_t i = nLimbs; i-- > 0;)
+                {
+                    if (a[i] != 0)
+                    {
+                        return 64 * i + std::bit_width(a[i]);
+                    }
+                }
+                return 0;
+            }
+
+            static constexpr std::strong_ordering compareLimbs(const Limbs& a, const Limbs& b)
+            {
+                for (size_t i = nLimbs; i-- > 0;)
+                {
+                    if (a[i] != b[i])
+                    {
+                        return a[i] <=> b[i];
+                    }
+                }
+                return std::strong_ordering::equal;
+            }
+
+            // a += b modulo 2^Bits
+            static constexpr void addLimbs(Limbs& a, const Limbs& b)
+            {
+                uint64_t carry = 0;
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    const uint64_t sum = a[i] + b[i];
+                    const uint64_t carriedSum = sum + carry;
+                    carry = (sum < a[i]) | (carriedSum < sum);
+                    a[i] = carriedSum;
+                }
+            }
+
+            // a -= b modulo 2^Bits
+            static constexpr void subLimbs(Limbs& a, const Limbs& b)
+            {
+                uint64_t borrow = 0;
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    const uint64_t difference = a[i] - b[i];
+                    const uint64_t borrowedDifference = difference - borrow;
+                    borrow = (a[i] < b[i]) | (difference < borrow);
+                    a[i] = borrowedDifference;
+                }
+            }
+
+            // a = -a modulo 2^Bits
+            static constexpr void negateLimbs(Limbs& a)
+            {
+                uint64_t carry = 1;
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    a[i] = ~a[i] + carry;
+                    carry = carry & (a[i] == 0);
+                }
+            }
+
+            /**
+             * Multiplies two unsigned values.
+             * @return false if the product does not fit into Bits bits.
+             */
+            static constexpr bool mulLimbs(const Limbs& a, const Limbs& b, Limbs& product)
+            {
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    if (a[i] == 0)
+                    {
+                        continue;
+                    }
+
+                    uint64_t carry = 0;
+                    for (size_t j = 0; i + j < nLimbs; ++j)
+                    {
+                        product[i + j] = limbs::mulAdd(a[i], b[j], product[i + j], carry, carry);
+                    }
+
+                    // Everything that would be shifted out of the product is an overflow
+                    if (carry != 0)
+                    {
+                        return false;
+                    }
+                    for (size_t j = nLimbs - i; j < nLimbs; ++j)
+                    {
+                        if (b[j] != 0)
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            /**
+             * a = a * factor + summand
+             * @return the limb that is carried out of a
+             */
+            static constexpr uint64_t mulAddSmall(Limbs& a, const uint64_t factor, const uint64_t summand)
+            {
+                uint64_t carry = summand;
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    a[i] = limbs::mulAdd(a[i], factor, carry, 0, carry);
+                }
+                return carry;
+            }
+
+            /**
+             * a = a / divisor
+             * @return the remainder
+             */
+            static constexpr uint64_t divModSmall(Limbs& a, const uint64_t divisor)
+            {
+                uint64_t remainder = 0;
+                for (size_t i = nLimbs; i-- > 0;)
+                {
+                    a[i] = limbs::divWide(remainder, a[i], divisor, remainder);
+                }
+                return remainder;
+            }
+
+            static constexpr size_t countTrailingZeros(const Limbs& a)
+            {
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    if (a[i] != 0)
+                    {
+                        return 64 * i + std::countr_zero(a[i]);
+                    }
+                }
+                return Bits;
+            }
+
+            // a <<= shift and a >>= shift, for shift < Bits
+            static constexpr void shiftLeft(Limbs& a, const size_t shift)
+            {
+                const size_t limbShift = shift / 64;
+                const size_t bitShift = shift % 64;
+                for (size_t i = nLimbs; i-- > 0;)
+                {
+                    uint64_t limb = i >= limbShift ? a[i - limbShift] << bitShift : 0;
+                    if (bitShift != 0 && i > limbShift)
+                    {
+                        limb |= a[i - limbShift - 1] >> (64 - bitShift);
+                    }
+                    a[i] = limb;
+                }
+            }
+
+            static constexpr void shiftRight(Limbs& a, const size_t shift)
+            {
+                const size_t limbShift = shift / 64;
+                const size_t bitShift = shift % 64;
+                for (size_t i = 0; i < nLimbs; ++i)
+                {
+                    uint64_t limb = i + limbShift < nLimbs ? a[i + limbShift] >> bitShift : 0;
+                    if (bitShift != 0 && i + limbShift + 1 < nLimbs)
+                    {
+                        limb |= a[i + limbShift + 1] << (64 - bitShift);
+                    }
+                    a[i] = limb;
+                }
+            }
+
+            // a <<= 1 and a >>= 1
+            static constexpr void shiftLeftOne(Limbs& a)
+            {
+                for (size_t i = nLimbs; i-- > 1;)
+                {
+                    a[i] = (a[i] << 1) | (a[i - 1] >> 63);
+                }
+                a[0] <<= 1;
+            }
+
+            static constexpr void shiftRightOne(Limbs& a)
+            {
+                for (size_t i = 0; i + 1 < nLimbs; ++i)
+                {
+                    a[i] = (a[i] >> 1) | (a[i + 1] << 63);
+                }
+                a[nLimbs - 1] >>= 1;
+            }
+
+            /**
+             * Divides two unsigned values.
+             * @return the quotient, the remainder is stored in the given limbs.
+             */
+            static constexpr Limbs divModLimbs(const Limbs& a, const Limbs& b, Limbs& remainder)
+            {
+                if (b == Limbs{})
+                {
+                    throw std::domain_error("division by zero");
+                }
+
+                Limbs quotient = a;
+                if (fitsOneLimb(b))
+                {
+                    remainder = Limbs{};
+                    remainder[0] = divModSmall(quotient, b[0]);
+                    return quotient;
+                }
+
+                // Binary long division, one step per bit that a is longer than b
+                quotient = Limbs{};
+                remainder = a;
+                if (compareLimbs(a, b) == std::strong_ordering::less)
+                {
+                    return quotient;
+                }
+
+                size_t shift = bitLength(a) - bitLength(b);
+                Limbs divisor = b;
+                for (size_t i = 0; i < shift; ++i)
+                {
+                    shiftLeftOne(divisor);
+                }
+
+                for (size_t bit = shift + 1; bit-- > 0;)
+                {
+                    if (compareLimbs(remainder, divisor) != std::strong_ordering::less)
+                    {
+                        subLimbs(remainder, divisor);
+                        quotient[bit / 64] |= uint64_t(1) << (bit % 64);
+                    }
+                    shiftRightOne(divisor);
+                }
+                return quotient;
+            }
+
+        private:
+            Limbs limbs;
+    };
+}
@@ -0,0 +1,219 @@
+#include "GmpArena.hpp"
+
+#include <gmp.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace diophantus::model::numeric
+{
+    GmpArena::GmpArena(size_t chunkSize) :
+        chunkSize(chunkSize)
+    {
+        assert(std::has_single_bit(chunkSize));
+    }
+
+    GmpArena::~GmpArena()
+    {
+        for (void* chunk : chunks)
+        {
+            std::free(chunk);
+        }
+    }
+
+    size_t GmpArena::getSizeClass(size_t size)
+    {
+        size_t payloadSize = std::max(size, minClassSize);
+        return std::bit_width(std::bit_ceil(payloadSize) / minClassSize) - 1;
+    }
+
+    void* GmpArena::allocate(size_t size)
+    {
+        ++nAllocations;
+
+        size_t sizeClass = getSizeClass(size);
+        if (sizeClass >= nSizeClasses)
+        {
+            return allocateLarge(size);
+        }
+
+        // Reuse a block of the same size class if one was freed before
+        if (freeLists[sizeClass] != nullptr)
+        {
+            void* block = freeLists[sizeClass];
+            freeLists[sizeClass] = *static_cast<void**>(block);
+            return block;
+        }
+
+        size_t capacity = minClassSize << sizeClass;
+        size_t blockSize = sizeof(BlockHeader) + capacity;
+        if (bumpPointer == nullptr || static_cast<size_t>(bumpEnd - bumpPointer) < blockSize)
+        {
+            bumpPointer = static_cast<std::byte*>(allocateChunk(chunkSize));
+            bumpEnd = bumpPointer + chunkSize;
+        }
+
+        auto* header = new (bumpPointer) BlockHeader {.sizeClass = sizeClass, .capacity = capacity};
+        bumpPointer += blockSize;
+        return header + 1;
+    }
+
+    void* GmpArena::allocateLarge(size_t size)
+    {
+        // Large blocks get chunks of their own, rounded up to the chunk size
+        size_t blockSize = sizeof(BlockHeader) + size;
+        size_t reservedSize = (blockSize + chunkSize - 1) & ~(chunkSize - 1);
+
+        auto* header = new (allocateChunk(reservedSize)) BlockHeader {
+            .sizeClass = largeSizeClass,
+            .capacity = reservedSize - sizeof(BlockHeader)
+        };
+        return header + 1;
+    }
+
+    void* GmpArena::allocateChunk(size_t size)
+    {
+        void* chunk = std::aligned_alloc(chunkSize, size);
+        if (chunk == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        chunks.push_back(chunk);
+        chunkBases.insert(reinterpret_cast<uintptr_t>(chunk));
+        reservedBytes += size;
+        return chunk;
+    }
+
+    void* GmpArena::reallocate(void* ptr, size_t newSize)
+    {
+        const auto* header = static_cast<const BlockHeader*>(ptr) - 1;
+        if (newSize <= header->capacity)
+        {
+            return ptr;
+        }
+
+        void* newPtr = allocate(newSize);
+        std::memcpy(newPtr, ptr, header->capacity);
+        deallocate(ptr);
+        return newPtr;
+    }
+
+    void GmpArena::deallocate(void* ptr)
+    {
+        const auto* header = static_cast<const BlockHeader*>(ptr) - 1;
+        if (header->sizeClass == largeSizeClass)
+        {
+            // Large blocks are only released together with the arena
+            return;
+        }
+
+        *static_cast<void**>(ptr) = freeLists[header->sizeClass];
+        freeLists[header->sizeClass] = ptr;
+    }
+
+    bool GmpArena::owns(const void* ptr) const
+    {
+        // Every block starts in a chunk-aligned region, so masking yields the chunk base
+        auto base = reinterpret_cast<uintptr_t>(ptr) & ~(chunkSize - 1);
+        return chunkBases.contains(base);
+    }
+
+    size_t GmpArena::getAllocationCount() const
+    {
+        return nAllocations;
+    }
+
+    size_t GmpArena::getReservedBytes() const
+    {
+        return reservedBytes;
+    }
+
+
+    // The innermost active scope
+    static GmpArenaScope* activeScope = nullptr;
+
+    GmpArenaScope::GmpArenaScope(GmpArena& arena) :
+        arena(arena),
+        previousScope(activeScope)
+    {
+        mp_get_memory_functions(&previousAllocate, &previousReallocate, &previousFree);
+        install();
+    }
+
+    GmpArenaScope::~GmpArenaScope()
+    {
+        uninstall();
+    }
+
+    void GmpArenaScope::install()
+    {
+        activeScope = this;
+        mp_set_memory_functions(&GmpArenaScope::allocate,
+                                &GmpArenaScope::reallocate,
+                                &GmpArenaScope::deallocate);
+    }
+
+    void GmpArenaScope::uninstall()
+    {
+        activeScope = previousScope;
+        mp_set_memory_functions(previousAllocate, previousReallocate, previousFree);
+    }
+
+    void* GmpArenaScope::allocate(size_t size)
+    {
+        return activeScope->arena.allocate(size);
+    }
+
+    void* GmpArenaScope::reallocate(void* ptr, size_t oldSize, size_t newSize)
+    {
+        if (activeScope->arena.owns(ptr))
+        {
+            return activeScope->arena.reallocate(ptr, newSize);
+        }
+
+        // Move memory of other allocators into the arena
+        void* newPtr = activeScope->arena.allocate(newSize);
+        std::memcpy(newPtr, ptr, std::min(oldSize, newSize));
+        deallocate(ptr, oldSize);
+        return newPtr;
+    }
+
+    void GmpArenaScope::deallocate(void* ptr, size_t size)
+    {
+        // Hand the memory back to the arena that owns it, or to the allocator below all arenas
+        GmpArenaScope* scope = activeScope;
+        for (; scope->previousScope != nullptr; scope = scope->previousScope)
+        {
+            if (scope->arena.owns(ptr))
+            {
+                scope->arena.deallocate(ptr);
+                return;
+            }
+        }
+
+        if (scope->arena.owns(ptr))
+        {
+            scope->arena.deallocate(ptr);
+        }
+        else
+        {
+            scope->previousFree(ptr, size);
+        }
+    }
+
+    GmpArenaScope::Suspension::Suspension(GmpArenaScope& scope) :
+        scope(scope)
+    {
+        scope.uninstall();
+    }
+
+    GmpArenaScope::Suspension::~Suspension()
+    {
+        scope.install();
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace diophantus::model::numeric
+{
+    /**
+     * Bump allocator with size-class free lists for GMP limb storage. All memory is obtained in
+     * large chunks and only returned to the system when the arena is destroyed.
+     */
+    class GmpArena
+    {
+        public:
+            static constexpr size_t defaultChunkSize = size_t(1) << 20;
+
+            /**
+             * @param chunkSize
+             *      Size of the chunks that memory is obtained in. Must be a power of two.
+             */
+            explicit GmpArena(size_t chunkSize = defaultChunkSize);
+            ~GmpArena();
+
+            GmpArena(const GmpArena&) = delete;
+            GmpArena& operator=(const GmpArena&) = delete;
+
+            void* allocate(size_t size);
+            void* reallocate(void* ptr, size_t newSize);
+            void deallocate(void* ptr);
+
+            /**
+             * @return true if the given pointer was handed out by this arena.
+             */
+            bool owns(const void* ptr) const;
+
+            // number of allocations served by this arena
+            size_t getAllocationCount() const;
+
+            // number of bytes reserved from the system
+            size_t getReservedBytes() const;
+
+        private:
+            struct BlockHeader
+            {
+                uint64_t sizeClass;
+                uint64_t capacity;
+            };
+
+            static constexpr size_t minClassSize = 16;
+            static constexpr size_t nSizeClasses = 13;
+            static constexpr size_t largeSizeClass = nSizeClasses;
+
+            static size_t getSizeClass(size_t size);
+
+            void* allocateChunk(size_t size);
+            void* allocateLarge(size_t size);
+
+        private:
+            const size_t chunkSize;
+
+            std::vector<void*> chunks;
+            std::unordered_set<uintptr_t> chunkBases;
+
+            std::byte* bumpPointer = nullptr;
+            std::byte* bumpEnd = nullptr;
+
+            std::array<void*, nSizeClasses> freeLists{};
+
+            size_t nAllocations = 0;
+            size_t reservedBytes = 0;
+    };
+
+    /**
+     * Installs a GmpArena as GMP's memory allocator (via mp_set_memory_functions) for the
+     * lifetime of the scope, and restores the previous allocator afterwards.
+     *
+     * Every mpz value that was allocated or reallocated inside the scope lives in the arena, so it
+     * has to be destroyed before the arena is. Memory that was allocated before the scope is
+     * handed back to the previous allocator when GMP releases it. Since GMP's memory functions
+     * are global, scopes must not be used from multiple threads at the same time.
+     */
+    class GmpArenaScope
+    {
+        public:
+            explicit GmpArenaScope(GmpArena& arena);
+            ~GmpArenaScope();
+
+            GmpArenaScope(const GmpArenaScope&) = delete;
+            GmpArenaScope& operator=(const GmpArenaScope&) = delete;
+
+            /**
+             * Temporarily reinstalls the previous allocator, e.g. to copy results that have to
+             * outlive the arena. No arena memory must be released while suspended.
+             */
+            class Suspension
+            {
+                public:
+                    explicit Suspension(GmpArenaScope& scope);
+                    ~Suspension();
+
+                private:
+                    GmpArenaScope& scope;
+            };
+
+        private:
+            using AllocateFunction = void* (*)(size_t);
+            using ReallocateFunction = void* (*)(void*, size_t, size_t);
+            using FreeFunction = void (*)(void*, size_t);
+
+            static void* allocate(size_t size);
+            static void* reallocate(void* ptr, size_t oldSize, size_t newSize);
+            static void deallocate(void* ptr, size_t size);
+
+            void install();
+            void uninstall();
+
+        private:
+            GmpArena& arena;
+            GmpArenaScope* previousScope;
+
+            AllocateFunction previousAllocate;
+            ReallocateFunction previousReallocate;
+            FreeFunction previousFree;
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BigInt.hpp"
+
 #include <cstdint>
 #include <gmp.h>
 #include <gmpxx.h>
@@ -11,9 +13,14 @@ namespace diophantus::model::numeric
     class GmpBigInt
     {
         public:
-            explicit GmpBigInt(const mpz_class& value) : value(std::move(value)) {}
+            explicit GmpBigInt(mpz_class value) : value(std::move(value)) {}
             explicit GmpBigInt(const long i) : value(i) {}
-            explicit GmpBigInt(const std::string& s) : value(std::move(s)) {}
+            explicit GmpBigInt(const std::string& s) : value(s) {}
+
+            const mpz_class& get() const
+            {
+                return value;
+            }
 
             // Comparable
             std::strong_ordering operator<=>(const GmpBigInt& other) const
@@ -101,6 +108,37 @@ namespace diophantus::model::numeric
                 return GmpBigInt(-value);
             }
 
+            // In-place arithmetic
+            void addMul(const GmpBigInt& a, const GmpBigInt& b)
+            {
+                mpz_addmul(value.get_mpz_t(), a.value.get_mpz_t(), b.value.get_mpz_t());
+            }
+
+            void subMul(const GmpBigInt& a, const GmpBigInt& b)
+            {
+                mpz_submul(value.get_mpz_t(), a.value.get_mpz_t(), b.value.get_mpz_t());
+            }
+
+            void negate()
+            {
+                mpz_neg(value.get_mpz_t(), value.get_mpz_t());
+            }
+
+            void divExact(const GmpBigInt& divisor)
+            {
+                mpz_divexact(value.get_mpz_t(), value.get_mpz_t(), divisor.value.get_mpz_t());
+            }
+
+            void gcdWith(const GmpBigInt& other)
+            {
+                mpz_gcd(value.get_mpz_t(), value.get_mpz_t(), other.value.get_mpz_t());
+            }
+
+            bool isDivisibleBy(const GmpBigInt& divisor) const
+            {
+                return mpz_divisible_p(value.get_mpz_t(), divisor.value.get_mpz_t()) != 0;
+            }
+
             static const GmpBigInt abs(const GmpBigInt& a)
             {
                 mpz_class absVal;
@@ -116,6 +154,14 @@ namespace diophantus::model::numeric
                                            : std::strong_ordering::less);
             }
 
+            // Hash of the absolute value
+            size_t absHash() const
+            {
+                static_assert(sizeof(mp_limb_t) == sizeof(uint64_t), "expected 64 bit GMP limbs");
+                const mpz_srcptr mpz = value.get_mpz_t();
+                return hashMagnitude(mpz_size(mpz), [mpz](size_t i) { return mpz_getlimbn(mpz, i); });
+            }
+
             // Calculate greatest common divisor
             static const GmpBigInt gcd(const GmpBigInt& a, const GmpBigInt& b)
             {
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "BigInt.hpp"
+
+#include <cstdint>
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include <compare>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <string>
+
+namespace diophantus::model::numeric
+{
+    /**
+     * Integer type that stores its value inline as an int64_t and only switches to a
+     * heap-allocated mpz_class if a result does not fit into 64 bits. Values are always kept
+     * normalized: the mpz representation is only used for values outside of the int64_t range.
+     */
+    class HybridBigInt
+    {
+        static_assert(sizeof(long) == sizeof(int64_t), "HybridBigInt requires 64 bit longs");
+
+        public:
+            explicit HybridBigInt(const long i) : small(i) {}
+            explicit HybridBigInt(mpz_class value) : small(0), big(std::make_unique<mpz_class>(std::move(value)))
+            {
+                normalize();
+            }
+            explicit HybridBigInt(const std::string& s) : HybridBigInt(mpz_class(s)) {}
+
+            HybridBigInt(const HybridBigInt& other) :
+                small(other.small),
+                big(other.big ? std::make_unique<mpz_class>(*other.big) : nullptr)
+            {}
+
+            HybridBigInt(HybridBigInt&& other) noexcept = default;
+
+            HybridBigInt& operator=(const HybridBigInt& other)
+            {
+                if (this != &other)
+                {
+                    small = other.small;
+                    big = other.big ? std::make_unique<mpz_class>(*other.big) : nullptr;
+                }
+                return *this;
+            }
+
+            HybridBigInt& operator=(HybridBigInt&& other) noexcept = default;
+
+            /**
+             * @return true if the value is stored inline, i.e. fits into an int64_t.
+             */
+            bool isSmall() const
+            {
+                return !big;
+            }
+
+            // Comparable
+            std::strong_ordering operator<=>(const HybridBigInt& other) const
+            {
+                if (isSmall() && other.isSmall())
+                {
+                    return small <=> other.small;
+                }
+                else if (isSmall())
+                {
+                    // The other value is outside of the int64_t range, its sign decides
+                    return mpz_sgn(other.big->get_mpz_t()) > 0 ? std::strong_ordering::less
+                                                               : std::strong_ordering::greater;
+                }
+                else if (other.isSmall())
+                {
+                    return mpz_sgn(big->get_mpz_t()) > 0 ? std::strong_ordering::greater
+                                                         : std::strong_ordering::less;
+                }
+                return toOrdering(mpz_cmp(big->get_mpz_t(), other.big->get_mpz_t()));
+            }
+
+            std::strong_ordering operator<=>(const long other) const
+            {
+                if (isSmall())
+                {
+                    return small <=> other;
+                }
+                return mpz_sgn(big->get_mpz_t()) > 0 ? std::strong_ordering::greater
+                                                     : std::strong_ordering::less;
+            }
+
+            bool operator==(const HybridBigInt& other) const
+            {
+                if (isSmall() != other.isSmall())
+                {
+                    return false;
+                }
+                return isSmall() ? small == other.small : *big == *other.big;
+            }
+
+            bool operator==(const long otherValue) const
+            {
+                return isSmall() && small == otherValue;
+            }
+
+            // Arithmetic
+            HybridBigInt operator+(const HybridBigInt& other) const
+            {
+                HybridBigInt result(*this);
+                result += other;
+                return result;
+            }
+
+            HybridBigInt operator-(const HybridBigInt& other) const
+            {
+                HybridBigInt result(*this);
+                result -= other;
+                return result;
+            }
+
+            HybridBigInt operator*(const HybridBigInt& other) const
+            {
+                HybridBigInt result(*this);
+                result *= other;
+                return result;
+            }
+
+            HybridBigInt operator%(const HybridBigInt& other) const
+            {
+                if (isSmall() && other.isSmall())
+                {
+                    // INT64_MIN % -1 overflows, but is zero
+                    return HybridBigInt(other.small == -1 ? 0 : small % other.small);
+                }
+                return HybridBigInt(mpz_class(toMpz() % other.toMpz()));
+            }
+
+            void operator+=(const HybridBigInt& other)
+            {
+                int64_t result;
+                if (isSmall() && other.isSmall() && !__builtin_add_overflow(small, other.small, &result))
+                {
+                    small = result;
+                    return;
+                }
+                assignBig(mpz_class(toMpz() + other.toMpz()));
+            }
+
+            void operator-=(const HybridBigInt& other)
+            {
+                int64_t result;
+                if (isSmall() && other.isSmall() && !__builtin_sub_overflow(small, other.small, &result))
+                {
+                    small = result;
+                    return;
+                }
+                assignBig(mpz_class(toMpz() - other.toMpz()));
+            }
+
+            void operator*=(const HybridBigInt& other)
+            {
+                int64_t result;
+                if (isSmall() && other.isSmall() && !__builtin_mul_overflow(small, other.small, &result))
+                {
+                    small = result;
+                    return;
+                }
+                assignBig(mpz_class(toMpz() * other.toMpz()));
+            }
+
+            void operator/=(const HybridBigInt& other)
+            {
+                // INT64_MIN / -1 is the only quotient of two int64_t values that overflows
+                if (isSmall() && other.isSmall() && !(small == minSmall && other.small == -1))
+                {
+                    small /= other.small;
+                    return;
+                }
+                assignBig(mpz_class(toMpz() / other.toMpz()));
+            }
+
+            HybridBigInt operator-() const
+            {
+                if (isSmall() && small != minSmall)
+                {
+                    return HybridBigInt(-small);
+                }
+                return HybridBigInt(mpz_class(-toMpz()));
+            }
+
+            // In-place arithmetic
+            void addMul(const HybridBigInt& a, const HybridBigInt& b)
+            {
+                int64_t product;
+                if (isSmall() && a.isSmall() && b.isSmall()
+                    && !__builtin_mul_overflow(a.small, b.small, &product)
+                    && !__builtin_add_overflow(small, product, &product))
+                {
+                    small = product;
+                    return;
+                }
+                mpz_class result = toMpz();
+                mpz_addmul(result.get_mpz_t(), a.toMpz().get_mpz_t(), b.toMpz().get_mpz_t());
+                assignBig(std::move(result));
+            }
+
+            void subMul(const HybridBigInt& a, const HybridBigInt& b)
+            {
+                int64_t product;
+                if (isSmall() && a.isSmall() && b.isSmall()
+                    && !__builtin_mul_overflow(a.small, b.small, &product)
+                    && !__builtin_sub_overflow(small, product, &product))
+                {
+                    small = product;
+                    return;
+                }
+                mpz_class result = toMpz();
+                mpz_submul(result.get_mpz_t(), a.toMpz().get_mpz_t(), b.toMpz().get_mpz_t());
+                assignBig(std::move(result));
+            }
+
+            void negate()
+            {
+                if (isSmall() && small != minSmall)
+                {
+                    small = -small;
+                    return;
+                }
+                assignBig(mpz_class(-toMpz()));
+            }
+
+            void divExact(const HybridBigInt& divisor)
+            {
+                if (isSmall() && divisor.isSmall())
+                {
+                    *this /= divisor;
+                    return;
+                }
+                mpz_class result;
+                mpz_divexact(result.get_mpz_t(), toMpz().get_mpz_t(), divisor.toMpz().get_mpz_t());
+                assignBig(std::move(result));
+            }
+
+            void gcdWith(const HybridBigInt& other)
+            {
+                *this = gcd(*this, other);
+            }
+
+            bool isDivisibleBy(const HybridBigInt& divisor) const
+            {
+                if (isSmall() && divisor.isSmall())
+                {
+                    // Like mpz_divisible_p, only zero is divisible by zero
+                    return divisor.small == 0 ? small == 0
+                                              : divisor.small == -1 || small % divisor.small == 0;
+                }
+                return mpz_divisible_p(toMpz().get_mpz_t(), divisor.toMpz().get_mpz_t()) != 0;
+            }
+
+            static const HybridBigInt abs(const HybridBigInt& a)
+            {
+                return a < 0 ? -a : a;
+            }
+
+            std::strong_ordering absCmp(const HybridBigInt& other) const
+            {
+                if (isSmall() && other.isSmall())
+                {
+                    return magnitude(small) <=> magnitude(other.small);
+                }
+                else if (isSmall())
+                {
+                    return toOrdering(-mpz_cmpabs_ui(other.big->get_mpz_t(), magnitude(small)));
+                }
+                else if (other.isSmall())
+                {
+                    return toOrdering(mpz_cmpabs_ui(big->get_mpz_t(), magnitude(other.small)));
+                }
+                return toOrdering(mpz_cmpabs(big->get_mpz_t(), other.big->get_mpz_t()));
+            }
+
+            // Hash of the absolute value
+            size_t absHash() const
+            {
+                if (isSmall())
+                {
+                    const uint64_t smallMagnitude = magnitude(small);
+                    return hashMagnitude(1, [smallMagnitude](size_t) { return smallMagnitude; });
+                }
+                const mpz_srcptr mpz = big->get_mpz_t();
+                return hashMagnitude(mpz_size(mpz), [mpz](size_t i) { return mpz_getlimbn(mpz, i); });
+            }
+
+            // Calculate greatest common divisor
+            static const HybridBigInt gcd(const HybridBigInt& a, const HybridBigInt& b)
+            {
+                if (a.isSmall() && b.isSmall())
+                {
+                    uint64_t gcd = std::gcd(magnitude(a.small), magnitude(b.small));
+                    if (gcd <= static_cast<uint64_t>(maxSmall))
+                    {
+                        return HybridBigInt(static_cast<long>(gcd));
+                    }
+                }
+
+                mpz_class gcd;
+                mpz_gcd(gcd.get_mpz_t(), a.toMpz().get_mpz_t(), b.toMpz().get_mpz_t());
+                return HybridBigInt(gcd);
+            }
+
+            // Calculate symmetric modulo
+            static const HybridBigInt symMod(const HybridBigInt& a, const HybridBigInt& b)
+            {
+                if (a.isSmall() && b.isSmall() && b.small > 0)
+                {
+                    int64_t aModB = a.small % b.small;
+                    if (aModB < 0)
+                    {
+                        aModB += b.small;
+                    }
+                    return HybridBigInt(aModB < b.small - aModB ? aModB : aModB - b.small);
+                }
+
+                mpz_class aModB;
+                mpz_mod(aModB.get_mpz_t(), a.toMpz().get_mpz_t(), b.toMpz().get_mpz_t());
+                mpz_class bValue = b.toMpz();
+                if (2 * aModB < bValue)
+                {
+                    return HybridBigInt(aModB);
+                }
+                else
+                {
+                    return HybridBigInt(mpz_class(aModB - bValue));
+                }
+            }
+
+            // Stream operator
+            friend std::ostream& operator<<(std::ostream& os, const HybridBigInt& bigInt)
+            {
+                if (bigInt.isSmall())
+                {
+                    os << bigInt.small;
+                }
+                else
+                {
+                    os << *bigInt.big;
+                }
+                return os;
+            }
+
+        private:
+            static constexpr int64_t minSmall = std::numeric_limits<int64_t>::min();
+            static constexpr int64_t maxSmall = std::numeric_limits<int64_t>::max();
+
+            static uint64_t magnitude(const int64_t value)
+            {
+                // Negate in unsigned arithmetic, so that INT64_MIN does not overflow
+                return value < 0 ? -static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            }
+
+            static std::strong_ordering toOrdering(const int cmp)
+            {
+                return cmp == 0 ? std::strong_ordering::equal
+                                : (cmp > 0 ? std::strong_ordering::greater
+                                           : std::strong_ordering::less);
+            }
+
+            mpz_class toMpz() const
+            {
+                return isSmall() ? mpz_class(static_cast<long>(small)) : *big;
+            }
+
+            void assignBig(mpz_class&& value)
+            {
+                if (big)
+                {
+                    *big = std::move(value);
+                }
+                else
+                {
+                    big = std::make_unique<mpz_class>(std::move(value));
+                }
+                normalize();
+            }
+
+            /**
+             * Switches back to the inline representation if the value fits into an int64_t.
+             */
+            void normalize()
+            {
+                if (big && mpz_fits_slong_p(big->get_mpz_t()))
+                {
+                    small = mpz_get_si(big->get_mpz_t());
+                    big.reset();
+                }
+            }
+
+        private:
+            int64_t small;
+            std::unique_ptr<mpz_class> big;
+    };
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace diophantus::model::numeric
+{
+    /**
+     * Thrown by fixed-width number types if the result of an operation can not be represented.
+     */
+    class OverflowError : public std::overflow_error
+    {
+        public:
+            using std::overflow_error::overflow_error;
+    };
+}
@@ -3,15 +3,20 @@
 #include <diophantus/model/Variable.hpp>
 #include <diophantus/model/Equation.hpp>
 #include <diophantus/model/Term.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
+#include <diophantus/model/numeric/FixedInt.hpp>
+#include <diophantus/model/numeric/HybridBigInt.hpp>
 
 #include <cassert>
+#include <cstdint>
 
 
 namespace diophantus::model
 {
-    std::vector<unsigned int> make_variables(size_t nVariables)
+    template <VariableId VarT>
+    std::vector<VarT> make_variables(size_t nVariables)
     {
-        std::vector<unsigned int> variables;
+        std::vector<VarT> variables;
         variables.reserve(nVariables);
 
         for (size_t i = 0; i < nVariables; ++i)
@@ -22,27 +27,101 @@ namespace diophantus::model
         return variables;
     }
 
-    template <numeric::BigInt NumT>
-    Equation<NumT> makeEquation(const std::vector<Variable>& variables,
-                                const std::vector<long>& coefficients,
-                                const long rightSide)
+    template std::vector<std::uint16_t> make_variables<std::uint16_t>(size_t nVariables);
+    template std::vector<std::uint32_t> make_variables<std::uint32_t>(size_t nVariables);
+    template std::vector<std::uint64_t> make_variables<std::uint64_t>(size_t nVariables);
+
+    template <numeric::BigInt NumT, VariableId VarT>
+    Equation<NumT, VarT> makeEquation(const std::vector<VarT>& variables,
+                                      const std::vector<long>& coefficients,
+                                      const long rightSide)
     {
         assert(coefficients.size() == variables.size());
 
-        std::vector<Term<NumT>> terms;
+        std::vector<Term<NumT, VarT>> terms;
         for (size_t i = 0; i < coefficients.size(); ++i)
         {
             if (coefficients[i] != 0)
             {
-                Term<NumT> t(coefficients[i], variables[i]);
+                Term<NumT, VarT> t(coefficients[i], variables[i]);
                 terms.push_back(std::move(t));
             }
         };
         return Equation(Sum(terms), rightSide);
     }
 
-    template Equation<numeric::GmpBigInt> makeEquation<numeric::GmpBigInt>(
-        const std::vector<Variable> &variables,
+    template Equation<numeric::GmpBigInt, std::uint16_t> makeEquation<numeric::GmpBigInt, std::uint16_t>(
+        const std::vector<std::uint16_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::GmpBigInt, std::uint32_t> makeEquation<numeric::GmpBigInt, std::uint32_t>(
+        const std::vector<std::uint32_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::GmpBigInt, std::uint64_t> makeEquation<numeric::GmpBigInt, std::uint64_t>(
+        const std::vector<std::uint64_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::HybridBigInt, std::uint16_t> makeEquation<numeric::HybridBigInt, std::uint16_t>(
+        const std::vector<std::uint16_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::HybridBigInt, std::uint32_t> makeEquation<numeric::HybridBigInt, std::uint32_t>(
+        const std::vector<std::uint32_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::HybridBigInt, std::uint64_t> makeEquation<numeric::HybridBigInt, std::uint64_t>(
+        const std::vector<std::uint64_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::CheckedInt64, std::uint16_t> makeEquation<numeric::CheckedInt64, std::uint16_t>(
+        const std::vector<std::uint16_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::CheckedInt64, std::uint32_t> makeEquation<numeric::CheckedInt64, std::uint32_t>(
+        const std::vector<std::uint32_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::CheckedInt64, std::uint64_t> makeEquation<numeric::CheckedInt64, std::uint64_t>(
+        const std::vector<std::uint64_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::FixedInt<128>, std::uint16_t> makeEquation<numeric::FixedInt<128>, std::uint16_t>(
+        const std::vector<std::uint16_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::FixedInt<128>, std::uint32_t> makeEquation<numeric::FixedInt<128>, std::uint32_t>(
+        const std::vector<std::uint32_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::FixedInt<128>, std::uint64_t> makeEquation<numeric::FixedInt<128>, std::uint64_t>(
+        const std::vector<std::uint64_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::FixedInt<256>, std::uint16_t> makeEquation<numeric::FixedInt<256>, std::uint16_t>(
+        const std::vector<std::uint16_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::FixedInt<256>, std::uint32_t> makeEquation<numeric::FixedInt<256>, std::uint32_t>(
+        const std::vector<std::uint32_t> &variables,
+        const std::vector<long> &coefficients,
+        const long rightSide);
+
+    template Equation<numeric::FixedInt<256>, std::uint64_t> makeEquation<numeric::FixedInt<256>, std::uint64_t>(
+        const std::vector<std::uint64_t> &variables,
         const std::vector<long> &coefficients,
         const long rightSide);
 }
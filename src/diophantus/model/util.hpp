@@ -3,6 +3,7 @@
 #include <diophantus/model/numeric/GmpBigInt.hpp>
 #include <diophantus/model/numeric/BigInt.hpp>
 #include <diophantus/model/Equation.hpp>
+#include <diophantus/model/Variable.hpp>
 
 #include <memory>
 #include <vector>
@@ -16,7 +17,8 @@ namespace diophantus::model
      *      Number of variables to create.
      * @return vector of the created variables
      */
-    std::vector<Variable> make_variables(size_t nVariables);
+    template <VariableId VarT = Variable>
+    std::vector<VarT> make_variables(size_t nVariables);
 
     /**
      * Convenience function for creating an equation.
@@ -28,8 +30,8 @@ namespace diophantus::model
      *      The constant on the right side of the equation.
      * @return the created equation
      */
-    template <numeric::BigInt NumT>
-    Equation<NumT> makeEquation(const std::vector<Variable>& variables,
-                                const std::vector<long>& coefficients,
-                                const long rightSide);
+    template <numeric::BigInt NumT, VariableId VarT>
+    Equation<NumT, VarT> makeEquation(const std::vector<VarT>& variables,
+                                      const std::vector<long>& coefficients,
+                                      const long rightSide);
 }
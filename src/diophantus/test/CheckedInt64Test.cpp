@@ -0,0 +1,137 @@
+#include <diophantus/model/numeric/BigInt.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
+#include <diophantus/model/numeric/OverflowError.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+
+
+// Compile time check: Does CheckedInt64 satisfy BigInt concept constraints?
+namespace diophantus::test
+{
+    template<diophantus::model::numeric::BigInt NumT> class Foo {};
+    using FooCheckedInt64 = Foo<diophantus::model::numeric::CheckedInt64>;
+}
+
+
+using Number = diophantus::model::numeric::CheckedInt64;
+using diophantus::model::numeric::OverflowError;
+
+constexpr long maxLong = std::numeric_limits<long>::max();
+constexpr long minLong = std::numeric_limits<long>::min();
+
+TEST(CheckedInt64Test, InitializerEquality)
+{
+    Number a{5};
+    Number b{"5"};
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(Number("-17"), -17);
+}
+
+TEST(CheckedInt64Test, InitializerOverflow)
+{
+    EXPECT_THROW(Number("9223372036854775808"), OverflowError);
+    EXPECT_THROW(Number("12a"), std::invalid_argument);
+}
+
+TEST(CheckedInt64Test, Arithmetic)
+{
+    Number a{6};
+
+    a += Number(1);
+    EXPECT_EQ(a, 7);
+
+    a -= Number(1);
+    EXPECT_EQ(a, 6);
+
+    a *= Number(7);
+    EXPECT_EQ(a, 42);
+
+    a /= Number(6);
+    EXPECT_EQ(a, 7);
+
+    EXPECT_EQ(a % Number(4), 3);
+    EXPECT_EQ(-a, -7);
+}
+
+TEST(CheckedInt64Test, Overflow)
+{
+    EXPECT_THROW(Number(maxLong) + Number(1), OverflowError);
+    EXPECT_THROW(Number(minLong) - Number(1), OverflowError);
+    EXPECT_THROW(Number(maxLong) * Number(2), OverflowError);
+    EXPECT_THROW(-Number(minLong), OverflowError);
+    EXPECT_THROW(Number::abs(Number(minLong)), OverflowError);
+    EXPECT_THROW(Number::gcd(Number(minLong), Number(0)), OverflowError);
+
+    Number min{minLong};
+    EXPECT_THROW(min /= Number(-1), OverflowError);
+    EXPECT_EQ(min % Number(-1), 0);
+}
+
+TEST(CheckedInt64Test, GCD)
+{
+    EXPECT_EQ(Number::gcd(Number(480), Number(200)), 40);
+    EXPECT_EQ(Number::gcd(Number(-480), Number(200)), 40);
+}
+
+TEST(CheckedInt64Test, SymMod)
+{
+    EXPECT_EQ(Number::symMod(Number(11), Number(5)), 1);
+    EXPECT_EQ(Number::symMod(Number(13), Number(5)), -2);
+    EXPECT_EQ(Number::symMod(Number(-11), Number(5)), -1);
+    EXPECT_EQ(Number::symMod(Number(-13), Number(5)), 2);
+    EXPECT_EQ(Number::symMod(Number(15), Number(6)), -3);
+    EXPECT_EQ(Number::symMod(Number(-15), Number(6)), -3);
+    EXPECT_EQ(Number::symMod(Number(12), Number(8)), -4);
+}
+
+TEST(CheckedInt64Test, AbsoluteComparison)
+{
+    EXPECT_EQ(Number(-5).absCmp(Number(3)), std::strong_ordering::greater);
+    EXPECT_EQ(Number(minLong).absCmp(Number(maxLong)), std::strong_ordering::greater);
+    EXPECT_EQ(Number(-3).absCmp(Number(3)), std::strong_ordering::equal);
+}
+
+TEST(CheckedInt64Test, InPlaceArithmetic)
+{
+    Number a{10};
+
+    a.addMul(Number(3), Number(4));
+    EXPECT_EQ(a, 22);
+
+    a.subMul(Number(5), Number(6));
+    EXPECT_EQ(a, -8);
+
+    a.negate();
+    EXPECT_EQ(a, 8);
+}
+
+TEST(CheckedInt64Test, InPlaceArithmeticOverflow)
+{
+    Number a{1};
+    EXPECT_THROW(a.addMul(Number(maxLong), Number(2)), OverflowError);
+    EXPECT_THROW(a.subMul(Number(minLong), Number(1)), OverflowError);
+    EXPECT_EQ(a, 1);
+
+    Number min{minLong};
+    EXPECT_THROW(min.negate(), OverflowError);
+}
+
+TEST(CheckedInt64Test, ExactDivisionAndContent)
+{
+    Number a{-42};
+    a.divExact(Number(6));
+    EXPECT_EQ(a, -7);
+
+    Number g{480};
+    g.gcdWith(Number(-200));
+    EXPECT_EQ(g, 40);
+
+    EXPECT_TRUE(Number(42).isDivisibleBy(Number(-7)));
+    EXPECT_FALSE(Number(43).isDivisibleBy(Number(7)));
+    EXPECT_TRUE(Number(0).isDivisibleBy(Number(0)));
+    EXPECT_FALSE(Number(5).isDivisibleBy(Number(0)));
+}
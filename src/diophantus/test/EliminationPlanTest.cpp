@@ -0,0 +1,210 @@
+#include <diophantus/EliminationPlan.hpp>
+#include <diophantus/Solver.hpp>
+#include <diophantus/Validator.hpp>
+
+#include <diophantus/model/Equation.hpp>
+#include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/Solution.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+#include <diophantus/model/Variable.hpp>
+#include <diophantus/model/util.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+using NumT = diophantus::model::numeric::GmpBigInt;
+using Variable = diophantus::model::Variable;
+
+using Equation = diophantus::model::Equation<NumT>;
+using EquationSystem = diophantus::model::EquationSystem<NumT>;
+using Solution = diophantus::model::Solution<NumT>;
+using Sum = diophantus::model::Sum<NumT>;
+using Term = diophantus::model::Term<NumT>;
+
+using EliminationPlan = diophantus::EliminationPlan<NumT>;
+using Solver = diophantus::Solver<NumT>;
+using Validator = diophantus::Validator<NumT>;
+
+
+namespace
+{
+    /**
+     * Temporary file that is removed at the end of a test.
+     */
+    class TemporaryFile
+    {
+        public:
+            explicit TemporaryFile(const std::string& name) :
+                path(std::filesystem::temp_directory_path() / (name + "-" + std::to_string(getpid()) + ".plan"))
+            {}
+
+            ~TemporaryFile()
+            {
+                std::filesystem::remove(path);
+            }
+
+            const std::filesystem::path path;
+    };
+
+    /**
+     * Equation system whose elimination multiplies with factors that don't fit into 64 bits.
+     */
+    EquationSystem makeHugeSystem(const std::vector<NumT>& rightSide)
+    {
+        auto variables = diophantus::model::make_variables(5);
+        const NumT huge("1000000000000000000000000000000");
+        const NumT other("-340282366920938463463374607431768211457");
+
+        std::vector<Equation> equations;
+        equations.emplace_back(Sum({Term(NumT(1), 0), Term(huge, 1), Term(NumT(3), 2)}), rightSide[0]);
+        equations.emplace_back(Sum({Term(NumT(2), 0), Term(NumT(5), 1), Term(other, 3)}), rightSide[1]);
+        equations.emplace_back(Sum({Term(NumT(1), 2), Term(NumT(7), 3), Term(huge, 4)}), rightSide[2]);
+        return EquationSystem(variables, equations);
+    }
+
+    std::vector<NumT> makeRightSide(std::mt19937& generator)
+    {
+        std::uniform_int_distribution<long> distribution(-1000, 1000);
+        return {NumT(distribution(generator)), NumT(distribution(generator)), NumT(distribution(generator))};
+    }
+}
+
+
+TEST(EliminationPlanTest, SolvesLikeSolver)
+{
+    auto variables = diophantus::model::make_variables(4);
+    std::vector<std::vector<long>> coefficients = {
+        {4, 6, 0, 10},
+        {0, 3, 9, 1},
+        {4, 9, 9, 11}
+    };
+    auto makeSystem = [&](const std::vector<long>& rightSide) {
+        std::vector<Equation> equations;
+        for (size_t j = 0; j < coefficients.size(); ++j)
+        {
+            equations.push_back(diophantus::model::makeEquation<NumT>(variables, coefficients[j], rightSide[j]));
+        }
+        return EquationSystem(variables, equations);
+    };
+
+    EliminationPlan plan = Solver(makeSystem({0, 0, 0})).compilePlan();
+    EXPECT_EQ(plan.getRightSideCount(), 3);
+    EXPECT_GT(plan.getOperationCount(), 0);
+
+    // Compiling leaves the solver unchanged, so it can compile again and solve afterwards
+    Solver compilingSolver(makeSystem({2, 3, 5}));
+    EXPECT_EQ(compilingSolver.compilePlan().getOperationCount(), plan.getOperationCount());
+    EXPECT_EQ(compilingSolver.compilePlan().getOperationCount(), plan.getOperationCount());
+    std::optional<Solution> compiledSolution = compilingSolver.solve();
+    ASSERT_TRUE(compiledSolution.has_value());
+    EXPECT_TRUE(Validator(makeSystem({2, 3, 5})).isValidSolution(compiledSolution.value()));
+
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<long> distribution(-20, 20);
+    size_t nSolvable = 0;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        std::vector<long> rightSide = {distribution(generator), distribution(generator), 0};
+        rightSide[2] = i % 3 == 0 ? rightSide[0] + rightSide[1] : distribution(generator);
+
+        EquationSystem equationSystem = makeSystem(rightSide);
+        std::optional<Solution> expected = Solver(equationSystem).solve();
+        std::optional<Solution> solution = plan.solve(std::vector<NumT>(rightSide.begin(), rightSide.end()));
+
+        ASSERT_EQ(solution.has_value(), expected.has_value()) << "right side " << i;
+        if (solution.has_value())
+        {
+            EXPECT_TRUE(Validator(equationSystem).isValidSolution(solution.value())) << "right side " << i;
+            ++nSolvable;
+        }
+    }
+    EXPECT_GT(nSolvable, 0);
+    EXPECT_LT(nSolvable, 100);
+
+    EXPECT_THROW(plan.solve({NumT(1)}), std::invalid_argument);
+}
+
+TEST(EliminationPlanTest, SaveAndLoad)
+{
+    std::mt19937 generator(5);
+    EliminationPlan plan = Solver(makeHugeSystem({NumT(0), NumT(0), NumT(0)})).compilePlan();
+
+    TemporaryFile file("SaveAndLoad");
+    ASSERT_TRUE(plan.save(file.path));
+
+    std::optional<EliminationPlan> loadedPlan = EliminationPlan::load(file.path);
+    ASSERT_TRUE(loadedPlan.has_value());
+    EXPECT_EQ(loadedPlan->getRightSideCount(), plan.getRightSideCount());
+    EXPECT_EQ(loadedPlan->getOperationCount(), plan.getOperationCount());
+
+    // Moving the plan keeps its mapping
+    EliminationPlan movedPlan = std::move(loadedPlan.value());
+
+    for (size_t i = 0; i < 20; ++i)
+    {
+        std::vector<NumT> rightSide = makeRightSide(generator);
+        EquationSystem equationSystem = makeHugeSystem(rightSide);
+        std::optional<Solution> expected = Solver(equationSystem).solve();
+        std::optional<Solution> solution = movedPlan.solve(rightSide);
+
+        ASSERT_EQ(solution.has_value(), expected.has_value()) << "right side " << i;
+        ASSERT_EQ(plan.solve(rightSide).has_value(), expected.has_value()) << "right side " << i;
+        if (solution.has_value())
+        {
+            EXPECT_TRUE(Validator(equationSystem).isValidSolution(solution.value())) << "right side " << i;
+        }
+    }
+}
+
+TEST(EliminationPlanTest, RejectsInvalidFiles)
+{
+    EXPECT_FALSE(EliminationPlan::load("/nonexistent/diophantus.plan").has_value());
+
+    TemporaryFile garbage("RejectsInvalidFiles");
+    {
+        std::ofstream stream(garbage.path, std::ios::binary);
+        stream << "this is no elimination plan, but it is long enough for a header";
+    }
+    EXPECT_FALSE(EliminationPlan::load(garbage.path).has_value());
+
+    // Plans are specific to the width of the variable ids
+    TemporaryFile planFile("RejectsInvalidFiles-width");
+    EliminationPlan plan = Solver(makeHugeSystem({NumT(0), NumT(0), NumT(0)})).compilePlan();
+    ASSERT_TRUE(plan.save(planFile.path));
+    using NarrowPlan = diophantus::EliminationPlan<NumT, std::uint16_t>;
+    EXPECT_FALSE(NarrowPlan::load(planFile.path).has_value());
+
+    // Counts whose size in bytes wraps around are rejected
+    TemporaryFile wrappedFile("RejectsInvalidFiles-wrapped");
+    ASSERT_TRUE(plan.save(wrappedFile.path));
+    {
+        // nFactorLimbs is the last field of the 64 byte header
+        std::fstream stream(wrappedFile.path, std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekg(56);
+        uint64_t nFactorLimbs = 0;
+        stream.read(reinterpret_cast<char*>(&nFactorLimbs), sizeof(nFactorLimbs));
+        ASSERT_TRUE(EliminationPlan::load(wrappedFile.path).has_value());
+
+        nFactorLimbs += uint64_t(1) << 61;
+        stream.seekp(56);
+        stream.write(reinterpret_cast<const char*>(&nFactorLimbs), sizeof(nFactorLimbs));
+    }
+    EXPECT_FALSE(EliminationPlan::load(wrappedFile.path).has_value());
+
+    // Truncated plans are rejected
+    std::filesystem::resize_file(planFile.path, std::filesystem::file_size(planFile.path) - 8);
+    EXPECT_FALSE(EliminationPlan::load(planFile.path).has_value());
+}
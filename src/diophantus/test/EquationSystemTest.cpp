@@ -1,9 +1,18 @@
 #include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/RowArena.hpp>
+#include <diophantus/model/VariableOrdering.hpp>
 
 #include <diophantus/model/numeric/GmpBigInt.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
 
 TEST(EquationSystemTest, SimplifyOk)
 {
@@ -24,3 +33,452 @@ TEST(EquationSystemTest, AddVariable)
 {
     // TODO
 }
+
+namespace
+{
+    using NumT = diophantus::model::numeric::GmpBigInt;
+    using Term = diophantus::model::Term<NumT>;
+    using Sum = diophantus::model::Sum<NumT>;
+    using Equation = diophantus::model::Equation<NumT>;
+    using DeducedEquation = diophantus::model::DeducedEquation<NumT>;
+    using Assignment = diophantus::model::Assignment<NumT>;
+    using EquationSystem = diophantus::model::EquationSystem<NumT>;
+
+    using Indices = std::vector<size_t>;
+
+    EquationSystem makeSystem()
+    {
+        // x1 + 2 x2 = 3, x2 + x3 = 1, x3 + 5 x4 = 2
+        return EquationSystem({0, 1, 2, 3, 4}, {
+            Equation(Sum({Term(1, 1), Term(2, 2)}), 3),
+            Equation(Sum({Term(1, 2), Term(1, 3)}), 1),
+            Equation(Sum({Term(1, 3), Term(5, 4)}), 2)
+        });
+    }
+}
+
+TEST(EquationSystemTest, Occurrences)
+{
+    EquationSystem system = makeSystem();
+
+    EXPECT_EQ(system.getOccurrences(1), Indices({0}));
+    EXPECT_EQ(system.getOccurrences(2), Indices({0, 1}));
+    EXPECT_EQ(system.getOccurrences(3), Indices({1, 2}));
+    EXPECT_EQ(system.getOccurrences(4), Indices({2}));
+}
+
+TEST(EquationSystemTest, SubstituteRecordsFillIn)
+{
+    EquationSystem system = makeSystem();
+
+    // x2 = x4 - x1
+    system.substitute(DeducedEquation(2, Sum({Term(-1, 1), Term(1, 4)}), NumT(0)));
+
+    EXPECT_TRUE(system.getOccurrences(2).empty());
+    EXPECT_EQ(system.getOccurrences(1), Indices({0, 1}));
+    EXPECT_EQ(system.getOccurrences(4), Indices({2, 0, 1}));
+
+    // The third equation does not contain x2 and is left unchanged
+    const auto& equations = system.getEquations();
+    EXPECT_EQ(equations[0].getLeftSide().getVariables(), Sum::Variables({1, 4}));
+    EXPECT_EQ(equations[1].getLeftSide().getVariables(), Sum::Variables({1, 3, 4}));
+    EXPECT_EQ(equations[2].getLeftSide().getVariables(), Sum::Variables({3, 4}));
+}
+
+TEST(EquationSystemTest, SimplifyMovesLastEquation)
+{
+    EquationSystem system = makeSystem();
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_TRUE(system.getLastRemovals().empty());
+
+    system.substitute(Assignment{.variable = 1, .value = NumT(1)});
+    system.substitute(Assignment{.variable = 2, .value = NumT(1)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+
+    // The first equation became empty and was replaced by the last one
+    ASSERT_EQ(system.getLastRemovals().size(), 1);
+    EXPECT_EQ(system.getLastRemovals()[0].index, 0);
+    EXPECT_EQ(system.getLastRemovals()[0].movedIndex, 2);
+
+    EXPECT_EQ(system.getEquationCount(), 2);
+    EXPECT_EQ(system.getEquations()[0].getLeftSide().getVariables(), Sum::Variables({3, 4}));
+    EXPECT_EQ(system.getOccurrences(3), Indices({1, 0}));
+    EXPECT_EQ(system.getOccurrences(4), Indices({0}));
+}
+
+TEST(EquationSystemTest, SimplifyOnlyDirtyEquations)
+{
+    EquationSystem system = makeSystem();
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    for (const auto& equation : system.getEquations())
+    {
+        EXPECT_FALSE(equation.isDirty());
+    }
+
+    // x4 = 0 only touches the last equation
+    system.substitute(Assignment{.variable = 4, .value = NumT(0)});
+    EXPECT_FALSE(system.getEquations()[0].isDirty());
+    EXPECT_FALSE(system.getEquations()[1].isDirty());
+    EXPECT_TRUE(system.getEquations()[2].isDirty());
+
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_FALSE(system.getEquations()[2].isDirty());
+}
+
+TEST(EquationSystemTest, SimplifyConflictInDirtyEquation)
+{
+    EquationSystem system = makeSystem();
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+
+    // x3 = 0 turns the last equation into 5 x4 = 2
+    system.substitute(Assignment{.variable = 3, .value = NumT(0)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Conflict);
+}
+
+TEST(EquationSystemTest, SimplifyRemovesDuplicates)
+{
+    // The second equation is the first one times -3, the third one times 2
+    EquationSystem system({0, 1, 2, 3}, {
+        Equation(Sum({Term(1, 1), Term(-2, 2), Term(3, 3)}), 4),
+        Equation(Sum({Term(-3, 1), Term(6, 2), Term(-9, 3)}), -12),
+        Equation(Sum({Term(1, 2), Term(1, 3)}), 1),
+        Equation(Sum({Term(2, 1), Term(-4, 2), Term(6, 3)}), 8)
+    });
+
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 2);
+    EXPECT_EQ(system.getEquations()[0].getLeftSide().getVariables(), Sum::Variables({1, 2, 3}));
+    EXPECT_EQ(system.getEquations()[1].getLeftSide().getVariables(), Sum::Variables({2, 3}));
+}
+
+TEST(EquationSystemTest, SimplifyConflictingDuplicates)
+{
+    // x1 + 2 x2 = 3 and -x1 - 2 x2 = 3
+    EquationSystem system({0, 1, 2}, {
+        Equation(Sum({Term(1, 1), Term(2, 2)}), 3),
+        Equation(Sum({Term(-1, 1), Term(-2, 2)}), 3)
+    });
+
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Conflict);
+}
+
+TEST(EquationSystemTest, SimplifyRemovesDuplicateAfterSubstitution)
+{
+    EquationSystem system({0, 1, 2, 3}, {
+        Equation(Sum({Term(1, 1), Term(2, 2)}), 3),
+        Equation(Sum({Term(2, 1), Term(4, 2), Term(1, 3)}), 6),
+        Equation(Sum({Term(1, 2), Term(1, 3)}), 1)
+    });
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 3);
+
+    // x3 = 0 turns the second equation into a multiple of the first one
+    system.substitute(Assignment{.variable = 3, .value = NumT(0)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 2);
+    EXPECT_EQ(system.getEquations()[1].getLeftSide().getVariables(), Sum::Variables({2}));
+
+    // The moved equation is still found as a duplicate
+    system.substitute(Assignment{.variable = 1, .value = NumT(1)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 1);
+}
+
+TEST(EquationSystemTest, RowArena)
+{
+    EquationSystem system = makeSystem();
+    EXPECT_EQ(system.getRowArena(), nullptr);
+
+    system.useRowArena();
+    const std::pmr::memory_resource* arena = system.getRowArena();
+    ASSERT_NE(arena, nullptr);
+    EXPECT_GT(system.getRowArena()->getUsedBytes(), 0);
+    for (const auto& equation : system.getEquations())
+    {
+        EXPECT_EQ(equation.getLeftSide().getVariables().get_allocator().resource(), arena);
+    }
+
+    // x2 = 1 - x3 merges terms into the first equation
+    system.substitute(DeducedEquation(2, Sum({Term(-1, 3)}), NumT(1)));
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquations()[0].getLeftSide().getVariables(), Sum::Variables({1, 3}));
+    EXPECT_EQ(system.getEquations()[0].getLeftSide().getVariables().get_allocator().resource(), arena);
+
+    // Copies don't share the arena
+    EquationSystem copy(system);
+    EXPECT_EQ(copy.getRowArena(), nullptr);
+    EXPECT_EQ(copy.getEquations()[0].getLeftSide().getVariables(), Sum::Variables({1, 3}));
+}
+
+TEST(EquationSystemTest, RowArenaCompaction)
+{
+    // Enough distinct rows to fill more than the minimum arena size
+    const size_t nVariables = 64;
+    const size_t nEquations = 1000;
+
+    std::vector<diophantus::model::Variable> variables;
+    for (size_t variable = 0; variable <= nVariables; ++variable)
+    {
+        variables.push_back(variable);
+    }
+    std::vector<Equation> equations;
+    for (size_t row = 0; row < nEquations; ++row)
+    {
+        std::vector<Term> terms;
+        for (size_t variable = 1; variable <= nVariables; ++variable)
+        {
+            terms.emplace_back(static_cast<long>(row * variable + 1), variable);
+        }
+        equations.emplace_back(Sum(terms), 0);
+    }
+
+    EquationSystem system(variables, std::move(equations));
+    system.useRowArena();
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_GE(system.getRowArena()->getReservedBytes(), diophantus::model::RowArena::minFragmentedBytes);
+
+    // Once all rows are gone, the arena is replaced by an empty one
+    for (size_t variable = 1; variable <= nVariables; ++variable)
+    {
+        system.substitute(Assignment{.variable = static_cast<diophantus::model::Variable>(variable), .value = NumT(0)});
+    }
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::IsEmpty);
+    ASSERT_NE(system.getRowArena(), nullptr);
+    EXPECT_EQ(system.getRowArena()->getUsedBytes(), 0);
+    EXPECT_LT(system.getRowArena()->getReservedBytes(), diophantus::model::RowArena::minFragmentedBytes);
+}
+
+TEST(EquationSystemTest, AddVariableBeyondIdWidth)
+{
+    using NarrowEquationSystem = diophantus::model::EquationSystem<NumT, std::uint16_t>;
+
+    // Ids 0 to 65534 are taken, so only one more variable fits into 16 bits
+    std::vector<std::uint16_t> variables(65535);
+    for (size_t variable = 0; variable < variables.size(); ++variable)
+    {
+        variables[variable] = static_cast<std::uint16_t>(variable);
+    }
+    NarrowEquationSystem system(std::move(variables), {});
+
+    EXPECT_EQ(system.addNewVariable(), 65535);
+    EXPECT_THROW(system.addNewVariable(), std::overflow_error);
+}
+
+TEST(EquationSystemTest, RenumberVariables)
+{
+    EquationSystem system = makeSystem();
+    system.substitute(Assignment{.variable = 1, .value = NumT(1)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEliminatedVariableCount(), 1);
+    system.takeChangedEquations();
+
+    // 2 x2 = 2 became x2 = 1, so x2, x3 and x4 are left
+    system.renumberVariables(diophantus::model::VariableOrdering::Compact);
+    EXPECT_TRUE(system.isRenumbered());
+    EXPECT_EQ(system.getEliminatedVariableCount(), 0);
+    EXPECT_EQ(system.getVariables(), std::vector<diophantus::model::Variable>({2, 3, 4}));
+    EXPECT_EQ(system.getEquations()[0].getLeftSide().getVariables(), Sum::Variables({0}));
+    EXPECT_EQ(system.getEquations()[1].getLeftSide().getVariables(), Sum::Variables({0, 1}));
+    EXPECT_EQ(system.getEquations()[2].getLeftSide().getVariables(), Sum::Variables({1, 2}));
+    EXPECT_EQ(system.getOccurrences(0), Indices({0, 1}));
+    EXPECT_EQ(system.takeChangedEquations(), Indices({0, 1, 2}));
+
+    // New variables get fresh original ids
+    EXPECT_EQ(system.addNewVariable(), 3);
+    EXPECT_EQ(system.getVariables().back(), 5);
+
+    // The duplicate index follows the new ids
+    system.substitute(Assignment{.variable = 2, .value = NumT(0)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 3);
+}
+
+TEST(EquationSystemTest, RenumberVariablesReverseCuthillMcKee)
+{
+    // A chain of equations whose variables are scattered over the ids
+    EquationSystem system({0, 1, 2, 3, 4, 5, 6, 7}, {
+        Equation(Sum({Term(1, 0), Term(1, 5)}), 1),
+        Equation(Sum({Term(1, 5), Term(1, 2)}), 1),
+        Equation(Sum({Term(1, 2), Term(1, 7)}), 1),
+        Equation(Sum({Term(1, 7), Term(1, 3)}), 1)
+    });
+
+    system.renumberVariables(diophantus::model::VariableOrdering::ReverseCuthillMcKee);
+
+    std::vector<diophantus::model::Variable> originalVariables = system.getVariables();
+    std::ranges::sort(originalVariables);
+    EXPECT_EQ(originalVariables, std::vector<diophantus::model::Variable>({0, 2, 3, 5, 7}));
+
+    // Neighbours in the chain get neighbouring ids
+    for (const Equation& equation : system.getEquations())
+    {
+        const auto& variables = equation.getLeftSide().getVariables();
+        ASSERT_EQ(variables.size(), 2);
+        EXPECT_EQ(variables[1] - variables[0], 1);
+    }
+}
+
+TEST(EquationSystemTest, AddEquation)
+{
+    EquationSystem system = makeSystem();
+    system.takeChangedEquations();
+
+    system.addEquation(Equation(Sum({Term(1, 0), Term(3, 4)}), 7));
+    EXPECT_EQ(system.getEquationCount(), 4);
+    EXPECT_EQ(system.getEquations()[3].getLeftSide().getVariables(), Sum::Variables({0, 4}));
+    EXPECT_EQ(system.getOccurrences(0), Indices({3}));
+    EXPECT_EQ(system.takeChangedEquations(), Indices({3}));
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+
+    EXPECT_THROW(system.addEquation(Equation(Sum({Term(1, 5)}), 1)), std::invalid_argument);
+}
+
+TEST(EquationSystemTest, AddEquationAfterRenumbering)
+{
+    EquationSystem system = makeSystem();
+    system.substitute(Assignment{.variable = 1, .value = NumT(1)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    system.renumberVariables(diophantus::model::VariableOrdering::Compact);
+    ASSERT_EQ(system.getVariables(), std::vector<diophantus::model::Variable>({2, 3, 4}));
+    EXPECT_EQ(system.addNewVariable(), 3);
+
+    // x0 was dropped by the renumbering and gets a new id, x4 and x5 keep theirs
+    system.addEquation(Equation(Sum({Term(1, 0), Term(3, 4), Term(2, 5)}), 7));
+    EXPECT_EQ(system.getVariables(), std::vector<diophantus::model::Variable>({2, 3, 4, 5, 0}));
+    EXPECT_EQ(system.getEquations()[3].getLeftSide().getVariables(), Sum::Variables({2, 3, 4}));
+    EXPECT_EQ(system.getEquations()[3].getLeftSide().getCoefficients()[2], 1);
+
+    // Variables that were eliminated before the renumbering are still known
+    system.addEquation(Equation(Sum({Term(1, 0), Term(1, 1)}), 2));
+    EXPECT_EQ(system.getVariables().back(), 1);
+    EXPECT_EQ(system.getEquations()[4].getLeftSide().getVariables(), Sum::Variables({4, 5}));
+    EXPECT_THROW(system.addEquation(Equation(Sum({Term(1, 6)}), 1)), std::invalid_argument);
+}
+
+TEST(EquationSystemTest, PushAndPop)
+{
+    // rows of an equation system as comparable values, independent of their order
+    using Row = std::tuple<std::vector<diophantus::model::Variable>, std::vector<long>, long>;
+    auto getRows = [](const EquationSystem& system) {
+        std::vector<Row> rows;
+        for (const Equation& equation : system.getEquations())
+        {
+            const auto& variables = equation.getLeftSide().getVariables();
+            std::vector<long> coefficients;
+            for (const NumT& coefficient : equation.getLeftSide().getCoefficients())
+            {
+                coefficients.push_back(coefficient.get().get_si());
+            }
+            rows.emplace_back(std::vector<diophantus::model::Variable>(variables.begin(), variables.end()),
+                              coefficients, equation.getRightSide().get().get_si());
+        }
+        std::ranges::sort(rows);
+        return rows;
+    };
+
+    EquationSystem system = makeSystem();
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    const std::vector<Row> rows = getRows(system);
+    EXPECT_THROW(system.pop(), std::logic_error);
+
+    system.push();
+    system.addEquation(Equation(Sum({Term(1, 0), Term(1, 4)}), 3));
+    system.push();
+    EXPECT_EQ(system.getScopeDepth(), 2);
+
+    // x1 = 1 and x2 = 1 empty the first equation, x3 = 2 x5 changes the next two
+    const auto newVariable = system.addNewVariable();
+    system.substitute(Assignment{.variable = 1, .value = NumT(1)});
+    system.substitute(Assignment{.variable = 2, .value = NumT(1)});
+    system.substitute(DeducedEquation(3, Sum({Term(2, newVariable)}), NumT(0)));
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 3);
+    EXPECT_EQ(system.getEliminatedVariableCount(), 3);
+    EXPECT_THROW(system.renumberVariables(diophantus::model::VariableOrdering::Compact), std::logic_error);
+
+    system.pop();
+    EXPECT_EQ(system.getEquationCount(), 4);
+    EXPECT_EQ(system.getVariableCount(), 5);
+    EXPECT_EQ(system.getEliminatedVariableCount(), 0);
+
+    system.pop();
+    EXPECT_EQ(system.getScopeDepth(), 0);
+    EXPECT_EQ(getRows(system), rows);
+
+    // The restored equations take part in duplicate detection and substitutions again
+    system.addEquation(Equation(Sum({Term(-1, 2), Term(-1, 3)}), -1));
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(system.getEquationCount(), 3);
+    system.substitute(Assignment{.variable = 4, .value = NumT(1)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    EXPECT_EQ(getRows(system), std::vector<Row>({{{1, 2}, {1, 2}, 3}, {{2, 3}, {1, 1}, 1}, {{3}, {1}, -3}}));
+}
+
+TEST(EquationSystemTest, ScopeSavesEachRowOnce)
+{
+    // Every equation contains all variables, so every substitution changes every row
+    const size_t nEquations = 5;
+    std::vector<Equation> equations;
+    for (size_t i = 0; i < nEquations; ++i)
+    {
+        std::vector<Term> terms;
+        for (size_t j = 0; j < 8; ++j)
+        {
+            terms.emplace_back(long(i + j + 1), j);
+        }
+        equations.emplace_back(Sum(terms), long(i));
+    }
+    EquationSystem system({0, 1, 2, 3, 4, 5, 6, 7}, equations);
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+
+    auto substituteAndSimplify = [&system](diophantus::model::Variable first, diophantus::model::Variable last) {
+        for (auto variable = first; variable < last; ++variable)
+        {
+            system.substitute(Assignment{.variable = variable, .value = NumT(1)});
+            EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+        }
+    };
+
+    // Sibling scopes record the rows again, nested scopes record them once more
+    for (size_t nScopes = 0; nScopes < 2; ++nScopes)
+    {
+        system.push();
+        substituteAndSimplify(0, 3);
+        EXPECT_EQ(system.getTrailSize(), nEquations);
+
+        system.push();
+        substituteAndSimplify(3, 6);
+        EXPECT_EQ(system.getTrailSize(), 2 * nEquations);
+        system.pop();
+
+        substituteAndSimplify(3, 6);
+        EXPECT_EQ(system.getTrailSize(), nEquations);
+        system.pop();
+        EXPECT_EQ(system.getTrailSize(), 0);
+    }
+    EXPECT_EQ(system.getEquationCount(), nEquations);
+    for (size_t eqIndex = 0; eqIndex < nEquations; ++eqIndex)
+    {
+        EXPECT_EQ(system.getEquations()[eqIndex].getLeftSide().getTermCount(), 8);
+    }
+}
+
+TEST(EquationSystemTest, PopRestoresInvertedEquation)
+{
+    EquationSystem system = makeSystem();
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+
+    // The inversion is undone along with the substitution that follows it, not only the latter
+    system.push();
+    system.invertEquation(0);
+    EXPECT_EQ(system.getEquations()[0].getRightSide(), NumT(-3));
+    system.substitute(Assignment{.variable = 2, .value = NumT(1)});
+    EXPECT_EQ(system.simplify(), diophantus::model::SimplificationResult::Ok);
+    system.pop();
+
+    const Equation& equation = system.getEquations()[0];
+    EXPECT_EQ(equation.getRightSide(), NumT(3));
+    ASSERT_EQ(equation.getLeftSide().getTermCount(), 2);
+    EXPECT_EQ(equation.getLeftSide().getTerms()[0].getCoefficient(), NumT(1));
+    EXPECT_EQ(equation.getLeftSide().getTerms()[1].getCoefficient(), NumT(2));
+}
@@ -123,6 +123,51 @@ TEST(EquationTest, SimplifyZeroCoefficient)
     EXPECT_EQ(equation.getRightSide(), 6);
 }
 
+TEST(EquationTest, SimplifyNegativeCoefficients)
+{
+    auto variables = diophantus::model::make_variables(2);
+    std::vector<Term> terms = {
+        Term(-6, variables[0]),
+        Term(-9, variables[1])
+    };
+    auto sum = Sum(terms);
+    auto equation = Equation(sum, 12);
+
+    auto result = equation.simplify();
+    EXPECT_EQ(result, SimplificationResult::Ok);
+
+    const auto& leftSideTerms = equation.getLeftSide().getTerms();
+    EXPECT_EQ(leftSideTerms[0].getCoefficient(), -2);
+    EXPECT_EQ(leftSideTerms[1].getCoefficient(), -3);
+    EXPECT_EQ(equation.getRightSide(), 4);
+}
+
+TEST(EquationTest, SimplifyAgainAfterSubstitution)
+{
+    auto variables = diophantus::model::make_variables(3);
+    std::vector<Term> terms = {
+        Term(2, variables[0]),
+        Term(4, variables[1]),
+        Term(3, variables[2])
+    };
+    auto sum = Sum(terms);
+    auto equation = Equation(sum, 10);
+
+    EXPECT_EQ(equation.simplify(), SimplificationResult::Ok);
+    EXPECT_EQ(equation.getRightSide(), 10);
+
+    // After eliminating the only odd coefficient, the equation has content 2 again
+    equation.substitute(Assignment{.variable = variables[2], .value = NumT(2)});
+
+    EXPECT_EQ(equation.simplify(), SimplificationResult::Ok);
+    EXPECT_EQ(equation.getRightSide(), 2);
+
+    const auto& leftSideTerms = equation.getLeftSide().getTerms();
+    EXPECT_EQ(leftSideTerms.size(), 2);
+    EXPECT_EQ(leftSideTerms[0].getCoefficient(), 1);
+    EXPECT_EQ(leftSideTerms[1].getCoefficient(), 2);
+}
+
 TEST(EquationTest, SimplifyConflictByGCD)
 {
     auto variables = diophantus::model::make_variables(3);
@@ -305,17 +350,15 @@ TEST(EquationTest, SubstituteByAssignment)
 
     EXPECT_EQ(equation.getRightSide(), -619);
 
+    // The substituted variable is removed from the left side
     const auto& leftSideTerms = equation.getLeftSide().getTerms();
-    EXPECT_EQ(leftSideTerms.size(), 3);
+    EXPECT_EQ(leftSideTerms.size(), 2);
 
     EXPECT_EQ(leftSideTerms[0].getCoefficient(), 7);
     EXPECT_EQ(leftSideTerms[0].getVariable(), 0);
 
-    EXPECT_EQ(leftSideTerms[1].getCoefficient(), 0);
-    EXPECT_EQ(leftSideTerms[1].getVariable(), 1);
-
-    EXPECT_EQ(leftSideTerms[2].getCoefficient(), 31);
-    EXPECT_EQ(leftSideTerms[2].getVariable(), 2);
+    EXPECT_EQ(leftSideTerms[1].getCoefficient(), 31);
+    EXPECT_EQ(leftSideTerms[1].getVariable(), 2);
 }
 
 TEST(EquationTest, SubstituteByDeducedEquation)
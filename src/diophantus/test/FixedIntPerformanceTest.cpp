@@ -0,0 +1,96 @@
+#include <diophantus/model/numeric/BigInt.hpp>
+#include <diophantus/model/numeric/FixedInt.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using GmpNumber = diophantus::model::numeric::GmpBigInt;
+using Number128 = diophantus::model::numeric::FixedInt<128>;
+using Number256 = diophantus::model::numeric::FixedInt<256>;
+
+namespace
+{
+    constexpr unsigned int nCalls = 100000;
+
+    /**
+     * Creates values of around 90 bits, so that products still fit into 256 bits.
+     */
+    template <diophantus::model::numeric::BigInt Number>
+    std::vector<Number> makeNumbers()
+    {
+        std::vector<Number> numbers;
+        numbers.reserve(nCalls);
+        for (unsigned int i = 0; i < nCalls; ++i)
+        {
+            Number number(static_cast<long>(i) * 2654435761 + 1);
+            number *= Number(1000000007L * (i % 1000 + 1));
+            numbers.push_back(std::move(number));
+        }
+        return numbers;
+    }
+
+    template <diophantus::model::numeric::BigInt Number, typename Operation>
+    void measureTime(const std::string& typeName, const std::string& operationName,
+                     Operation operation)
+    {
+        std::vector<Number> numbers = makeNumbers<Number>();
+        Number modulus(1000003);
+        Number result(0);
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        for (unsigned int i = 1; i < nCalls; ++i)
+        {
+            operation(result, numbers[i], numbers[i - 1], modulus);
+        }
+
+        auto endTime = std::chrono::steady_clock::now();
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+
+        std::cout << "Measured time for " << nCalls << " calls of " << operationName
+                  << " with " << typeName << ": " << duration << " us" << std::endl;
+    }
+
+    template <diophantus::model::numeric::BigInt Number>
+    void measureAll(const std::string& typeName)
+    {
+        measureTime<Number>(typeName, "symMod",
+            [](Number& result, const Number& a, const Number&, const Number& m) {
+                result = Number::symMod(a, m);
+            });
+        measureTime<Number>(typeName, "addMul",
+            [](Number& result, const Number& a, const Number& b, const Number& m) {
+                result = a;
+                result.addMul(b, m);
+            });
+        measureTime<Number>(typeName, "gcd",
+            [](Number& result, const Number& a, const Number& b, const Number&) {
+                result = Number::gcd(a, b);
+            });
+        measureTime<Number>(typeName, "absCmp",
+            [](Number& result, const Number& a, const Number& b, const Number&) {
+                result = a.absCmp(b) == std::strong_ordering::less ? a : b;
+            });
+    }
+}
+
+TEST(FixedIntPerformanceTest, GmpBigIntMeasureTime)
+{
+    measureAll<GmpNumber>("GmpBigInt");
+}
+
+TEST(FixedIntPerformanceTest, FixedInt128MeasureTime)
+{
+    measureAll<Number128>("FixedInt<128>");
+}
+
+TEST(FixedIntPerformanceTest, FixedInt256MeasureTime)
+{
+    measureAll<Number256>("FixedInt<256>");
+}
@@ -0,0 +1,273 @@
+#include <diophantus/model/numeric/BigInt.hpp>
+#include <diophantus/model/numeric/FixedInt.hpp>
+#include <diophantus/model/numeric/OverflowError.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gmpxx.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// Compile time check: Does FixedInt satisfy BigInt concept constraints?
+namespace diophantus::test
+{
+    template<diophantus::model::numeric::BigInt NumT> class Foo {};
+    using FooFixedInt128 = Foo<diophantus::model::numeric::FixedInt<128>>;
+    using FooFixedInt256 = Foo<diophantus::model::numeric::FixedInt<256>>;
+}
+
+
+using Number = diophantus::model::numeric::FixedInt<128>;
+using WideNumber = diophantus::model::numeric::FixedInt<256>;
+using diophantus::model::numeric::OverflowError;
+
+constexpr long maxLong = std::numeric_limits<long>::max();
+constexpr long minLong = std::numeric_limits<long>::min();
+
+// 2^127 - 1 and -2^127
+const std::string maxNumber = "170141183460469231731687303715884105727";
+const std::string minNumber = "-170141183460469231731687303715884105728";
+
+template <typename T>
+std::string toString(const T& number)
+{
+    std::stringstream ss;
+    ss << number;
+    return ss.str();
+}
+
+TEST(FixedIntTest, InitializerEquality)
+{
+    Number a{5};
+    Number b{"5"};
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(Number("-17"), -17);
+    EXPECT_EQ(Number(minLong), minLong);
+    EXPECT_EQ(toString(Number(minLong)), "-9223372036854775808");
+}
+
+TEST(FixedIntTest, InitializerOverflow)
+{
+    EXPECT_EQ(toString(Number(maxNumber)), maxNumber);
+    EXPECT_EQ(toString(Number(minNumber)), minNumber);
+    EXPECT_THROW(Number("170141183460469231731687303715884105728"), OverflowError);
+    EXPECT_THROW(Number("12a"), std::invalid_argument);
+    EXPECT_THROW(Number("-"), std::invalid_argument);
+}
+
+TEST(FixedIntTest, Arithmetic)
+{
+    Number a{6};
+
+    a += Number(1);
+    EXPECT_EQ(a, 7);
+
+    a -= Number(1);
+    EXPECT_EQ(a, 6);
+
+    a *= Number(7);
+    EXPECT_EQ(a, 42);
+
+    a /= Number(6);
+    EXPECT_EQ(a, 7);
+
+    EXPECT_EQ(a % Number(4), 3);
+    EXPECT_EQ(Number(-23) % Number(4), -3);
+    EXPECT_EQ(-a, -7);
+}
+
+TEST(FixedIntTest, BeyondSixtyFourBits)
+{
+    Number a{maxLong};
+    a += Number(1);
+    EXPECT_GT(a, maxLong);
+    EXPECT_EQ(toString(a), "9223372036854775808");
+
+    Number square = a * a;
+    EXPECT_EQ(toString(square), "85070591730234615865843651857942052864");
+    EXPECT_EQ(toString(-square), "-85070591730234615865843651857942052864");
+
+    square /= a;
+    EXPECT_EQ(square, a);
+    EXPECT_LT(Number(minLong) * Number(3), Number(minLong));
+}
+
+TEST(FixedIntTest, Overflow)
+{
+    Number max{maxNumber};
+    Number min{minNumber};
+
+    EXPECT_THROW(max + Number(1), OverflowError);
+    EXPECT_THROW(min - Number(1), OverflowError);
+    EXPECT_THROW(-min, OverflowError);
+    EXPECT_THROW(Number::abs(min), OverflowError);
+    EXPECT_THROW(max * Number(2), OverflowError);
+    EXPECT_THROW(Number(maxLong) * Number(maxLong) * Number(4), OverflowError);
+    EXPECT_THROW(min /= Number(-1), OverflowError);
+
+    EXPECT_EQ(-max - Number(1), min);
+    EXPECT_EQ(min % Number(-1), 0);
+    EXPECT_NO_THROW(WideNumber(maxNumber) * WideNumber(maxNumber));
+}
+
+TEST(FixedIntTest, GCD)
+{
+    EXPECT_EQ(Number::gcd(Number(480), Number(200)), 40);
+    EXPECT_EQ(Number::gcd(Number(-480), Number(200)), 40);
+    EXPECT_EQ(Number::gcd(Number(0), Number(-7)), 7);
+
+    Number big = Number(maxLong) * Number(1L << 20);
+    EXPECT_EQ(Number::gcd(big * Number(6), big * Number(4)), big * Number(2));
+    EXPECT_THROW(Number::gcd(Number(minNumber), Number(0)), OverflowError);
+}
+
+TEST(FixedIntTest, SymMod)
+{
+    EXPECT_EQ(Number::symMod(Number(10), Number(5)), 0);
+    EXPECT_EQ(Number::symMod(Number(11), Number(5)), 1);
+    EXPECT_EQ(Number::symMod(Number(12), Number(5)), 2);
+    EXPECT_EQ(Number::symMod(Number(13), Number(5)), -2);
+    EXPECT_EQ(Number::symMod(Number(14), Number(5)), -1);
+
+    EXPECT_EQ(Number::symMod(Number(-11), Number(5)), -1);
+    EXPECT_EQ(Number::symMod(Number(-13), Number(5)), 2);
+
+    EXPECT_EQ(Number::symMod(Number(15), Number(6)), -3);
+    EXPECT_EQ(Number::symMod(Number(-15), Number(6)), -3);
+}
+
+TEST(FixedIntTest, AbsoluteComparison)
+{
+    Number min{minNumber};
+    Number max{maxNumber};
+
+    EXPECT_EQ(Number(-5).absCmp(Number(3)), std::strong_ordering::greater);
+    EXPECT_EQ(Number(-5).absCmp(Number(5)), std::strong_ordering::equal);
+    EXPECT_EQ(min.absCmp(max), std::strong_ordering::greater);
+    EXPECT_TRUE(min < max);
+    EXPECT_TRUE(Number(-1) < Number(0));
+}
+
+TEST(FixedIntTest, InPlaceArithmetic)
+{
+    Number a{10};
+
+    a.addMul(Number(3), Number(4));
+    EXPECT_EQ(a, 22);
+
+    a.subMul(Number(5), Number(6));
+    EXPECT_EQ(a, -8);
+
+    a.negate();
+    EXPECT_EQ(a, 8);
+
+    // A failed operation leaves the value unchanged
+    Number max{maxNumber};
+    EXPECT_THROW(max.addMul(Number(1), Number(1)), OverflowError);
+    EXPECT_EQ(toString(max), maxNumber);
+}
+
+TEST(FixedIntTest, ExactDivisionAndContent)
+{
+    Number a{-42};
+    a.divExact(Number(6));
+    EXPECT_EQ(a, -7);
+
+    Number g{480};
+    g.gcdWith(Number(-200));
+    EXPECT_EQ(g, 40);
+
+    EXPECT_TRUE(Number(42).isDivisibleBy(Number(-7)));
+    EXPECT_FALSE(Number(43).isDivisibleBy(Number(7)));
+    EXPECT_TRUE(Number(0).isDivisibleBy(Number(0)));
+    EXPECT_FALSE(Number(5).isDivisibleBy(Number(0)));
+}
+
+TEST(FixedIntTest, MatchesGmp)
+{
+    // Compare random operations on values of up to 120 bits against mpz_class
+    std::mt19937_64 generator(7);
+    auto randomValue = [&generator]() {
+        mpz_class value = 0;
+        int nBits = generator() % 120;
+        for (int i = 0; i < nBits; i += 32)
+        {
+            value = (value << 32) + static_cast<unsigned long>(generator() & 0xffffffff);
+        }
+        value >>= (nBits + 31) / 32 * 32 - nBits;
+        return generator() % 2 ? value : mpz_class(-value);
+    };
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        mpz_class x = randomValue();
+        mpz_class y = randomValue();
+        if (y == 0)
+        {
+            continue;
+        }
+
+        WideNumber a(x.get_str());
+        WideNumber b(y.get_str());
+
+        EXPECT_EQ(toString(a + b), mpz_class(x + y).get_str());
+        EXPECT_EQ(toString(a - b), mpz_class(x - y).get_str());
+        EXPECT_EQ(toString(a * b), mpz_class(x * y).get_str());
+        EXPECT_EQ(toString(a % b), mpz_class(x % y).get_str());
+
+        WideNumber quotient(a);
+        quotient /= b;
+        EXPECT_EQ(toString(quotient), mpz_class(x / y).get_str());
+
+        EXPECT_EQ(toString(WideNumber::gcd(a, b)), mpz_class(gcd(x, y)).get_str());
+        EXPECT_EQ(a < b, x < y);
+        EXPECT_EQ(a.absHash(), (-a).absHash());
+        EXPECT_EQ(a.absHash(), Number(x.get_str()).absHash());
+    }
+}
+
+TEST(FixedIntTest, PortableLimbArithmetic)
+{
+    namespace limbs = diophantus::model::numeric::limbs;
+    constexpr uint64_t maxLimb = std::numeric_limits<uint64_t>::max();
+
+    std::mt19937_64 generator(11);
+    std::vector<uint64_t> values = {0, 1, 2, 0xFFFFFFFF, uint64_t(1) << 32, uint64_t(1) << 63, maxLimb - 1, maxLimb};
+    for (size_t i = 0; i < 40; ++i)
+    {
+        values.push_back(generator());
+        values.push_back(generator() >> 33);
+    }
+
+    for (uint64_t a : values)
+    {
+        for (uint64_t b : values)
+        {
+            // The largest sum still fits: (2^64 - 1)^2 + 2 (2^64 - 1) = 2^128 - 1
+            uint64_t expectedHigh = 0;
+            uint64_t actualHigh = 0;
+            uint64_t expectedLow = limbs::mulAdd(a, b, maxLimb, b, expectedHigh);
+            uint64_t actualLow = limbs::portable::mulAdd(a, b, maxLimb, b, actualHigh);
+            EXPECT_EQ(actualLow, expectedLow) << a << " * " << b;
+            EXPECT_EQ(actualHigh, expectedHigh) << a << " * " << b;
+
+            if (b == 0)
+            {
+                continue;
+            }
+            uint64_t expectedRemainder = 0;
+            uint64_t actualRemainder = 0;
+            const uint64_t high = a % b;
+            EXPECT_EQ(limbs::portable::divWide(high, a, b, actualRemainder),
+                      limbs::divWide(high, a, b, expectedRemainder)) << high << ":" << a << " / " << b;
+            EXPECT_EQ(actualRemainder, expectedRemainder);
+        }
+    }
+}
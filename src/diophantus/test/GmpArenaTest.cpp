@@ -0,0 +1,122 @@
+#include <diophantus/model/numeric/GmpArena.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gmp.h>
+#include <gmpxx.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+using diophantus::model::numeric::GmpArena;
+using diophantus::model::numeric::GmpArenaScope;
+
+TEST(GmpArenaTest, ReusesFreedBlocks)
+{
+    GmpArena arena;
+
+    void* a = arena.allocate(24);
+    EXPECT_TRUE(arena.owns(a));
+
+    arena.deallocate(a);
+    void* b = arena.allocate(20);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(arena.getAllocationCount(), 2);
+}
+
+TEST(GmpArenaTest, ReallocatePreservesContents)
+{
+    GmpArena arena;
+
+    char* a = static_cast<char*>(arena.allocate(16));
+    std::strcpy(a, "diophantus");
+
+    char* b = static_cast<char*>(arena.reallocate(a, 4096));
+    EXPECT_STREQ(b, "diophantus");
+
+    char* large = static_cast<char*>(arena.reallocate(b, 10 * GmpArena::defaultChunkSize));
+    EXPECT_STREQ(large, "diophantus");
+    EXPECT_TRUE(arena.owns(large));
+}
+
+TEST(GmpArenaTest, ForeignMemoryIsNotOwned)
+{
+    GmpArena arena;
+    std::vector<char> foreign(64);
+
+    EXPECT_FALSE(arena.owns(foreign.data()));
+}
+
+TEST(GmpArenaTest, ScopeServesGmpAllocations)
+{
+    // Allocated before the scope, but released inside of it
+    auto outside = std::make_unique<mpz_class>("123456789012345678901234567890");
+
+    GmpArena arena;
+    {
+        GmpArenaScope scope(arena);
+
+        mpz_class a("98765432109876543210987654321");
+        mpz_class b = a * a;
+        EXPECT_TRUE(arena.owns(b.get_mpz_t()->_mp_d));
+        EXPECT_EQ(b / a, a);
+
+        // Reallocating moves the value into the arena
+        *outside *= b;
+        EXPECT_TRUE(arena.owns(outside->get_mpz_t()->_mp_d));
+        outside.reset();
+    }
+
+    // The previous allocator is active again
+    mpz_class after("123456789012345678901234567890");
+    after *= after;
+    EXPECT_FALSE(arena.owns(after.get_mpz_t()->_mp_d));
+}
+
+TEST(GmpArenaTest, SuspendedScopeUsesPreviousAllocator)
+{
+    GmpArena arena;
+    std::vector<mpz_class> results;
+
+    {
+        GmpArenaScope scope(arena);
+        mpz_class value("340282366920938463463374607431768211456");
+        value *= value;
+
+        GmpArenaScope::Suspension suspension(scope);
+        results.push_back(value);
+    }
+
+    // The copy must not live in the arena, which is still alive here
+    EXPECT_FALSE(arena.owns(results.front().get_mpz_t()->_mp_d));
+    EXPECT_EQ(results.front(), mpz_class("340282366920938463463374607431768211456")
+                             * mpz_class("340282366920938463463374607431768211456"));
+}
+
+TEST(GmpArenaTest, NestedScopes)
+{
+    GmpArena outerArena;
+    GmpArena innerArena;
+
+    GmpArenaScope outerScope(outerArena);
+    auto outer = std::make_unique<mpz_class>("1000000000000000000000000000000");
+    EXPECT_TRUE(outerArena.owns(outer->get_mpz_t()->_mp_d));
+    {
+        GmpArenaScope innerScope(innerArena);
+        mpz_class inner = *outer * *outer;
+        EXPECT_TRUE(innerArena.owns(inner.get_mpz_t()->_mp_d));
+
+        // Memory of the outer arena is handed back to it
+        size_t nOuterAllocations = outerArena.getAllocationCount();
+        outer.reset();
+        outer = std::make_unique<mpz_class>(inner);
+        EXPECT_EQ(outerArena.getAllocationCount(), nOuterAllocations);
+        outer.reset();
+    }
+
+    mpz_class afterInner("1000000000000000000000000000000");
+    EXPECT_TRUE(outerArena.owns(afterInner.get_mpz_t()->_mp_d));
+}
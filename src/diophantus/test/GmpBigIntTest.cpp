@@ -149,3 +149,33 @@ TEST(GmpBigIntTest, NoOverflow)
 
     EXPECT_GT(bigIntAfterIncrement, bigIntBeforeIncrement);
 }
+
+TEST(GmpBigIntTest, InPlaceArithmetic)
+{
+    Number a{10};
+
+    a.addMul(Number(3), Number(4));
+    EXPECT_EQ(a, 22);
+
+    a.subMul(Number(5), Number(6));
+    EXPECT_EQ(a, -8);
+
+    a.negate();
+    EXPECT_EQ(a, 8);
+}
+
+TEST(GmpBigIntTest, ExactDivisionAndContent)
+{
+    Number a{-42};
+    a.divExact(Number(6));
+    EXPECT_EQ(a, -7);
+
+    Number g{480};
+    g.gcdWith(Number(-200));
+    EXPECT_EQ(g, 40);
+
+    EXPECT_TRUE(Number(42).isDivisibleBy(Number(-7)));
+    EXPECT_FALSE(Number(43).isDivisibleBy(Number(7)));
+    EXPECT_TRUE(Number(0).isDivisibleBy(Number(0)));
+    EXPECT_FALSE(Number(5).isDivisibleBy(Number(0)));
+}
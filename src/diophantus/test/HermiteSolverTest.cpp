@@ -0,0 +1,189 @@
+#include <diophantus/HermiteSolver.hpp>
+#include <diophantus/Validator.hpp>
+
+#include <diophantus/model/Equation.hpp>
+#include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/Solution.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+#include <diophantus/model/util.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+
+using NumT = diophantus::model::numeric::GmpBigInt;
+
+using Equation = diophantus::model::Equation<NumT>;
+using EquationSystem = diophantus::model::EquationSystem<NumT>;
+using Solution = diophantus::model::Solution<NumT>;
+using Sum = diophantus::model::Sum<NumT>;
+using Term = diophantus::model::Term<NumT>;
+
+using HermiteSolver = diophantus::HermiteSolver<NumT>;
+using Validator = diophantus::Validator<NumT>;
+
+
+namespace
+{
+    /**
+     * Checks that the vector solves the homogeneous version of every equation.
+     */
+    bool isKernelVector(const EquationSystem& equationSystem, const std::vector<NumT>& vector)
+    {
+        for (const auto& equation : equationSystem.getEquations())
+        {
+            NumT value(0);
+            for (const auto& term : equation.getLeftSide().getTerms())
+            {
+                value.addMul(term.getCoefficient(), vector[term.getVariable()]);
+            }
+            if (value != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST(HermiteSolverTest, UniqueSolution)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // Solution is x = (1, -2, 3)
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {2, 1, 1}, 3);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {1, 3, 2}, 1);
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {4, -1, 5}, 21);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2, equation3});
+
+    HermiteSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    ASSERT_TRUE(solution.has_value());
+    EXPECT_EQ(solver.getRank(), 3);
+    EXPECT_TRUE(solver.getKernelBasis().empty());
+
+    Validator val(equationSystem);
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+    EXPECT_EQ(solution.value().assignments[0].value, 1);
+    EXPECT_EQ(solution.value().assignments[1].value, -2);
+    EXPECT_EQ(solution.value().assignments[2].value, 3);
+}
+
+TEST(HermiteSolverTest, UnderdeterminedSystemKernelBasis)
+{
+    size_t nVariables = 5;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 31, 0, -4}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14, 9, 0}, 7);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    HermiteSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    ASSERT_TRUE(solution.has_value());
+    Validator val(equationSystem);
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+
+    EXPECT_EQ(solver.getRank(), 2);
+    ASSERT_EQ(solver.getKernelBasis().size(), 3);
+    for (const auto& basisVector : solver.getKernelBasis())
+    {
+        EXPECT_TRUE(isKernelVector(equationSystem, basisVector));
+    }
+
+    // Adding a kernel vector gives another solution
+    Solution shiftedSolution = solution.value();
+    for (size_t i = 0; i < nVariables; ++i)
+    {
+        shiftedSolution.assignments[i].value += solver.getKernelBasis()[0][i];
+    }
+    EXPECT_TRUE(val.isValidSolution(shiftedSolution));
+}
+
+TEST(HermiteSolverTest, NonIntegralRationalSolution)
+{
+    size_t nVariables = 2;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // Over the rationals x0 = 1/2, x1 = 0 solves the equation, the lattice still contains
+    // x0 = -1, x1 = 1
+    auto equation = diophantus::model::makeEquation<NumT>(variables, {2, 3}, 1);
+
+    auto equationSystem = EquationSystem(variables, {equation});
+
+    HermiteSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    ASSERT_TRUE(solution.has_value());
+    Validator val(equationSystem);
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+}
+
+TEST(HermiteSolverTest, DependentEquations)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {1, 2, 3}, 4);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {2, 4, 6}, 8);
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {0, 5, -1}, 2);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2, equation3});
+
+    HermiteSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    ASSERT_TRUE(solution.has_value());
+    EXPECT_EQ(solver.getRank(), 2);
+    Validator val(equationSystem);
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+}
+
+TEST(HermiteSolverTest, Unsolvable)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // Inconsistent over the rationals
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {1, 2, 3}, 4);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {2, 4, 6}, 9);
+
+    HermiteSolver inconsistentSolver(EquationSystem(variables, {equation1, equation2}));
+    EXPECT_FALSE(inconsistentSolver.solve().has_value());
+
+    // Solvable over the rationals, but not over the integers
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {6, 10, 4}, 3);
+
+    HermiteSolver nonIntegralSolver(EquationSystem(variables, {equation3}));
+    EXPECT_FALSE(nonIntegralSolver.solve().has_value());
+}
+
+TEST(HermiteSolverTest, CheckedInt64)
+{
+    using FixedNumT = diophantus::model::numeric::CheckedInt64;
+
+    size_t nVariables = 4;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<FixedNumT>(variables, {5, -3, 8, 1}, 12);
+    auto equation2 = diophantus::model::makeEquation<FixedNumT>(variables, {2, 7, 0, -6}, -5);
+
+    auto equationSystem = diophantus::model::EquationSystem<FixedNumT>(variables, {equation1, equation2});
+
+    diophantus::HermiteSolver<FixedNumT> solver(equationSystem);
+    auto solution = solver.solve();
+
+    ASSERT_TRUE(solution.has_value());
+    diophantus::Validator<FixedNumT> val(equationSystem);
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+}
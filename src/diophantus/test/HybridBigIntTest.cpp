@@ -0,0 +1,261 @@
+#include <diophantus/model/numeric/BigInt.hpp>
+#include <diophantus/model/numeric/HybridBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+
+
+// Compile time check: Does HybridBigInt satisfy BigInt concept constraints?
+namespace diophantus::test
+{
+    template<diophantus::model::numeric::BigInt NumT> class Foo {};
+    using FooHybridBigInt = Foo<diophantus::model::numeric::HybridBigInt>;
+}
+
+
+using Number = diophantus::model::numeric::HybridBigInt;
+
+constexpr long maxLong = std::numeric_limits<long>::max();
+constexpr long minLong = std::numeric_limits<long>::min();
+
+TEST(HybridBigIntTest, InitializerEquality)
+{
+    Number a{5};
+    Number b{"5"};
+
+    EXPECT_EQ(a, b);
+    EXPECT_TRUE(b.isSmall());
+}
+
+TEST(HybridBigIntTest, Negation)
+{
+    Number a{5};
+    Number b{-5};
+
+    EXPECT_EQ(-a, b);
+}
+
+TEST(HybridBigIntTest, Multiplication)
+{
+    Number a{6};
+    Number b{7};
+
+    EXPECT_EQ(a*b, 42);
+}
+
+TEST(HybridBigIntTest, Modulo)
+{
+    Number a{23};
+    Number b{4};
+
+    EXPECT_EQ(a % b, 3);
+    EXPECT_EQ(Number(-23) % b, -3);
+}
+
+TEST(HybridBigIntTest, Absolute)
+{
+    Number a{-5};
+    EXPECT_EQ(Number::abs(a), 5);
+
+    Number b{3};
+    EXPECT_EQ(Number::abs(b), 3);
+}
+
+TEST(HybridBigIntTest, GCD)
+{
+    Number a{480};
+    Number b{200};
+
+    EXPECT_EQ(Number::gcd(a, b), 40);
+    EXPECT_EQ(Number::gcd(Number(-480), b), 40);
+}
+
+TEST(HybridBigIntTest, SymMod)
+{
+    EXPECT_EQ(Number::symMod(Number(10), Number(5)), 0);
+    EXPECT_EQ(Number::symMod(Number(11), Number(5)), 1);
+    EXPECT_EQ(Number::symMod(Number(12), Number(5)), 2);
+    EXPECT_EQ(Number::symMod(Number(13), Number(5)), -2);
+    EXPECT_EQ(Number::symMod(Number(14), Number(5)), -1);
+
+    EXPECT_EQ(Number::symMod(Number(-11), Number(5)), -1);
+    EXPECT_EQ(Number::symMod(Number(-13), Number(5)), 2);
+
+    EXPECT_EQ(Number::symMod(Number(15), Number(6)), -3);
+    EXPECT_EQ(Number::symMod(Number(-15), Number(6)), -3);
+
+    EXPECT_EQ(Number::symMod(Number(12), Number(8)), -4);
+    EXPECT_EQ(Number::symMod(Number(17), Number(8)), 1);
+}
+
+TEST(HybridBigIntTest, Comparison)
+{
+    Number a{1};
+    Number b{2};
+    Number c{2};
+
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(b > a);
+    EXPECT_TRUE(b == c);
+    EXPECT_TRUE(a != c);
+}
+
+TEST(HybridBigIntTest, Arithmetic)
+{
+    Number a{6};
+
+    a += Number(1);
+    EXPECT_EQ(a, 7);
+
+    a -= Number(1);
+    EXPECT_EQ(a, 6);
+
+    a *= Number(7);
+    EXPECT_EQ(a, 42);
+
+    a /= Number(6);
+    EXPECT_EQ(a, 7);
+
+    EXPECT_EQ(a + a, 14);
+}
+
+TEST(HybridBigIntTest, OverflowSwitchesToMpz)
+{
+    Number a{maxLong};
+    a += Number(1);
+
+    EXPECT_FALSE(a.isSmall());
+    EXPECT_GT(a, Number(maxLong));
+    EXPECT_GT(a, maxLong);
+
+    std::stringstream ss;
+    ss << a;
+    EXPECT_EQ(ss.str(), "9223372036854775808");
+
+    // Going back into the int64_t range switches back to the inline representation
+    a -= Number(1);
+    EXPECT_TRUE(a.isSmall());
+    EXPECT_EQ(a, maxLong);
+}
+
+TEST(HybridBigIntTest, AbsoluteHash)
+{
+    EXPECT_EQ(Number(-42).absHash(), Number(42).absHash());
+    EXPECT_NE(Number(42).absHash(), Number(43).absHash());
+
+    // The hash only depends on the value, not on its representation
+    Number a{maxLong};
+    a += Number(1);
+    EXPECT_EQ(a.absHash(), (-a).absHash());
+    a -= Number(1);
+    EXPECT_EQ(a.absHash(), Number(maxLong).absHash());
+    EXPECT_EQ(Number(minLong).absHash(), (-Number(minLong)).absHash());
+}
+
+TEST(HybridBigIntTest, MultiplicationOverflow)
+{
+    Number a{maxLong};
+    Number b = a * Number(4);
+
+    EXPECT_FALSE(b.isSmall());
+    EXPECT_EQ(b % Number(4), 0);
+
+    b /= Number(2);
+    EXPECT_FALSE(b.isSmall());
+    b /= Number(2);
+    EXPECT_TRUE(b.isSmall());
+    EXPECT_EQ(b, a);
+}
+
+TEST(HybridBigIntTest, MinimumValueEdgeCases)
+{
+    Number min{minLong};
+
+    EXPECT_FALSE((-min).isSmall());
+    EXPECT_EQ(-(-min), min);
+    EXPECT_EQ(Number::abs(min), -min);
+    EXPECT_EQ(min.absCmp(-min), std::strong_ordering::equal);
+    EXPECT_EQ(min % Number(-1), 0);
+
+    Number quotient{min};
+    quotient /= Number(-1);
+    EXPECT_FALSE(quotient.isSmall());
+    EXPECT_EQ(quotient, -min);
+
+    EXPECT_EQ(Number::gcd(min, Number(0)), -min);
+}
+
+TEST(HybridBigIntTest, MixedRepresentationComparison)
+{
+    Number big{"100000000000000000000000"};
+    Number small{maxLong};
+
+    EXPECT_TRUE(small < big);
+    EXPECT_TRUE(-big < small);
+    EXPECT_EQ(small.absCmp(-big), std::strong_ordering::less);
+    EXPECT_EQ((-big).absCmp(small), std::strong_ordering::greater);
+    EXPECT_EQ(Number::symMod(big, Number(7)), Number::symMod(Number(big % Number(7)), Number(7)));
+}
+
+TEST(HybridBigIntTest, InPlaceArithmetic)
+{
+    Number a{10};
+
+    a.addMul(Number(3), Number(4));
+    EXPECT_EQ(a, 22);
+
+    a.subMul(Number(5), Number(6));
+    EXPECT_EQ(a, -8);
+
+    a.negate();
+    EXPECT_EQ(a, 8);
+}
+
+TEST(HybridBigIntTest, InPlaceArithmeticOverflow)
+{
+    Number a{maxLong};
+    a.addMul(Number(maxLong), Number(2));
+    EXPECT_FALSE(a.isSmall());
+
+    a.subMul(Number(maxLong), Number(2));
+    EXPECT_TRUE(a.isSmall());
+    EXPECT_EQ(a, maxLong);
+
+    Number min{minLong};
+    min.negate();
+    EXPECT_FALSE(min.isSmall());
+    min.negate();
+    EXPECT_EQ(min, minLong);
+}
+
+TEST(HybridBigIntTest, ExactDivisionAndContent)
+{
+    Number a{-42};
+    a.divExact(Number(6));
+    EXPECT_EQ(a, -7);
+
+    Number g{480};
+    g.gcdWith(Number(-200));
+    EXPECT_EQ(g, 40);
+
+    EXPECT_TRUE(Number(42).isDivisibleBy(Number(-7)));
+    EXPECT_FALSE(Number(43).isDivisibleBy(Number(7)));
+    EXPECT_TRUE(Number(0).isDivisibleBy(Number(0)));
+    EXPECT_FALSE(Number(5).isDivisibleBy(Number(0)));
+}
+
+TEST(HybridBigIntTest, ExactDivisionOfLargeValues)
+{
+    Number big = Number(maxLong) * Number(6);
+    EXPECT_TRUE(big.isDivisibleBy(Number(maxLong)));
+    EXPECT_FALSE(big.isDivisibleBy(Number(4)));
+
+    big.divExact(Number(3));
+    EXPECT_FALSE(big.isSmall());
+    big.divExact(Number(2));
+    EXPECT_TRUE(big.isSmall());
+    EXPECT_EQ(big, maxLong);
+}
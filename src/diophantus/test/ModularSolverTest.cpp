@@ -0,0 +1,170 @@
+#include <diophantus/ModularSolver.hpp>
+#include <diophantus/Validator.hpp>
+
+#include <diophantus/model/Equation.hpp>
+#include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/Solution.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+#include <diophantus/model/util.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+#include <diophantus/model/numeric/HybridBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+
+using NumT = diophantus::model::numeric::GmpBigInt;
+
+using Equation = diophantus::model::Equation<NumT>;
+using EquationSystem = diophantus::model::EquationSystem<NumT>;
+using Solution = diophantus::model::Solution<NumT>;
+using Sum = diophantus::model::Sum<NumT>;
+using Term = diophantus::model::Term<NumT>;
+
+using ModularSolver = diophantus::ModularSolver<NumT>;
+using Validator = diophantus::Validator<NumT>;
+
+
+TEST(ModularSolverTest, UniqueSolution)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // Solution is x = (1, -2, 3)
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {2, 1, 1}, 3);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {1, 3, 2}, 1);
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {4, -1, 5}, 21);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2, equation3});
+
+    ModularSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+    EXPECT_FALSE(solver.hasUsedFallback());
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(ModularSolverTest, LargeSolutionNeedsSeveralPrimes)
+{
+    size_t nVariables = 2;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // Solution is x0 = 10^40, x1 = 10^40 - 1
+    std::vector<Term> terms1 {Term(1, variables[0]), Term(-1, variables[1])};
+    std::vector<Term> terms2 {Term(1, variables[0]), Term(1, variables[1])};
+    auto equation1 = Equation(Sum(terms1), 1);
+    auto equation2 = Equation(Sum(terms2), NumT("19999999999999999999999999999999999999999"));
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    ModularSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+    EXPECT_FALSE(solver.hasUsedFallback());
+    EXPECT_GT(solver.getPrimeCount(), 1);
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(ModularSolverTest, UnderdeterminedSystem)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 31}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14}, 7);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    ModularSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(ModularSolverTest, NonIntegralFallback)
+{
+    size_t nVariables = 2;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // The particular solution x0 = 1/2, x1 = 0 is not integral, but x0 = -1, x1 = 1 is
+    auto equation = diophantus::model::makeEquation<NumT>(variables, {2, 3}, 1);
+
+    auto equationSystem = EquationSystem(variables, {equation});
+
+    ModularSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+    EXPECT_TRUE(solver.hasUsedFallback());
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(ModularSolverTest, Unsolvable)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {1, 2, 3}, 4);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {2, 4, 6}, 9);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    ModularSolver solver(equationSystem);
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_FALSE(solution.has_value());
+    EXPECT_TRUE(solver.hasUsedFallback());
+}
+
+TEST(ModularSolverTest, HybridBigInt)
+{
+    using HybridNumT = diophantus::model::numeric::HybridBigInt;
+
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<HybridNumT>(variables, {2, 1, 1}, 3);
+    auto equation2 = diophantus::model::makeEquation<HybridNumT>(variables, {1, 3, 2}, 1);
+    auto equation3 = diophantus::model::makeEquation<HybridNumT>(variables, {4, -1, 5}, 21);
+
+    auto equationSystem = diophantus::model::EquationSystem<HybridNumT>(
+        variables, {equation1, equation2, equation3});
+
+    diophantus::ModularSolver<HybridNumT> solver(equationSystem);
+    auto solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+    EXPECT_FALSE(solver.hasUsedFallback());
+
+    if (solution.has_value())
+    {
+        diophantus::Validator<HybridNumT> val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
@@ -0,0 +1,99 @@
+#include <diophantus/PivotQueue.hpp>
+#include <diophantus/model/Equation.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using NumT = diophantus::model::numeric::GmpBigInt;
+
+using Term = diophantus::model::Term<NumT>;
+using Sum = diophantus::model::Sum<NumT>;
+using Equation = diophantus::model::Equation<NumT>;
+using PivotQueue = diophantus::PivotQueue<NumT>;
+
+TEST(PivotQueueTest, LowestCoefficientFirst)
+{
+    std::vector<Equation> equations = {
+        Equation(Sum({Term(6, 1), Term(9, 2)}), 3),
+        Equation(Sum({Term(8, 1), Term(-4, 3), Term(12, 4)}), 4),
+        Equation(Sum({Term(5, 2), Term(7, 3)}), 1)
+    };
+
+    PivotQueue queue;
+    for (size_t i = 0; i < equations.size(); ++i)
+    {
+        queue.update(i, equations[i]);
+    }
+
+    EXPECT_EQ(queue.top().equationIndex, 1);
+    EXPECT_EQ(queue.top().termIndex, 1);
+
+    queue.remove(1);
+    EXPECT_EQ(queue.top().equationIndex, 2);
+    EXPECT_EQ(queue.top().termIndex, 0);
+
+    queue.remove(2);
+    queue.remove(2);
+    EXPECT_EQ(queue.top().equationIndex, 0);
+    queue.remove(0);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(PivotQueueTest, FastLane)
+{
+    std::vector<Equation> equations = {
+        Equation(Sum({Term(2, 1), Term(3, 2)}), 3),
+        Equation(Sum({Term(7, 1), Term(-1, 3)}), 4),
+        Equation(Sum({Term(9, 2)}), 9),
+        Equation(Sum({Term(1, 2), Term(5, 4)}), 1)
+    };
+
+    PivotQueue queue;
+    for (size_t i = 0; i < equations.size(); ++i)
+    {
+        queue.update(i, equations[i]);
+    }
+
+    // A single term comes first, then unit coefficients in the order of the equations
+    EXPECT_EQ(queue.top().equationIndex, 2);
+    queue.remove(2);
+    EXPECT_EQ(queue.top().equationIndex, 1);
+    EXPECT_EQ(queue.top().termIndex, 1);
+    queue.remove(1);
+    EXPECT_EQ(queue.top().equationIndex, 3);
+}
+
+TEST(PivotQueueTest, UpdateAndMove)
+{
+    std::vector<Equation> equations = {
+        Equation(Sum({Term(4, 1), Term(6, 2)}), 2),
+        Equation(Sum({Term(3, 1), Term(10, 2)}), 5),
+        Equation(Sum({Term(3, 1), Term(9, 3)}), 3)
+    };
+
+    PivotQueue queue;
+    for (size_t i = 0; i < equations.size(); ++i)
+    {
+        queue.update(i, equations[i]);
+    }
+    EXPECT_EQ(queue.top().equationIndex, 1);
+
+    // The first equation changes
+    equations[0] = Equation(Sum({Term(2, 1), Term(3, 2)}), 1);
+    queue.update(0, equations[0]);
+    EXPECT_EQ(queue.top().equationIndex, 0);
+
+    // The first equation is removed and the last one takes its place, winning the tie
+    queue.remove(0);
+    queue.move(2, 0);
+    EXPECT_EQ(queue.top().equationIndex, 0);
+    queue.remove(0);
+    EXPECT_EQ(queue.top().equationIndex, 1);
+    queue.remove(1);
+    EXPECT_TRUE(queue.isEmpty());
+}
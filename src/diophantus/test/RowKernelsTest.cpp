@@ -0,0 +1,198 @@
+#include <diophantus/model/RowKernels.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+#include <diophantus/model/numeric/CheckedInt64.hpp>
+#include <diophantus/model/numeric/OverflowError.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace kernels = diophantus::model::kernels;
+
+using Number = diophantus::model::numeric::CheckedInt64;
+using Sum = diophantus::model::Sum<Number>;
+using Term = diophantus::model::Term<Number>;
+
+constexpr int64_t maxInt64 = std::numeric_limits<int64_t>::max();
+constexpr int64_t minInt64 = std::numeric_limits<int64_t>::min();
+
+
+namespace
+{
+    /**
+     * Generates rows of all lengths up to 40 with values of different magnitudes, so that the
+     * vectorized loops, their tails and the scalar fallbacks for large values are all exercised,
+     * as well as rows with values at the bounds of the vectorized arithmetic.
+     */
+    std::vector<std::vector<int64_t>> makeRows()
+    {
+        std::mt19937_64 generator(42);
+        std::vector<std::vector<int64_t>> rows;
+
+        for (int64_t bound : {int64_t(3), int64_t(1000), int64_t(1) << 40, maxInt64})
+        {
+            std::uniform_int_distribution<int64_t> distribution(-bound, bound);
+            for (size_t size = 0; size <= 40; ++size)
+            {
+                std::vector<int64_t> row(size);
+                for (int64_t& value : row)
+                {
+                    value = distribution(generator);
+                }
+                rows.push_back(row);
+            }
+        }
+
+        // Values at the bounds of the vectorized arithmetic, in the vectorized part of the row
+        for (int64_t bound : {int64_t(1) << 31, int64_t(1) << 51})
+        {
+            for (int64_t value : {bound - 1, bound, -bound, -bound - 1})
+            {
+                rows.push_back({3, value, -2, 1, 5});
+            }
+        }
+
+        rows.push_back({0, 0, 0, 0, 0, 0, 0});
+        rows.push_back({0, 5, -3, 3, 7, -3, 3, 9, 3});
+        rows.push_back({4, -2, 2, -2, 8, 2, 6, 10, -2, 2});
+        rows.push_back({minInt64, 1, -1, maxInt64, 0, 17, -17, 5});
+        return rows;
+    }
+
+    using Pairs = std::vector<std::pair<int64_t, unsigned int>>;
+
+    // coefficients and variables of the terms of a sum
+    Pairs toPairs(const Sum& sum)
+    {
+        Pairs pairs;
+        for (const auto& term : sum.getTerms())
+        {
+            pairs.emplace_back(term.getCoefficient().get(), term.getVariable());
+        }
+        return pairs;
+    }
+}
+
+
+TEST(RowKernelsTest, ScalarSymMod)
+{
+    std::vector<int64_t> row = {-7, -6, -5, -1, 0, 1, 5, 6, 7, minInt64, maxInt64};
+    kernels::scalar::symModAll(row.data(), row.size(), 5);
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        EXPECT_GE(row[i], -2);
+        EXPECT_LE(row[i], 2);
+    }
+    EXPECT_EQ(row[0], -2);
+    EXPECT_EQ(row[3], -1);
+    EXPECT_EQ(row[6], 0);
+    EXPECT_EQ(row[8], 2);
+
+    // with an even modulus, the symmetric remainder lies in [-m/2, m/2)
+    std::vector<int64_t> evenRow = {2, -2, 3};
+    kernels::scalar::symModAll(evenRow.data(), evenRow.size(), 4);
+    EXPECT_EQ(evenRow, std::vector<int64_t>({-2, -2, -1}));
+}
+
+TEST(RowKernelsTest, ScalarDivideAndMultiplyOverflow)
+{
+    std::vector<int64_t> row = {4, minInt64, 8};
+    EXPECT_FALSE(kernels::scalar::divideAll(row.data(), row.size(), -1));
+    EXPECT_FALSE(kernels::scalar::divideAll(row.data(), row.size(), 0));
+    EXPECT_EQ(row, std::vector<int64_t>({4, minInt64, 8}));
+
+    std::vector<int64_t> largeRow = {1, maxInt64 / 2 + 1, 2};
+    EXPECT_FALSE(kernels::scalar::multiplyAll(largeRow.data(), largeRow.size(), 2));
+    EXPECT_EQ(largeRow, std::vector<int64_t>({1, maxInt64 / 2 + 1, 2}));
+
+    std::vector<int64_t> smallRow = {-7, 0, 3};
+    EXPECT_TRUE(kernels::scalar::divideAll(smallRow.data(), smallRow.size(), 2));
+    EXPECT_EQ(smallRow, std::vector<int64_t>({-3, 0, 1}));
+}
+
+TEST(RowKernelsTest, ScalarFindLowestAbsolute)
+{
+    std::vector<int64_t> row = {5, -3, 3, -3};
+    EXPECT_EQ(kernels::scalar::findLowestAbsolute(row.data(), row.size()), 1);
+
+    std::vector<int64_t> leadingZero = {0, 5, 1};
+    EXPECT_EQ(kernels::scalar::findLowestAbsolute(leadingZero.data(), leadingZero.size()), 0);
+
+    std::vector<int64_t> innerZero = {5, 0, 2};
+    EXPECT_EQ(kernels::scalar::findLowestAbsolute(innerZero.data(), innerZero.size()), 2);
+
+    EXPECT_EQ(kernels::scalar::findLowestAbsolute(nullptr, 0), 0);
+}
+
+TEST(RowKernelsTest, Avx2MatchesScalar)
+{
+    if (!kernels::isAvx2Supported())
+    {
+        GTEST_SKIP() << "AVX2 is not supported on this CPU";
+    }
+
+    for (const std::vector<int64_t>& row : makeRows())
+    {
+        for (int64_t modulus : {int64_t(1), int64_t(2), int64_t(7), int64_t(1) << 33, maxInt64})
+        {
+            std::vector<int64_t> expected = row;
+            std::vector<int64_t> actual = row;
+            kernels::scalar::symModAll(expected.data(), row.size(), modulus);
+            kernels::avx2::symModAll(actual.data(), row.size(), modulus);
+            EXPECT_EQ(actual, expected) << "symMod by " << modulus;
+        }
+
+        for (int64_t divisor : {int64_t(1), int64_t(-1), int64_t(3), int64_t(-8), int64_t(1) << 35})
+        {
+            std::vector<int64_t> expected = row;
+            std::vector<int64_t> actual = row;
+            bool expectedResult = kernels::scalar::divideAll(expected.data(), row.size(), divisor);
+            bool actualResult = kernels::avx2::divideAll(actual.data(), row.size(), divisor);
+            EXPECT_EQ(actualResult, expectedResult);
+            EXPECT_EQ(actual, expected) << "divide by " << divisor;
+        }
+
+        for (int64_t factor : {int64_t(0), int64_t(1), int64_t(-1), int64_t(12345), int64_t(1) << 40})
+        {
+            std::vector<int64_t> expected = row;
+            std::vector<int64_t> actual = row;
+            bool expectedResult = kernels::scalar::multiplyAll(expected.data(), row.size(), factor);
+            bool actualResult = kernels::avx2::multiplyAll(actual.data(), row.size(), factor);
+            EXPECT_EQ(actualResult, expectedResult);
+            EXPECT_EQ(actual, expected) << "multiply by " << factor;
+        }
+
+        EXPECT_EQ(kernels::avx2::findLowestAbsolute(row.data(), row.size()),
+                  kernels::scalar::findLowestAbsolute(row.data(), row.size()));
+    }
+}
+
+TEST(RowKernelsTest, SumOperations)
+{
+    Sum sum({Term(Number(12), 1), Term(Number(-7), 2), Term(Number(3), 3), Term(Number(-3), 4)});
+    EXPECT_EQ(sum.getLowestCoefficientTerm().getVariable(), 3);
+
+    sum.coefficientsModulo(Number(5));
+    EXPECT_EQ(toPairs(sum), Pairs({{2, 1}, {-2, 2}, {-2, 3}, {2, 4}}));
+
+    sum.divideCoefficientsExactlyBy(Number(-2));
+    EXPECT_EQ(toPairs(sum), Pairs({{-1, 1}, {1, 2}, {1, 3}, {-1, 4}}));
+
+    Sum other({Term(Number(1), 1), Term(Number(4), 5)});
+    sum.addMultipleOf(other, Number(3));
+    EXPECT_EQ(toPairs(sum), Pairs({{2, 1}, {1, 2}, {1, 3}, {-1, 4}, {12, 5}}));
+
+    // Terms whose coefficient vanishes are removed
+    sum.addMultipleOf(Sum({Term(Number(1), 1)}), Number(-2));
+    EXPECT_EQ(toPairs(sum), Pairs({{1, 2}, {1, 3}, {-1, 4}, {12, 5}}));
+
+    // Products that don't fit into 64 bits are left to the checked scalar path
+    EXPECT_THROW(sum.addMultipleOf(Sum({Term(Number(maxInt64), 2)}), Number(2)),
+                 diophantus::model::numeric::OverflowError);
+}
@@ -0,0 +1,472 @@
+#include <cli/Parser.hpp>
+
+#include <diophantus/EliminationPlan.hpp>
+#include <diophantus/Solver.hpp>
+#include <diophantus/SolvingEngine.hpp>
+
+#include <diophantus/model/EquationSystem.hpp>
+#include <diophantus/model/RowPolicy.hpp>
+#include <diophantus/model/VariableOrdering.hpp>
+#include <diophantus/model/Solution.hpp>
+#include <diophantus/model/ThreadPool.hpp>
+#include <diophantus/model/util.hpp>
+#include <diophantus/model/numeric/GmpArena.hpp>
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gmp.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+using NumT = diophantus::model::numeric::GmpBigInt;
+using EquationSystem = diophantus::model::EquationSystem<NumT>;
+using Solver = diophantus::Solver<NumT>;
+
+using diophantus::model::numeric::GmpArena;
+using diophantus::model::numeric::GmpArenaScope;
+
+namespace
+{
+    EquationSystem makeRandomSystem(size_t nEquations, size_t nVariables, long maxCoefficient)
+    {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<long> distribution(-maxCoefficient, maxCoefficient);
+
+        auto variables = diophantus::model::make_variables(nVariables);
+        std::vector<diophantus::model::Equation<NumT>> equations;
+        for (size_t i = 0; i < nEquations; ++i)
+        {
+            std::vector<long> coefficients(nVariables);
+            for (auto& coefficient : coefficients)
+            {
+                coefficient = distribution(generator);
+            }
+            equations.push_back(diophantus::model::makeEquation<NumT>(variables, coefficients,
+                                                                      distribution(generator)));
+        }
+        return EquationSystem(variables, equations);
+    }
+
+    /**
+     * Generates a solvable equation system in which each coefficient is nonzero with the given
+     * probability. The right sides are computed from a random solution.
+     */
+    EquationSystem makeSystemWithDensity(size_t nEquations, size_t nVariables, long maxCoefficient,
+                                         double density)
+    {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<long> distribution(-maxCoefficient, maxCoefficient);
+        std::bernoulli_distribution isNonzero(density);
+
+        std::vector<long> solution(nVariables);
+        for (auto& value : solution)
+        {
+            value = distribution(generator);
+        }
+
+        auto variables = diophantus::model::make_variables(nVariables);
+        std::vector<diophantus::model::Equation<NumT>> equations;
+        for (size_t i = 0; i < nEquations; ++i)
+        {
+            std::vector<long> coefficients(nVariables, 0);
+            long rightSide = 0;
+            for (size_t j = 0; j < nVariables; ++j)
+            {
+                if (isNonzero(generator))
+                {
+                    coefficients[j] = distribution(generator);
+                    rightSide += coefficients[j] * solution[j];
+                }
+            }
+            equations.push_back(diophantus::model::makeEquation<NumT>(variables, coefficients, rightSide));
+        }
+        return EquationSystem(variables, equations);
+    }
+
+    /**
+     * Wraps GMP's current memory functions and measures the time spent in them.
+     */
+    class AllocatorTimer
+    {
+        public:
+            AllocatorTimer()
+            {
+                mp_get_memory_functions(&allocate, &reallocate, &deallocate);
+                mp_set_memory_functions(&timedAllocate, &timedReallocate, &timedDeallocate);
+                elapsed = std::chrono::nanoseconds(0);
+                nCalls = 0;
+            }
+
+            ~AllocatorTimer()
+            {
+                mp_set_memory_functions(allocate, reallocate, deallocate);
+            }
+
+            static inline std::chrono::nanoseconds elapsed;
+            static inline size_t nCalls;
+
+        private:
+            static void* timedAllocate(size_t size)
+            {
+                auto startTime = std::chrono::steady_clock::now();
+                void* ptr = allocate(size);
+                record(startTime);
+                return ptr;
+            }
+
+            static void* timedReallocate(void* ptr, size_t oldSize, size_t newSize)
+            {
+                auto startTime = std::chrono::steady_clock::now();
+                void* newPtr = reallocate(ptr, oldSize, newSize);
+                record(startTime);
+                return newPtr;
+            }
+
+            static void timedDeallocate(void* ptr, size_t size)
+            {
+                auto startTime = std::chrono::steady_clock::now();
+                deallocate(ptr, size);
+                record(startTime);
+            }
+
+            static void record(std::chrono::steady_clock::time_point startTime)
+            {
+                elapsed += std::chrono::steady_clock::now() - startTime;
+                ++nCalls;
+            }
+
+            static inline void* (*allocate)(size_t);
+            static inline void* (*reallocate)(void*, size_t, size_t);
+            static inline void (*deallocate)(void*, size_t);
+    };
+
+    long long measureMicroseconds(const EquationSystem& equationSystem,
+                                  const Solver::Parameters& parameters)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        {
+            Solver solver(equationSystem, parameters);
+            auto solution = solver.solve();
+            EXPECT_TRUE(solution.has_value());
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    }
+
+    void printAllocatorShare(const std::string& name, long long totalMicroseconds)
+    {
+        auto allocatorMicroseconds =
+            std::chrono::duration_cast<std::chrono::microseconds>(AllocatorTimer::elapsed).count();
+        std::cout << name << ": " << AllocatorTimer::nCalls << " allocator calls, "
+                  << allocatorMicroseconds << " us of " << totalMicroseconds << " us ("
+                  << 100.0 * allocatorMicroseconds / totalMicroseconds << "%)" << std::endl;
+    }
+}
+
+TEST(SolverPerformanceTest, GmpArenaMeasureTime)
+{
+    const EquationSystem equationSystem = makeRandomSystem(30, 40, 1000);
+
+    long long defaultTime = measureMicroseconds(equationSystem, {});
+    long long arenaTime = measureMicroseconds(equationSystem, {.doUseGmpArena = true});
+
+    std::cout << "Measured solving time with default allocator: " << defaultTime << " us" << std::endl;
+    std::cout << "Measured solving time with GMP arena: " << arenaTime << " us" << std::endl;
+}
+
+TEST(SolverPerformanceTest, GmpArenaAllocatorShare)
+{
+    const EquationSystem equationSystem = makeRandomSystem(30, 40, 1000);
+
+    {
+        AllocatorTimer timer;
+        long long totalTime = measureMicroseconds(equationSystem, {});
+        printAllocatorShare("Default allocator", totalTime);
+    }
+
+    {
+        // Install the arena here, so that the timer wraps the arena's memory functions
+        GmpArena arena;
+        GmpArenaScope scope(arena);
+        AllocatorTimer timer;
+        long long totalTime = measureMicroseconds(equationSystem, {});
+        printAllocatorShare("GMP arena", totalTime);
+    }
+}
+
+TEST(SolverPerformanceTest, RowLayoutMeasureTime)
+{
+    using diophantus::model::RowLayout;
+
+    for (double density : {0.05, 0.2, 0.5, 1.0})
+    {
+        const EquationSystem equationSystem = makeSystemWithDensity(40, 60, 1000, density);
+
+        long long sparseTime = measureMicroseconds(equationSystem, {.rowPolicy = {.layout = RowLayout::Sparse}});
+        long long denseTime = measureMicroseconds(equationSystem, {.rowPolicy = {.layout = RowLayout::Dense}});
+        long long adaptiveTime = measureMicroseconds(equationSystem, {.rowPolicy = {.layout = RowLayout::Adaptive}});
+
+        std::cout << "Measured solving time at density " << density << ": sparse " << sparseTime
+                  << " us, dense " << denseTime << " us, adaptive " << adaptiveTime << " us" << std::endl;
+    }
+}
+
+TEST(SolverPerformanceTest, VariableRenumberingMeasureTime)
+{
+    using diophantus::model::VariableOrdering;
+
+    for (double density : {0.05, 0.2, 1.0})
+    {
+        const EquationSystem equationSystem = makeSystemWithDensity(40, 60, 1000, density);
+
+        long long defaultTime = measureMicroseconds(equationSystem, {});
+        long long compactTime = measureMicroseconds(equationSystem, {.variableRenumbering = VariableOrdering::Compact});
+        long long rcmTime = measureMicroseconds(equationSystem, {.variableRenumbering = VariableOrdering::ReverseCuthillMcKee});
+
+        std::cout << "Measured solving time at density " << density << ": without renumbering " << defaultTime
+                  << " us, compact " << compactTime << " us, reverse Cuthill-McKee " << rcmTime << " us" << std::endl;
+    }
+}
+
+TEST(SolverPerformanceTest, SolvingEngineMeasureTime)
+{
+    using diophantus::SolvingEngine;
+
+    auto printTimes = [](const std::string& name, const EquationSystem& equationSystem) {
+        long long eliminationTime = measureMicroseconds(equationSystem, {.engine = SolvingEngine::Elimination});
+        long long hermiteTime = measureMicroseconds(equationSystem, {.engine = SolvingEngine::HermiteNormalForm});
+
+        std::cout << "Measured solving time for " << name << ": elimination " << eliminationTime
+                  << " us, Hermite normal form " << hermiteTime << " us" << std::endl;
+    };
+
+    cli::Parser parser;
+    for (const std::string name : {"ex-5-5", "ex-10-10", "ex-100-100"})
+    {
+        std::optional<EquationSystem> equationSystem =
+            parser.parse<NumT>(std::filesystem::path(DIOPHANTUS_EXAMPLES_DIR) / name);
+        ASSERT_TRUE(equationSystem.has_value());
+        printTimes(name, equationSystem.value());
+    }
+
+    for (auto [nEquations, nVariables] : {std::pair(20, 30), std::pair(40, 60), std::pair(60, 80)})
+    {
+        for (double density : {0.2, 1.0})
+        {
+            const EquationSystem equationSystem = makeSystemWithDensity(nEquations, nVariables, 1000, density);
+            printTimes(std::to_string(nEquations) + "x" + std::to_string(nVariables) + " at density "
+                       + std::to_string(static_cast<int>(density * 100)) + "%", equationSystem);
+        }
+    }
+}
+
+TEST(SolverPerformanceTest, BatchSolvingMeasureTime)
+{
+    const size_t nRightSides = 200;
+    const EquationSystem equationSystem = makeSystemWithDensity(30, 40, 1000, 0.2);
+
+    // Right sides of random solutions, so that all of them are solvable
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<long> distribution(-1000, 1000);
+    std::vector<std::vector<NumT>> rightSides;
+    for (size_t i = 0; i < nRightSides; ++i)
+    {
+        std::vector<NumT> solution;
+        for (size_t j = 0; j < equationSystem.getVariableCount(); ++j)
+        {
+            solution.emplace_back(distribution(generator));
+        }
+
+        std::vector<NumT>& rightSide = rightSides.emplace_back();
+        for (const auto& equation : equationSystem.getEquations())
+        {
+            NumT& constant = rightSide.emplace_back(0);
+            for (const auto& term : equation.getLeftSide().getTerms())
+            {
+                constant.addMul(term.getCoefficient(), solution[term.getVariable()]);
+            }
+        }
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (const auto& rightSide : rightSides)
+    {
+        std::vector<diophantus::model::Equation<NumT>> equations;
+        for (size_t j = 0; j < rightSide.size(); ++j)
+        {
+            equations.emplace_back(equationSystem.getEquations()[j].getLeftSide(), rightSide[j]);
+        }
+        Solver solver(EquationSystem(equationSystem.getVariables(), std::move(equations)));
+        EXPECT_TRUE(solver.solve().has_value());
+    }
+    auto separateTime = std::chrono::steady_clock::now() - startTime;
+
+    startTime = std::chrono::steady_clock::now();
+    Solver batchSolver(equationSystem);
+    for (const auto& solution : batchSolver.solveBatch(rightSides))
+    {
+        EXPECT_TRUE(solution.has_value());
+    }
+    auto batchTime = std::chrono::steady_clock::now() - startTime;
+
+    std::cout << "Measured solving time for " << nRightSides << " right sides: separately "
+              << std::chrono::duration_cast<std::chrono::microseconds>(separateTime).count() << " us, batch "
+              << std::chrono::duration_cast<std::chrono::microseconds>(batchTime).count() << " us" << std::endl;
+}
+
+TEST(SolverPerformanceTest, EliminationPlanMeasureTime)
+{
+    const EquationSystem equationSystem = makeSystemWithDensity(30, 40, 1000, 0.2);
+    const std::filesystem::path planPath = std::filesystem::temp_directory_path() / "SolverPerformanceTest.plan";
+
+    // Right side of a random solution, so that it is solvable
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<long> distribution(-1000, 1000);
+    std::vector<NumT> solution;
+    for (size_t j = 0; j < equationSystem.getVariableCount(); ++j)
+    {
+        solution.emplace_back(distribution(generator));
+    }
+    std::vector<NumT> rightSide;
+    std::vector<diophantus::model::Equation<NumT>> equations;
+    for (const auto& equation : equationSystem.getEquations())
+    {
+        NumT& constant = rightSide.emplace_back(0);
+        for (const auto& term : equation.getLeftSide().getTerms())
+        {
+            constant.addMul(term.getCoefficient(), solution[term.getVariable()]);
+        }
+        equations.emplace_back(equation.getLeftSide(), constant);
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    Solver solver(EquationSystem(equationSystem.getVariables(), std::move(equations)));
+    EXPECT_TRUE(solver.solve().has_value());
+    auto solveTime = std::chrono::steady_clock::now() - startTime;
+
+    startTime = std::chrono::steady_clock::now();
+    ASSERT_TRUE(Solver(equationSystem).compilePlan().save(planPath));
+    auto compileTime = std::chrono::steady_clock::now() - startTime;
+
+    startTime = std::chrono::steady_clock::now();
+    std::optional<diophantus::EliminationPlan<NumT>> plan = diophantus::EliminationPlan<NumT>::load(planPath);
+    ASSERT_TRUE(plan.has_value());
+    EXPECT_TRUE(plan->solve(rightSide).has_value());
+    auto loadTime = std::chrono::steady_clock::now() - startTime;
+
+    std::filesystem::remove(planPath);
+
+    std::cout << "Measured time for the first right side: solving "
+              << std::chrono::duration_cast<std::chrono::microseconds>(solveTime).count() << " us, compiling and saving "
+              << std::chrono::duration_cast<std::chrono::microseconds>(compileTime).count() << " us, loading and solving "
+              << std::chrono::duration_cast<std::chrono::microseconds>(loadTime).count() << " us ("
+              << plan->getOperationCount() << " operations)" << std::endl;
+}
+
+TEST(SolverPerformanceTest, IncrementalSolvingMeasureTime)
+{
+    const EquationSystem equationSystem = makeSystemWithDensity(30, 40, 1000, 0.2);
+    const auto& equations = equationSystem.getEquations();
+
+    // Check satisfiability after each equation, by solving from the start every time
+    auto startTime = std::chrono::steady_clock::now();
+    size_t nSolvableFromScratch = 0;
+    for (size_t nEquations = 1; nEquations <= equations.size(); ++nEquations)
+    {
+        std::vector<diophantus::model::Equation<NumT>> prefix(equations.begin(), equations.begin() + nEquations);
+        Solver solver(EquationSystem(equationSystem.getVariables(), std::move(prefix)));
+        nSolvableFromScratch += solver.solve().has_value();
+    }
+    auto fromScratchTime = std::chrono::steady_clock::now() - startTime;
+
+    // ... and by adding the equations to the solved system
+    startTime = std::chrono::steady_clock::now();
+    size_t nSolvableIncrementally = 0;
+    Solver solver(EquationSystem(equationSystem.getVariables(), {}));
+    ASSERT_TRUE(solver.solve().has_value());
+    for (const auto& equation : equations)
+    {
+        solver.addEquation(equation);
+        nSolvableIncrementally += solver.resolve().has_value();
+    }
+    auto incrementalTime = std::chrono::steady_clock::now() - startTime;
+
+    EXPECT_EQ(nSolvableIncrementally, nSolvableFromScratch);
+    std::cout << "Measured time to check " << equations.size() << " growing systems: from scratch "
+              << std::chrono::duration_cast<std::chrono::microseconds>(fromScratchTime).count() << " us, incrementally "
+              << std::chrono::duration_cast<std::chrono::microseconds>(incrementalTime).count() << " us" << std::endl;
+}
+
+TEST(SolverPerformanceTest, ScopedSolvingMeasureTime)
+{
+    const EquationSystem equationSystem = makeSystemWithDensity(30, 40, 1000, 0.2);
+    const auto& equations = equationSystem.getEquations();
+    const size_t nBase = equations.size() / 2;
+
+    // Assert each of the other equations on top of the first half, check and retract it
+    std::vector<diophantus::model::Equation<NumT>> baseEquations(equations.begin(), equations.begin() + nBase);
+    Solver solver(EquationSystem(equationSystem.getVariables(), baseEquations));
+    ASSERT_TRUE(solver.solve().has_value());
+
+    // Only the time to save and restore the solver is measured
+    std::chrono::steady_clock::duration copyTime{};
+    size_t nSolvableByCopy = 0;
+    for (size_t eqIndex = nBase; eqIndex < equations.size(); ++eqIndex)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        Solver copiedSolver = solver;
+        copyTime += std::chrono::steady_clock::now() - startTime;
+
+        copiedSolver.addEquation(equations[eqIndex]);
+        nSolvableByCopy += copiedSolver.resolve().has_value();
+    }
+
+    std::chrono::steady_clock::duration scopeTime{};
+    size_t nSolvableInScope = 0;
+    for (size_t eqIndex = nBase; eqIndex < equations.size(); ++eqIndex)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        solver.push();
+        scopeTime += std::chrono::steady_clock::now() - startTime;
+
+        solver.addEquation(equations[eqIndex]);
+        nSolvableInScope += solver.resolve().has_value();
+
+        startTime = std::chrono::steady_clock::now();
+        solver.pop();
+        scopeTime += std::chrono::steady_clock::now() - startTime;
+    }
+
+    EXPECT_EQ(nSolvableInScope, nSolvableByCopy);
+    std::cout << "Measured backtracking time for " << equations.size() - nBase << " assumptions: copying the solver "
+              << std::chrono::duration_cast<std::chrono::microseconds>(copyTime).count() << " us, push and pop "
+              << std::chrono::duration_cast<std::chrono::microseconds>(scopeTime).count() << " us" << std::endl;
+}
+
+TEST(SolverPerformanceTest, ParallelSolvingMeasureTime)
+{
+    // Large enough that the substitutions and simplifications process hundreds of rows at once
+    const EquationSystem equationSystem = makeSystemWithDensity(300, 400, 100, 0.01);
+
+    long long serialTime = measureMicroseconds(equationSystem, {});
+    for (size_t nThreads : {2, 4, 8})
+    {
+        auto pool = std::make_shared<diophantus::model::ThreadPool>(nThreads);
+        long long parallelTime = measureMicroseconds(equationSystem, {.threadPool = pool});
+        std::cout << "Measured solving time for 300x400 at density 1% with " << nThreads << " threads: "
+                  << parallelTime << " us, serial " << serialTime << " us ("
+                  << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+    }
+}
@@ -1,13 +1,20 @@
+#include <diophantus/FixedWidthStatistics.hpp>
 #include <diophantus/Solver.hpp>
+#include <diophantus/SolvingEngine.hpp>
 #include <diophantus/Validator.hpp>
 
 #include <diophantus/model/Assignment.hpp>
+#include <diophantus/model/RowPolicy.hpp>
+#include <diophantus/model/VariableOrdering.hpp>
 #include <diophantus/model/Sum.hpp>
 #include <diophantus/model/Term.hpp>
+#include <diophantus/model/ThreadPool.hpp>
 #include <diophantus/model/Variable.hpp>
 #include <diophantus/model/Solution.hpp>
 #include <diophantus/model/util.hpp>
+#include <diophantus/model/numeric/FixedInt.hpp>
 #include <diophantus/model/numeric/GmpBigInt.hpp>
+#include <diophantus/model/numeric/HybridBigInt.hpp>
 #include <diophantus/model/Equation.hpp>
 #include <diophantus/model/EquationSystem.hpp>
 
@@ -15,8 +22,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
 
@@ -102,3 +112,630 @@ TEST(SolverTest, Conflict)
 
     EXPECT_FALSE(solution.has_value());
 }
+
+TEST(SolverTest, SimpleSystemHybridBigInt)
+{
+    using HybridNumT = diophantus::model::numeric::HybridBigInt;
+
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<HybridNumT>(variables, {7, 12, 31}, 17);
+    auto equation2 = diophantus::model::makeEquation<HybridNumT>(variables, {3, 5, 14}, 7);
+
+    auto equationSystem = diophantus::model::EquationSystem<HybridNumT>(variables, {equation1, equation2});
+
+    diophantus::Solver<HybridNumT> solver(equationSystem);
+    auto solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+
+    if (solution.has_value())
+    {
+        diophantus::Validator<HybridNumT> val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(SolverTest, SimpleSystemFixedInt)
+{
+    using FixedNumT = diophantus::model::numeric::FixedInt<128>;
+
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<FixedNumT>(variables, {7, 12, 31}, 17);
+    auto equation2 = diophantus::model::makeEquation<FixedNumT>(variables, {3, 5, 14}, 7);
+
+    auto equationSystem = diophantus::model::EquationSystem<FixedNumT>(variables, {equation1, equation2});
+
+    diophantus::Solver<FixedNumT> solver(equationSystem);
+    auto solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+
+    if (solution.has_value())
+    {
+        diophantus::Validator<FixedNumT> val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(SolverTest, FixedWidthArithmetic)
+{
+    auto& statistics = diophantus::FixedWidthStatistics::get();
+    statistics.reset();
+
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 31}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14}, 7);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    diophantus::Solver<NumT> solver(equationSystem, {.doUseFixedWidthArithmetic = true});
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+    EXPECT_EQ(statistics.nAttempts, 1);
+    EXPECT_EQ(statistics.nFallbacks, 0);
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(SolverTest, FixedWidthArithmeticFallback)
+{
+    auto& statistics = diophantus::FixedWidthStatistics::get();
+    statistics.reset();
+
+    size_t nVariables = 2;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // The constant does not fit into 64 bits, so solving has to be restarted with GMP
+    auto equation = Equation(Sum({Term(3, variables[0]), Term(5, variables[1])}),
+                             NumT("100000000000000000000000000"));
+
+    auto equationSystem = EquationSystem(variables, {equation});
+
+    diophantus::Solver<NumT> solver(equationSystem, {.doUseFixedWidthArithmetic = true});
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_TRUE(solution.has_value());
+    EXPECT_EQ(statistics.nAttempts, 1);
+    EXPECT_EQ(statistics.nFallbacks, 1);
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(SolverTest, FixedWidthArithmeticUnsolvable)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 21, 28}, 8);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14}, 7);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    diophantus::Solver<NumT> solver(equationSystem, {.doUseFixedWidthArithmetic = true});
+    std::optional<Solution> solution = solver.solve();
+
+    EXPECT_FALSE(solution.has_value());
+}
+
+TEST(SolverTest, GmpArena)
+{
+    size_t nVariables = 3;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 31}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14}, 7);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2});
+
+    // The solution has to stay valid after the solver and its arena are gone
+    std::optional<Solution> solution;
+    {
+        diophantus::Solver<NumT> solver(equationSystem, {.doUseGmpArena = true});
+        solution = solver.solve();
+    }
+
+    EXPECT_TRUE(solution.has_value());
+
+    if (solution.has_value())
+    {
+        Validator val(equationSystem);
+        EXPECT_TRUE(val.isValidSolution(solution.value()));
+    }
+}
+
+TEST(SolverTest, RowLayouts)
+{
+    size_t nVariables = 6;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 0, 31, 4, 0}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14, 0, 0, 9}, 7);
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {0, 2, 0, 0, 6, 11}, -3);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2, equation3});
+
+    using diophantus::model::RowLayout;
+    for (RowLayout layout : {RowLayout::Sparse, RowLayout::Dense, RowLayout::Adaptive})
+    {
+        // Let adaptive rows become dense right away
+        diophantus::model::RowPolicy rowPolicy{.layout = layout, .minDenseTermCount = 2};
+
+        for (bool doUseFixedWidthArithmetic : {false, true})
+        {
+            diophantus::Solver<NumT> solver(equationSystem, {
+                .doUseFixedWidthArithmetic = doUseFixedWidthArithmetic,
+                .rowPolicy = rowPolicy
+            });
+            std::optional<Solution> solution = solver.solve();
+
+            ASSERT_TRUE(solution.has_value());
+            Validator val(equationSystem);
+            EXPECT_TRUE(val.isValidSolution(solution.value()));
+        }
+    }
+}
+
+namespace
+{
+    template <diophantus::model::VariableId VarT>
+    void solveWithIdWidth()
+    {
+        auto variables = diophantus::model::make_variables<VarT>(3);
+
+        auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 31}, 17);
+        auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14}, 7);
+
+        auto equationSystem = diophantus::model::EquationSystem<NumT, VarT>(variables, {equation1, equation2});
+
+        for (bool doUseFixedWidthArithmetic : {false, true})
+        {
+            diophantus::Solver<NumT, VarT> solver(equationSystem, {.doUseFixedWidthArithmetic = doUseFixedWidthArithmetic});
+            std::optional<diophantus::model::Solution<NumT, VarT>> solution = solver.solve();
+
+            ASSERT_TRUE(solution.has_value());
+            EXPECT_TRUE((diophantus::Validator<NumT, VarT>::isValidSolution(equationSystem, solution.value())));
+        }
+    }
+}
+
+TEST(SolverTest, VariableIdWidths)
+{
+    solveWithIdWidth<std::uint16_t>();
+    solveWithIdWidth<std::uint32_t>();
+    solveWithIdWidth<std::uint64_t>();
+}
+
+TEST(SolverTest, VariableRenumbering)
+{
+    size_t nVariables = 6;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 0, 31, 4, 0}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14, 0, 0, 9}, 7);
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {0, 2, 0, 0, 6, 11}, -3);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2, equation3});
+
+    using diophantus::model::VariableOrdering;
+    for (VariableOrdering ordering : {VariableOrdering::Compact, VariableOrdering::ReverseCuthillMcKee})
+    {
+        for (bool doUseFixedWidthArithmetic : {false, true})
+        {
+            diophantus::Solver<NumT> solver(equationSystem, {
+                .doUseFixedWidthArithmetic = doUseFixedWidthArithmetic,
+                .variableRenumbering = ordering
+            });
+            std::optional<Solution> solution = solver.solve();
+
+            ASSERT_TRUE(solution.has_value());
+            Validator val(equationSystem);
+            EXPECT_TRUE(val.isValidSolution(solution.value()));
+        }
+    }
+}
+
+TEST(SolverTest, HermiteNormalFormEngine)
+{
+    size_t nVariables = 6;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    auto equation1 = diophantus::model::makeEquation<NumT>(variables, {7, 12, 0, 31, 4, 0}, 17);
+    auto equation2 = diophantus::model::makeEquation<NumT>(variables, {3, 5, 14, 0, 0, 9}, 7);
+    auto equation3 = diophantus::model::makeEquation<NumT>(variables, {0, 2, 0, 0, 6, 11}, -3);
+
+    auto equationSystem = EquationSystem(variables, {equation1, equation2, equation3});
+
+    diophantus::Solver<NumT> solver(equationSystem, {.engine = diophantus::SolvingEngine::HermiteNormalForm});
+    std::optional<Solution> solution = solver.solve();
+
+    ASSERT_TRUE(solution.has_value());
+    Validator val(equationSystem);
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+
+    // Only the elimination engine can add and retract equations
+    EXPECT_THROW(solver.addEquation(equation1), std::logic_error);
+    EXPECT_THROW(solver.resolve(), std::logic_error);
+    EXPECT_THROW(solver.push(), std::logic_error);
+
+    auto unsolvableEquation = diophantus::model::makeEquation<NumT>(variables, {2, 4, 0, 6, 0, 0}, 5);
+    diophantus::Solver<NumT> unsolvableSolver(EquationSystem(variables, {equation1, unsolvableEquation}),
+                                              {.engine = diophantus::SolvingEngine::HermiteNormalForm});
+    EXPECT_FALSE(unsolvableSolver.solve().has_value());
+}
+
+TEST(SolverTest, BatchSolving)
+{
+    size_t nVariables = 6;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // The second equation has a common divisor, the fourth one duplicates the first one up to
+    // sign and the last one is a combination of the first two
+    std::vector<std::vector<long>> coefficients = {
+        {7, 12, 0, 31, 4, 0},
+        {6, 10, 28, 0, 0, 18},
+        {0, 2, 0, 0, 6, 11},
+        {-7, -12, 0, -31, -4, 0},
+        {13, 22, 28, 31, 4, 18}
+    };
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<long> distribution(-40, 40);
+    std::vector<std::vector<long>> rightSides;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        std::vector<long> rightSide(coefficients.size());
+        for (long& value : rightSide)
+        {
+            value = distribution(generator);
+        }
+        // Make some of the right sides consistent with the dependent equations
+        if (i % 2 == 0)
+        {
+            rightSide[3] = -rightSide[0];
+            rightSide[4] = rightSide[0] + rightSide[1];
+        }
+        rightSides.push_back(rightSide);
+    }
+
+    auto makeSystem = [&](const std::vector<long>& rightSide) {
+        std::vector<Equation> equations;
+        for (size_t j = 0; j < coefficients.size(); ++j)
+        {
+            equations.push_back(diophantus::model::makeEquation<NumT>(variables, coefficients[j], rightSide[j]));
+        }
+        return EquationSystem(variables, equations);
+    };
+
+    std::vector<std::vector<NumT>> batch;
+    for (const auto& rightSide : rightSides)
+    {
+        batch.emplace_back(rightSide.begin(), rightSide.end());
+    }
+
+    using diophantus::model::VariableOrdering;
+    using OptionalOrdering = std::optional<VariableOrdering>;
+    for (OptionalOrdering ordering : {OptionalOrdering(), OptionalOrdering(VariableOrdering::Compact)})
+    {
+        Solver batchSolver(makeSystem(rightSides[0]), {.variableRenumbering = ordering});
+        std::vector<std::optional<Solution>> solutions = batchSolver.solveBatch(batch);
+        ASSERT_EQ(solutions.size(), rightSides.size());
+
+        size_t nSolvable = 0;
+        for (size_t i = 0; i < rightSides.size(); ++i)
+        {
+            EquationSystem equationSystem = makeSystem(rightSides[i]);
+            std::optional<Solution> expected = Solver(equationSystem).solve();
+
+            ASSERT_EQ(solutions[i].has_value(), expected.has_value()) << "right side " << i;
+            if (solutions[i].has_value())
+            {
+                Validator val(equationSystem);
+                EXPECT_TRUE(val.isValidSolution(solutions[i].value())) << "right side " << i;
+                ++nSolvable;
+            }
+        }
+        EXPECT_GT(nSolvable, 0);
+        EXPECT_LT(nSolvable, rightSides.size());
+        // The solver is left unchanged, so it can solve another batch and its own equation system
+        std::vector<std::optional<Solution>> secondSolutions = batchSolver.solveBatch(batch);
+        ASSERT_EQ(secondSolutions.size(), solutions.size());
+        for (size_t i = 0; i < solutions.size(); ++i)
+        {
+            ASSERT_EQ(secondSolutions[i].has_value(), solutions[i].has_value()) << "right side " << i;
+        }
+
+        EquationSystem ownSystem = makeSystem(rightSides[0]);
+        std::optional<Solution> ownSolution = batchSolver.solve();
+        ASSERT_EQ(ownSolution.has_value(), Solver(ownSystem).solve().has_value());
+        if (ownSolution.has_value())
+        {
+            Validator val(ownSystem);
+            EXPECT_TRUE(val.isValidSolution(ownSolution.value()));
+        }
+
+        // Solving consumes the equation system
+        EXPECT_THROW(batchSolver.solveBatch(batch), std::logic_error);
+    }
+
+    Solver solver(makeSystem(rightSides[0]));
+    EXPECT_THROW(solver.solveBatch({{NumT(1), NumT(2)}}), std::invalid_argument);
+}
+
+TEST(SolverTest, IncrementalSolving)
+{
+    size_t nVariables = 12;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<long> coefficientDistribution(-9, 9);
+    std::uniform_int_distribution<long> constantDistribution(-50, 50);
+    std::uniform_int_distribution<size_t> variableDistribution(0, nVariables - 1);
+    auto makeRandomEquation = [&]() {
+        std::vector<long> coefficients(nVariables, 0);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            coefficients[variableDistribution(generator)] = coefficientDistribution(generator);
+        }
+        return diophantus::model::makeEquation<NumT>(variables, coefficients, constantDistribution(generator));
+    };
+
+    using diophantus::model::VariableOrdering;
+    using OptionalOrdering = std::optional<VariableOrdering>;
+    for (OptionalOrdering ordering : {OptionalOrdering(), OptionalOrdering(VariableOrdering::Compact)})
+    {
+        // Start from an empty equation system and add one equation after the other
+        std::vector<Equation> equations;
+        Solver solver(EquationSystem(variables, {}), {.variableRenumbering = ordering});
+        ASSERT_TRUE(solver.solve().has_value());
+
+        bool isSolvable = true;
+        for (size_t i = 0; i < 12 && isSolvable; ++i)
+        {
+            equations.push_back(makeRandomEquation());
+            solver.addEquation(equations.back());
+            std::optional<Solution> solution = solver.resolve();
+
+            EquationSystem equationSystem(variables, equations);
+            std::optional<Solution> expected = Solver(equationSystem).solve();
+            ASSERT_EQ(solution.has_value(), expected.has_value()) << "equation " << i;
+
+            isSolvable = solution.has_value();
+            if (isSolvable)
+            {
+                Validator val(equationSystem);
+                EXPECT_TRUE(val.isValidSolution(solution.value())) << "equation " << i;
+            }
+        }
+    }
+
+    auto makeEquation = [&](std::vector<long> coefficients, long rightSide) {
+        coefficients.resize(nVariables, 0);
+        return diophantus::model::makeEquation<NumT>(variables, coefficients, rightSide);
+    };
+
+    // x0 + x1 = 2, then 2 x0 + 2 x1 = 4 and x0 + x1 = 3
+    Solver solver(EquationSystem(variables, {makeEquation({1, 1}, 2)}));
+    ASSERT_TRUE(solver.solve().has_value());
+    solver.addEquation(makeEquation({2, 2}, 4));
+    EXPECT_TRUE(solver.resolve().has_value());
+    solver.addEquation(makeEquation({1, 1}, 3));
+    EXPECT_FALSE(solver.resolve().has_value());
+
+    // Unsolvable systems stay unsolvable
+    solver.addEquation(makeEquation({0, 0, 1}, 3));
+    EXPECT_FALSE(solver.resolve().has_value());
+
+    EXPECT_THROW(solver.addEquation(Equation(Sum({Term(NumT(1), 20)}), NumT(1))), std::invalid_argument);
+
+    Solver unsolvedSolver(EquationSystem(variables, {}));
+    EXPECT_THROW(unsolvedSolver.addEquation(makeEquation({1}, 1)), std::logic_error);
+}
+
+TEST(SolverTest, ScopedSolving)
+{
+    size_t nVariables = 10;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    std::mt19937 generator(8);
+    std::uniform_int_distribution<long> coefficientDistribution(-6, 6);
+    std::uniform_int_distribution<long> constantDistribution(-30, 30);
+    std::uniform_int_distribution<size_t> variableDistribution(0, nVariables - 1);
+    auto makeRandomEquation = [&]() {
+        std::vector<long> coefficients(nVariables, 0);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            coefficients[variableDistribution(generator)] = coefficientDistribution(generator);
+        }
+        return diophantus::model::makeEquation<NumT>(variables, coefficients, constantDistribution(generator));
+    };
+
+    // Checks the solver against solving the asserted equations from scratch
+    auto expectSameResult = [&](Solver& solver, const std::vector<Equation>& equations) {
+        EquationSystem equationSystem(variables, equations);
+        std::optional<Solution> solution = solver.resolve();
+        ASSERT_EQ(solution.has_value(), Solver(equationSystem).solve().has_value());
+        if (solution.has_value())
+        {
+            Validator val(equationSystem);
+            EXPECT_TRUE(val.isValidSolution(solution.value()));
+        }
+    };
+
+    using diophantus::model::VariableOrdering;
+    using OptionalOrdering = std::optional<VariableOrdering>;
+    for (OptionalOrdering ordering : {OptionalOrdering(), OptionalOrdering(VariableOrdering::Compact)})
+    {
+        std::vector<Equation> equations;
+        do
+        {
+            equations = {makeRandomEquation(), makeRandomEquation(), makeRandomEquation()};
+        }
+        while (!Solver(EquationSystem(variables, equations)).solve().has_value());
+
+        Solver solver(EquationSystem(variables, equations), {.variableRenumbering = ordering});
+        ASSERT_TRUE(solver.solve().has_value());
+
+        for (size_t round = 0; round < 20; ++round)
+        {
+            solver.push();
+            const size_t nEquations = equations.size();
+            for (size_t i = 0; i < 2; ++i)
+            {
+                equations.push_back(makeRandomEquation());
+                solver.addEquation(equations.back());
+            }
+            expectSameResult(solver, equations);
+
+            // A nested scope
+            solver.push();
+            equations.push_back(makeRandomEquation());
+            solver.addEquation(equations.back());
+            expectSameResult(solver, equations);
+            solver.pop();
+            equations.pop_back();
+            expectSameResult(solver, equations);
+
+            // Keep the equations of every fourth round
+            if (round % 4 != 0)
+            {
+                solver.pop();
+                equations.erase(equations.begin() + nEquations, equations.end());
+                expectSameResult(solver, equations);
+            }
+        }
+    }
+
+    // Conflicts are retracted along with their scope
+    auto makeEquation = [&](std::vector<long> coefficients, long rightSide) {
+        coefficients.resize(nVariables, 0);
+        return diophantus::model::makeEquation<NumT>(variables, coefficients, rightSide);
+    };
+    Solver solver(EquationSystem(variables, {makeEquation({1, 1}, 2)}));
+    ASSERT_TRUE(solver.solve().has_value());
+    solver.push();
+    solver.addEquation(makeEquation({1, 1}, 3));
+    EXPECT_FALSE(solver.resolve().has_value());
+    solver.pop();
+    EXPECT_TRUE(solver.resolve().has_value());
+    EXPECT_THROW(solver.pop(), std::logic_error);
+
+    // Equations that were added before the scope stay, even if they were not resolved yet
+    solver.addEquation(makeEquation({0, 0, 1}, 1));
+    solver.push();
+    solver.addEquation(makeEquation({0, 0, 1}, 2));
+    EXPECT_FALSE(solver.resolve().has_value());
+    solver.pop();
+    std::optional<Solution> solution = solver.resolve();
+    ASSERT_TRUE(solution.has_value());
+    Validator val(EquationSystem(variables, {makeEquation({1, 1}, 2), makeEquation({0, 0, 1}, 1)}));
+    EXPECT_TRUE(val.isValidSolution(solution.value()));
+
+    Solver unsolvedSolver(EquationSystem(variables, {}));
+    EXPECT_THROW(unsolvedSolver.push(), std::logic_error);
+}
+
+TEST(SolverTest, ParallelSolving)
+{
+    size_t nEquations = 60;
+    size_t nVariables = 80;
+    auto variables = diophantus::model::make_variables(nVariables);
+
+    // A solvable system, with right sides computed from a random solution
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<long> coefficientDistribution(-1000, 1000);
+    std::bernoulli_distribution isNonzero(0.3);
+    std::vector<long> values(nVariables);
+    for (auto& value : values)
+    {
+        value = coefficientDistribution(generator);
+    }
+    std::vector<Equation> equations;
+    for (size_t i = 0; i < nEquations; ++i)
+    {
+        std::vector<long> coefficients(nVariables, 0);
+        long rightSide = 0;
+        for (size_t j = 0; j < nVariables; ++j)
+        {
+            if (isNonzero(generator))
+            {
+                coefficients[j] = coefficientDistribution(generator);
+                rightSide += coefficients[j] * values[j];
+            }
+        }
+        equations.push_back(diophantus::model::makeEquation<NumT>(variables, coefficients, rightSide));
+    }
+    const EquationSystem equationSystem(variables, equations);
+
+    // Every phase runs on the pool, no matter how few rows it processes
+    auto pool = std::make_shared<diophantus::model::ThreadPool>(4);
+
+    using diophantus::model::VariableOrdering;
+    using OptionalOrdering = std::optional<VariableOrdering>;
+    for (OptionalOrdering ordering : {OptionalOrdering(), OptionalOrdering(VariableOrdering::Compact)})
+    {
+        // Fixed-width arithmetic overflows on the pool's threads and falls back
+        for (bool doUseFixedWidthArithmetic : {false, true})
+        {
+            Solver::Parameters serialParameters {
+                .doUseFixedWidthArithmetic = doUseFixedWidthArithmetic,
+                .variableRenumbering = ordering
+            };
+            Solver::Parameters parallelParameters = serialParameters;
+            parallelParameters.threadPool = pool;
+            parallelParameters.minParallelRows = 1;
+
+            std::optional<Solution> serialSolution = Solver(equationSystem, serialParameters).solve();
+            std::optional<Solution> parallelSolution = Solver(equationSystem, parallelParameters).solve();
+            ASSERT_TRUE(serialSolution.has_value());
+            ASSERT_TRUE(parallelSolution.has_value());
+
+            // The same pivots lead to the same solution
+            const auto& serialAssignments = serialSolution.value().assignments;
+            const auto& parallelAssignments = parallelSolution.value().assignments;
+            ASSERT_EQ(parallelAssignments.size(), serialAssignments.size());
+            for (size_t i = 0; i < serialAssignments.size(); ++i)
+            {
+                EXPECT_EQ(parallelAssignments[i].variable, serialAssignments[i].variable);
+                EXPECT_EQ(parallelAssignments[i].value, serialAssignments[i].value);
+            }
+
+            Validator val(equationSystem);
+            EXPECT_TRUE(val.isValidSolution(parallelSolution.value()));
+        }
+
+        // The constant trace is recorded in the same order
+        Solver::Parameters parameters{.variableRenumbering = ordering, .threadPool = pool, .minParallelRows = 1};
+        auto parallelPlan = Solver(equationSystem, parameters).compilePlan();
+        auto serialPlan = Solver(equationSystem, {.variableRenumbering = ordering}).compilePlan();
+        ASSERT_EQ(parallelPlan.getOperationCount(), serialPlan.getOperationCount());
+
+        std::vector<NumT> rightSides;
+        for (const auto& equation : equations)
+        {
+            rightSides.push_back(equation.getRightSide());
+        }
+        std::optional<Solution> serialSolution = serialPlan.solve(rightSides);
+        std::optional<Solution> parallelSolution = parallelPlan.solve(rightSides);
+        ASSERT_TRUE(serialSolution.has_value());
+        ASSERT_TRUE(parallelSolution.has_value());
+        for (size_t i = 0; i < serialSolution.value().assignments.size(); ++i)
+        {
+            EXPECT_EQ(parallelSolution.value().assignments[i].value, serialSolution.value().assignments[i].value);
+        }
+    }
+}
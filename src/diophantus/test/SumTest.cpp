@@ -0,0 +1,250 @@
+#include <diophantus/model/RowPolicy.hpp>
+#include <diophantus/model/Sum.hpp>
+#include <diophantus/model/Term.hpp>
+#include <diophantus/model/Variable.hpp>
+
+#include <diophantus/model/numeric/GmpBigInt.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <ranges>
+#include <vector>
+
+using NumT = diophantus::model::numeric::GmpBigInt;
+
+using Variable = diophantus::model::Variable;
+using Term = diophantus::model::Term<NumT>;
+using Sum = diophantus::model::Sum<NumT>;
+using RowLayout = diophantus::model::RowLayout;
+using RowPolicy = diophantus::model::RowPolicy;
+
+static_assert(std::ranges::random_access_range<Sum::TermRange>);
+static_assert(std::ranges::sized_range<Sum::TermRange>);
+
+TEST(SumTest, SeparateArrays)
+{
+    Sum sum({Term(3, 1), Term(-5, 2), Term(7, 4)});
+
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2, 4}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(3), NumT(-5), NumT(7)}));
+
+    const auto terms = sum.getTerms();
+    ASSERT_EQ(terms.size(), 3);
+    EXPECT_EQ(terms[1].getCoefficient(), -5);
+    EXPECT_EQ(terms[1].getVariable(), 2);
+}
+
+TEST(SumTest, TermsReflectChanges)
+{
+    Sum sum({Term(3, 1), Term(-5, 2)});
+    const auto terms = sum.getTerms();
+    const auto lowest = sum.getLowestCoefficientTerm();
+
+    sum.negateCoefficients();
+    EXPECT_EQ(lowest.getCoefficient(), -3);
+
+    sum.addTerm(Term(8, 3));
+    EXPECT_EQ(terms.size(), 3);
+    EXPECT_EQ(terms.back().getCoefficient(), 8);
+}
+
+TEST(SumTest, CanonicalOrder)
+{
+    Sum sum({Term(4, 5), Term(0, 3), Term(2, 1), Term(-6, 4), Term(1, 5), Term(3, 2), Term(-3, 2)});
+
+    // Terms are sorted, duplicates are combined and zero terms are left out
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 4, 5}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(2), NumT(-6), NumT(5)}));
+    EXPECT_EQ(sum.simplify(), NumT(1));
+}
+
+TEST(SumTest, AddTerm)
+{
+    Sum sum({Term(3, 2), Term(5, 6)});
+
+    sum.addTerm(Term(1, 4));
+    sum.addTerm(Term(7, 0));
+    sum.addTerm(Term(9, 8));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({0, 2, 4, 6, 8}));
+
+    sum.addTerm(Term(2, 6));
+    sum.addTerm(Term(-1, 4));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({0, 2, 6, 8}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(7), NumT(3), NumT(7), NumT(9)}));
+}
+
+TEST(SumTest, CoefficientsModuloRemovesZeroTerms)
+{
+    Sum sum({Term(6, 1), Term(4, 2), Term(-3, 3)});
+
+    sum.coefficientsModulo(NumT(3));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({2}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(1)}));
+}
+
+TEST(SumTest, WithoutVariable)
+{
+    Sum sum({Term(3, 1), Term(-5, 2), Term(7, 4)});
+
+    Sum rest = sum.withoutVariable(2);
+    EXPECT_EQ(rest.getVariables(), Sum::Variables({1, 4}));
+    EXPECT_EQ(rest.getCoefficients(), Sum::Coefficients({NumT(3), NumT(7)}));
+    EXPECT_EQ(sum.getVariables().size(), 3);
+}
+
+TEST(SumTest, AddMultipleOf)
+{
+    Sum sum({Term(3, 1), Term(-5, 2), Term(7, 4)});
+    Sum other({Term(1, 2), Term(2, 3), Term(1, 5)});
+
+    EXPECT_EQ(sum.removeTermOfVariable(4), NumT(7));
+    EXPECT_EQ(sum.removeTermOfVariable(6), std::nullopt);
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2}));
+
+    sum.addMultipleOf(other, NumT(5));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 3, 5}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(3), NumT(10), NumT(5)}));
+}
+
+TEST(SumTest, SubstituteVariable)
+{
+    Sum sum({Term(3, 1), Term(2, 2), Term(7, 4)});
+    Sum other({Term(-3, 1), Term(1, 3)});
+
+    EXPECT_EQ(sum.substituteVariable(5, other), std::nullopt);
+    EXPECT_EQ(sum.substituteVariable(4, Sum({Term(1, 3)})), NumT(7));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2, 3}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(3), NumT(2), NumT(7)}));
+
+    EXPECT_EQ(sum.substituteVariable(2, other), NumT(2));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 3}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(-3), NumT(9)}));
+}
+
+TEST(SumTest, MoveIntoResource)
+{
+    std::pmr::monotonic_buffer_resource resource;
+
+    Sum sum(Sum({Term(3, 1), Term(2, 2)}), &resource);
+    EXPECT_EQ(sum.getCoefficients().get_allocator().resource(), &resource);
+    EXPECT_EQ(sum.getVariables().get_allocator().resource(), &resource);
+
+    // Merging keeps the terms in the storage of the sum
+    sum.addMultipleOf(Sum({Term(1, 2), Term(4, 3)}), NumT(-2));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 3}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(3), NumT(-8)}));
+    EXPECT_EQ(sum.getCoefficients().get_allocator().resource(), &resource);
+    EXPECT_EQ(sum.getVariables().get_allocator().resource(), &resource);
+
+    // Copies allocate from the default heap
+    Sum copy(sum);
+    EXPECT_EQ(copy.getCoefficients().get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy.getVariables(), sum.getVariables());
+}
+
+TEST(SumTest, DenseLayout)
+{
+    Sum sum({Term(3, 1), Term(-5, 4), Term(7, 6)});
+    sum.makeDense();
+    EXPECT_TRUE(sum.isDense());
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(sum.getCoefficients(),
+              Sum::Coefficients({NumT(3), NumT(0), NumT(0), NumT(-5), NumT(0), NumT(7)}));
+    EXPECT_EQ(sum.getTermCount(), 3);
+    EXPECT_DOUBLE_EQ(sum.getFillRatio(), 0.5);
+    EXPECT_FALSE(sum.containsVariable(2));
+    EXPECT_TRUE(sum.containsVariable(4));
+    EXPECT_EQ(sum.getLowestCoefficientTerm().getVariable(), 1);
+
+    // The row grows to cover the variables of the other sum
+    sum.addMultipleOf(Sum({Term(1, 0), Term(5, 2), Term(1, 8)}), NumT(2));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({0, 1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(2), NumT(3), NumT(10), NumT(0), NumT(-5),
+                                                        NumT(0), NumT(7), NumT(0), NumT(2)}));
+
+    // Removed terms are zeroed, not erased
+    EXPECT_EQ(sum.removeTermOfVariable(4), NumT(-5));
+    EXPECT_EQ(sum.removeTermOfVariable(5), std::nullopt);
+    EXPECT_EQ(sum.getVariables().size(), 9);
+    EXPECT_FALSE(sum.containsVariable(4));
+
+    EXPECT_EQ(sum.substituteVariable(0, Sum({Term(1, 3)})), NumT(2));
+    EXPECT_EQ(sum.getCoefficients()[3], NumT(2));
+
+    // Simplification trims the zero terms at the ends
+    EXPECT_EQ(sum.simplify(), NumT(1));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2, 3, 4, 5, 6, 7, 8}));
+
+    Sum sparse({Term(-3, 1), Term(-10, 2), Term(-2, 3), Term(-7, 6), Term(-2, 8)});
+    EXPECT_EQ(sum.hashUpToSign(), sparse.hashUpToSign());
+    EXPECT_EQ(sum.compareUpToSign(sparse), -1);
+    EXPECT_EQ(sparse.compareUpToSign(sum), -1);
+    EXPECT_EQ(sum.compareUpToSign(Sum({Term(3, 1), Term(10, 2)})), 0);
+
+    sum.makeSparse();
+    EXPECT_FALSE(sum.isDense());
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2, 3, 6, 8}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(3), NumT(10), NumT(2), NumT(7), NumT(2)}));
+}
+
+TEST(SumTest, DenseCoefficientsModulo)
+{
+    Sum sum({Term(3, 1), Term(10, 2), Term(4, 3)});
+    sum.makeDense();
+
+    sum.coefficientsModulo(NumT(5));
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 2, 3}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(-2), NumT(0), NumT(-1)}));
+
+    Sum rest = sum.withoutVariable(1);
+    EXPECT_FALSE(rest.isDense());
+    EXPECT_EQ(rest.getVariables(), Sum::Variables({3}));
+}
+
+TEST(SumTest, AdaptiveRowPolicy)
+{
+    const RowPolicy policy{.layout = RowLayout::Adaptive, .minDenseTermCount = 4};
+
+    // Too few terms to become dense
+    Sum shortSum({Term(1, 1), Term(2, 2), Term(3, 3)});
+    shortSum.applyRowPolicy(policy);
+    EXPECT_FALSE(shortSum.isDense());
+
+    Sum sum({Term(1, 1), Term(2, 2), Term(3, 3), Term(4, 4), Term(5, 10)});
+    sum.applyRowPolicy(policy);
+    EXPECT_TRUE(sum.isDense());
+
+    // Stays dense until the fill ratio drops below the lower threshold
+    sum.removeTermOfVariable(2);
+    sum.applyRowPolicy(policy);
+    EXPECT_TRUE(sum.isDense());
+
+    sum.removeTermOfVariable(3);
+    sum.removeTermOfVariable(4);
+    sum.applyRowPolicy(policy);
+    EXPECT_FALSE(sum.isDense());
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({1, 10}));
+
+    sum.applyRowPolicy({.layout = RowLayout::Dense});
+    EXPECT_TRUE(sum.isDense());
+    sum.applyRowPolicy({.layout = RowLayout::Sparse});
+    EXPECT_FALSE(sum.isDense());
+}
+
+TEST(SumTest, RenameVariables)
+{
+    const std::vector<Variable> newVariables = {9, 0, 9, 9, 2, 9, 1};
+
+    Sum sum({Term(3, 1), Term(5, 4), Term(7, 6)});
+    sum.renameVariables(newVariables);
+    EXPECT_EQ(sum.getVariables(), Sum::Variables({0, 1, 2}));
+    EXPECT_EQ(sum.getCoefficients(), Sum::Coefficients({NumT(3), NumT(7), NumT(5)}));
+
+    Sum dense({Term(3, 1), Term(5, 4), Term(7, 6)});
+    dense.makeDense();
+    dense.renameVariables(newVariables);
+    EXPECT_FALSE(dense.isDense());
+    EXPECT_EQ(dense.getVariables(), Sum::Variables({0, 1, 2}));
+    EXPECT_EQ(dense.getCoefficients(), Sum::Coefficients({NumT(3), NumT(7), NumT(5)}));
+}
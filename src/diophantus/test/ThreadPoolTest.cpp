@@ -0,0 +1,74 @@
+#include <diophantus/model/ThreadPool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using ThreadPool = diophantus::model::ThreadPool;
+
+
+TEST(ThreadPoolTest, CoversAllItems)
+{
+    for (size_t nThreads : {1, 2, 4})
+    {
+        ThreadPool pool(nThreads);
+        EXPECT_EQ(pool.getThreadCount(), nThreads);
+
+        // The same pool runs many loops of different shapes
+        for (size_t nItems : {0, 1, 7, 100, 1000})
+        {
+            for (size_t chunkSize : {0, 1, 3, 64, 5000})
+            {
+                std::vector<std::atomic<int>> visits(nItems);
+                pool.parallelFor(nItems, chunkSize, [&](size_t begin, size_t end) {
+                    EXPECT_LT(begin, end);
+                    EXPECT_LE(end - begin, std::max<size_t>(chunkSize, 1));
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        ++visits[i];
+                    }
+                });
+
+                for (size_t i = 0; i < nItems; ++i)
+                {
+                    EXPECT_EQ(visits[i], 1) << "item " << i << " of " << nItems << " in chunks of " << chunkSize;
+                }
+            }
+        }
+    }
+}
+
+TEST(ThreadPoolTest, DefaultThreadCount)
+{
+    ThreadPool pool;
+    EXPECT_GE(pool.getThreadCount(), 1);
+}
+
+TEST(ThreadPoolTest, RethrowsExceptions)
+{
+    ThreadPool pool(4);
+    std::atomic<size_t> nChunks = 0;
+    EXPECT_THROW(pool.parallelFor(1000, 1, [&](size_t begin, size_t) {
+        ++nChunks;
+        if (begin == 10)
+        {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+
+    // The chunks after the failure are skipped, at least by the thread that threw
+    EXPECT_LT(nChunks, 1000);
+
+    // The pool is still usable
+    std::atomic<size_t> sum = 0;
+    pool.parallelFor(100, 8, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            sum += i;
+        }
+    });
+    EXPECT_EQ(sum, 4950);
+}
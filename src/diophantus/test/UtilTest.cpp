@@ -8,6 +8,8 @@
 #include <gtest/gtest.h>
 
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 TEST(UtilTest, MakeVariables)
@@ -21,3 +23,16 @@ TEST(UtilTest, MakeVariables)
         EXPECT_EQ(variables[i], i);
     }
 }
+
+TEST(UtilTest, MakeVariablesOfIdWidth)
+{
+    const auto variables = diophantus::model::make_variables<std::uint16_t>(3);
+    static_assert(std::is_same_v<decltype(variables), const std::vector<std::uint16_t>>);
+    EXPECT_EQ(variables, std::vector<std::uint16_t>({0, 1, 2}));
+
+    // The width of the ids carries over to the equation
+    using NumT = diophantus::model::numeric::GmpBigInt;
+    using Sum = diophantus::model::Sum<NumT, std::uint16_t>;
+    auto equation = diophantus::model::makeEquation<NumT>(variables, {4, 0, 2}, 6);
+    EXPECT_EQ(equation.getLeftSide().getVariables(), Sum::Variables({0, 2}));
+}
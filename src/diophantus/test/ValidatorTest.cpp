@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 
@@ -30,6 +31,9 @@ using Term = diophantus::model::Term<NumT>;
 
 using Validator = diophantus::Validator<NumT>;
 
+// Solutions are built and handed on by moving their assignments
+static_assert(std::is_move_assignable_v<Assignment>);
+
 
 class ValidatorTest:
     public ::testing::Test
@@ -75,3 +79,34 @@ TEST_F(ValidatorTest, InvalidSolution)
 
     EXPECT_FALSE(validator->isValidSolution(invalidSolution));
 }
+
+TEST_F(ValidatorTest, MissingAssignment)
+{
+    Solution incompleteSolution {
+        .assignments = {
+            Assignment {.variable = variables[0], .value = NumT(12)},
+            Assignment {.variable = variables[2], .value = NumT(-1)},
+        }
+    };
+
+    EXPECT_FALSE(validator->isValidSolution(incompleteSolution));
+}
+
+TEST(ValidatorStaticTest, ValidatesWithoutCopy)
+{
+    auto variables = diophantus::model::make_variables(2);
+    auto equationSystem = EquationSystem(variables, {
+        diophantus::model::makeEquation<NumT>(variables, {2, -3}, 1)
+    });
+
+    Solution solution {
+        .assignments = {
+            Assignment {.variable = variables[1], .value = NumT(1)},
+            Assignment {.variable = variables[0], .value = NumT(2)},
+        }
+    };
+    EXPECT_TRUE(Validator::isValidSolution(equationSystem, solution));
+
+    solution.assignments[0] = Assignment {.variable = variables[1], .value = NumT(3)};
+    EXPECT_FALSE(Validator::isValidSolution(equationSystem, solution));
+}